@@ -1,8 +1,11 @@
 #include "neopch.h"
 
 #include "Application.h"
+#include "Neon/Core/FrameAllocator.h"
+#include "Neon/Core/Profiler.h"
 #include "Neon/Renderer/Framebuffer.h"
 #include "Neon/Renderer/Renderer.h"
+#include "Neon/Renderer/RendererContext.h"
 #include "Neon/Renderer/SceneRenderer.h"
 #include "Neon/Physics/Physics.h"
 #include "Neon/Core/Input.h"
@@ -17,20 +20,45 @@ namespace Neon
 {
 	Application* Application::s_Instance = nullptr;
 
+	void ApplicationProps::ParseCommandLine(const ApplicationCommandLineArgs& args)
+	{
+		for (int i = 1; i < args.Count; i++)
+		{
+			if (strcmp(args[i], "--headless") == 0)
+			{
+				Headless = true;
+			}
+			else if (strcmp(args[i], "--frames") == 0 && i + 1 < args.Count)
+			{
+				FrameCount = static_cast<uint32>(std::strtoul(args[++i], nullptr, 10));
+			}
+		}
+	}
+
 	Application::Application(const ApplicationProps& applicationProps)
+		: m_Headless(applicationProps.Headless)
+		, m_MaxFrameCount(applicationProps.FrameCount)
+		, m_FixedTimestep(applicationProps.FixedTimestep)
 	{
 		NEO_ASSERT(s_Instance == nullptr, "Application already exists");
 		s_Instance = this;
 
-		m_Window = std::unique_ptr<Window>(
-			Window::Create(WindowProps{applicationProps.Name, applicationProps.WindowWidth, applicationProps.WindowHeight}));
+		WindowProps windowProps{applicationProps.Name, applicationProps.WindowWidth, applicationProps.WindowHeight};
+		windowProps.Headless = m_Headless;
+		m_Window = std::unique_ptr<Window>(Window::Create(windowProps));
 		m_Window->Init();
 		m_Window->SetEventCallback([this](Event& e) { OnEvent(e); });
 		m_Window->SetVSync(false);
 		m_Window->Maximize();
 
-		m_GuiContext = GuiContext::Create();
-		m_GuiContext->Init();
+		if (!m_Headless)
+		{
+			m_GuiContext = GuiContext::Create();
+			m_GuiContext->Init();
+		}
+
+		// Frame arenas are rewound once the GPU is done with their frame, so there has to be one per frame in flight
+		FrameAllocator::Initialize(RendererContext::Get()->GetTargetMaxFramesInFlight());
 
 		Renderer::Init();
 
@@ -40,7 +68,10 @@ namespace Neon
 
 	Application::~Application()
 	{
-		m_GuiContext->Shutdown();
+		if (m_GuiContext)
+		{
+			m_GuiContext->Shutdown();
+		}
 
 		Physics::DestroyScene();
 		Physics::Shutdown();
@@ -122,30 +153,111 @@ namespace Neon
 
 	void Application::Run()
 	{
+		auto runStartTime = std::chrono::steady_clock::now();
+
 		while (m_Running)
 		{
+			Profiler::MarkFrame();
+			NEO_PROFILE_SCOPE_CATEGORY("Frame", "Core");
+			FrameAllocator::BeginFrame();
+
 			auto time = std::chrono::high_resolution_clock::now();
 			auto timeStep = time - m_LastFrameTime;
 			m_LastFrameTime = time;
 
-			float deltaSeconds = std::chrono::duration<float, std::chrono::seconds::period>(timeStep).count();
+			float deltaSeconds = m_FixedTimestep > 0.f
+									 ? m_FixedTimestep
+									 : std::chrono::duration<float, std::chrono::seconds::period>(timeStep).count();
+			m_DeltaSeconds = deltaSeconds;
 
 			m_Window->ProcessEvents();
 
 			Input::CalculateMouseDelta();
 
-			Physics::TickPhysics(deltaSeconds);
+			// Buffers are moved while no frame is being recorded
+			if (m_DefragmentMemoryRequested)
+			{
+				RendererContext::Get()->DefragmentMemory();
+				m_DefragmentMemoryRequested = false;
+			}
+
+			m_FrameTaskGraph.Reset();
+			BuildFrameTasks(deltaSeconds);
+			m_FrameTaskGraph.Execute();
 
-			if (!m_Minimized)
+			m_FrameCount++;
+			if (m_MaxFrameCount > 0 && m_FrameCount >= m_MaxFrameCount)
 			{
+				m_Running = false;
+			}
+		}
+
+		m_Window->GetRenderContext()->WaitIdle();
+
+		double runMilliseconds =
+			std::chrono::duration<double, std::chrono::milliseconds::period>(std::chrono::steady_clock::now() - runStartTime).count();
+		NEO_CORE_INFO("Ran {0} frames in {1:.2f}ms, average frame time {2:.3f}ms", m_FrameCount, runMilliseconds,
+					  m_FrameCount > 0 ? runMilliseconds / m_FrameCount : 0.0);
+	}
+
+	void Application::BuildFrameTasks(float deltaSeconds)
+	{
+		// Physics simulates on the job threads from the start of the frame until the sync point. Layers update their
+		// scenes next to it with poses from the previous step, only window, gui and command buffer work stays on the
+		// main thread.
+		m_FrameTasks.PhysicsSimulate = m_FrameTaskGraph.AddTask(
+			"PhysicsSimulate", [deltaSeconds]() { Physics::BeginSimulation(deltaSeconds); });
+
+		if (m_Minimized)
+		{
+			m_FrameTasks.PhysicsSync =
+				m_FrameTaskGraph.AddTask("PhysicsSync", []() { Physics::EndSimulation(); }, {m_FrameTasks.PhysicsSimulate});
+			return;
+		}
+
+		m_FrameTasks.BeginFrame = m_FrameTaskGraph.AddTask(
+			"BeginFrame",
+			[this]() {
 				m_Window->GetRenderContext()->BeginFrame();
 
 				Renderer::SelectCommandBuffer(RendererContext::Get()->GetPrimaryRenderCommandBuffer());
+			},
+			{}, TaskAffinity::MainThread);
+
+		// Updates can push uniform data and compute work, which needs the frame slot claimed by BeginFrame
+		m_FrameTasks.LayerUpdate = m_FrameTaskGraph.AddTask(
+			"LayerUpdate",
+			[this, deltaSeconds]() {
+				for (Layer* layer : m_LayerStack)
+				{
+					layer->Update(deltaSeconds);
+				}
+			},
+			{m_FrameTasks.BeginFrame});
 
+		// Command buffer selection is per thread, recording starts from the main thread
+		m_FrameTasks.LayerTick = m_FrameTaskGraph.AddTask(
+			"LayerTick",
+			[this, deltaSeconds]() {
 				for (Layer* layer : m_LayerStack)
 				{
 					layer->Tick(deltaSeconds);
 				}
+			},
+			{m_FrameTasks.LayerUpdate}, TaskAffinity::MainThread);
+
+		// Results are fetched once nothing reads the bodies anymore, recording only uses the submitted draw list
+		m_FrameTasks.PhysicsSync = m_FrameTaskGraph.AddTask(
+			"PhysicsSync", []() { Physics::EndSimulation(); }, {m_FrameTasks.PhysicsSimulate, m_FrameTasks.LayerUpdate});
+
+		m_FrameTasks.RenderGui = m_FrameTaskGraph.AddTask(
+			"RenderGui",
+			[this, deltaSeconds]() {
+				// Headless runs have no gui, the task is still added so layers can hook around it
+				if (!m_GuiContext)
+				{
+					return;
+				}
 
 				m_GuiContext->Begin();
 
@@ -155,6 +267,68 @@ namespace Neon
 				ImGui::Text("Renderer: %s", caps.Renderer.c_str());
 				ImGui::Text("Version: %s", caps.Version.c_str());
 				ImGui::Text("Frame Time: %.2fms", deltaSeconds * 1000.0);
+				FrameAllocatorStats allocatorStats = FrameAllocator::GetLastFrameStats();
+#if NEO_TRACK_HEAP_ALLOCATIONS
+				ImGui::Text("Heap Allocations: %llu", allocatorStats.HeapAllocations);
+#endif
+				ImGui::Text("Frame Arena: %.1fKB", allocatorStats.ArenaBytes / 1024.0);
+				const CommandBufferStats& commandStats = RendererContext::Get()->GetPrimaryRenderCommandBuffer()->GetStats();
+				ImGui::Text("Draw Calls: %u (%u instances)", commandStats.DrawCalls, commandStats.Instances);
+				ImGui::Text("Binds: %u (skipped %u)",
+							commandStats.PipelineBinds + commandStats.DescriptorSetBinds + commandStats.VertexBufferBinds +
+								commandStats.IndexBufferBinds,
+							commandStats.SkippedBinds);
+				if (commandStats.DroppedDraws > 0)
+				{
+					ImGui::Text("Dropped Draws: %u (per frame draw data budget exceeded)", commandStats.DroppedDraws);
+				}
+				const CullingStats& cullingStats = SceneRenderer::GetCullingStats();
+				ImGui::Text("Culling: %u of %u instances visible", cullingStats.VisibleInstances, cullingStats.TestedInstances);
+				ImGui::Text("GPU culling: %u of %u instances visible, %u frames ago", cullingStats.GpuVisibleInstances,
+							cullingStats.GpuTestedInstances, cullingStats.GpuFramesLate);
+				ImGui::Text("Submeshes: %u of %u visible", cullingStats.VisibleSubmeshes, cullingStats.TestedSubmeshes);
+				const char* cullingModes[] = {"None", "CPU", "GPU"};
+				int cullingMode = static_cast<int>(SceneRenderer::GetCullingMode());
+				if (ImGui::Combo("Culling", &cullingMode, cullingModes, IM_ARRAYSIZE(cullingModes)))
+				{
+					SceneRenderer::SetCullingMode(static_cast<CullingMode>(cullingMode));
+				}
+				bool parallelRecording = SceneRenderer::IsParallelRecordingEnabled();
+				if (ImGui::Checkbox("Parallel recording", &parallelRecording))
+				{
+					SceneRenderer::SetParallelRecordingEnabled(parallelRecording);
+				}
+				std::vector<GpuTiming> gpuTimings = RendererContext::Get()->GetGpuTimings();
+				if (!gpuTimings.empty())
+				{
+					ImGui::Separator();
+					for (const GpuTiming& timing : gpuTimings)
+					{
+						ImGui::Text("GPU %s: %.3fms (x%u)", timing.Name, timing.Milliseconds, timing.Count);
+					}
+				}
+				if (ImGui::CollapsingHeader("GPU Memory"))
+				{
+					if (ImGui::Button("Defragment"))
+					{
+						m_DefragmentMemoryRequested = true;
+					}
+					GpuMemoryStats memoryStats = RendererContext::Get()->GetMemoryStats();
+					for (uint32 i = 0; i < memoryStats.Heaps.size(); i++)
+					{
+						const GpuMemoryHeap& heap = memoryStats.Heaps[i];
+						ImGui::Text("Heap %u (%s): %.1fMB of %.1fMB budget", i, heap.DeviceLocal ? "device" : "host",
+									heap.Usage / (1024.0 * 1024.0), heap.Budget / (1024.0 * 1024.0));
+						ImGui::Text("  Blocks: %.1fMB, %.1fMB allocated", heap.BlockBytes / (1024.0 * 1024.0),
+									heap.AllocationBytes / (1024.0 * 1024.0));
+					}
+					ImGui::Separator();
+					for (const GpuMemoryTag& tag : memoryStats.Tags)
+					{
+						ImGui::Text("%s: %.1fMB (%u allocations)", tag.Name.c_str(), tag.Bytes / (1024.0 * 1024.0),
+									tag.AllocationCount);
+					}
+				}
 				ImGui::End();
 
 				SceneRenderer::OnImGuiRender();
@@ -165,9 +339,15 @@ namespace Neon
 				}
 
 				m_GuiContext->End();
+			},
+			{m_FrameTasks.LayerTick, m_FrameTasks.PhysicsSync}, TaskAffinity::MainThread);
 
-				m_Window->SwapBuffers();
-			}
+		m_FrameTasks.Present = m_FrameTaskGraph.AddTask(
+			"Present", [this]() { m_Window->SwapBuffers(); }, {m_FrameTasks.RenderGui}, TaskAffinity::MainThread);
+
+		for (Layer* layer : m_LayerStack)
+		{
+			layer->OnFrameTasks(m_FrameTaskGraph, m_FrameTasks);
 		}
 	}
 
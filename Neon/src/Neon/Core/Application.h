@@ -3,6 +3,7 @@
 #include "Neon/Core/Event/ApplicationEvent.h"
 #include "Neon/Core/Layer.h"
 #include "Neon/Core/LayerStack.h"
+#include "Neon/Core/TaskGraph.h"
 #include "Neon/Core/Window.h"
 #include "Neon/Gui/GuiContext.h"
 
@@ -10,18 +11,40 @@
 
 namespace Neon
 {
+	struct ApplicationCommandLineArgs
+	{
+		int Count = 0;
+		char** Args = nullptr;
+
+		const char* operator[](int index) const
+		{
+			NEO_CORE_ASSERT(index < Count);
+			return Args[index];
+		}
+	};
+
 	struct ApplicationProps
 	{
 		std::string Name;
 		uint32 WindowWidth;
 		uint32 WindowHeight;
 
+		// Renders offscreen without a window, swapchain or gui
+		bool Headless = false;
+		// Number of frames to run before closing, 0 runs until the window is closed
+		uint32 FrameCount = 0;
+		// Every frame advances by this many seconds instead of the measured time, 0 uses the measured time
+		float FixedTimestep = 0.f;
+
 		ApplicationProps(const std::string& name = "Neon Engine", uint32 windowWidth = 1920, uint32 windowHeight = 1080)
 			: Name(name)
 			, WindowWidth(windowWidth)
 			, WindowHeight(windowHeight)
 		{
 		}
+
+		// Recognizes --headless and --frames <count>
+		void ParseCommandLine(const ApplicationCommandLineArgs& args);
 	};
 
 	class Application
@@ -47,12 +70,25 @@ namespace Neon
 			return *m_Window;
 		}
 
+		TaskGraph& GetFrameTaskGraph()
+		{
+			return m_FrameTaskGraph;
+		}
+
+		// Seconds the current frame advances by
+		float GetDeltaSeconds() const
+		{
+			return m_DeltaSeconds;
+		}
+
 		static Application& Get() noexcept
 		{
 			return *s_Instance;
 		}
 
 	private:
+		void BuildFrameTasks(float deltaSeconds);
+
 		bool OnWindowClose(WindowCloseEvent& e);
 		bool OnWindowResize(WindowResizeEvent& e);
 
@@ -61,16 +97,26 @@ namespace Neon
 
 		bool m_Running = true;
 		bool m_Minimized = false;
+		bool m_Headless = false;
+		bool m_DefragmentMemoryRequested = false;
+
+		uint32 m_FrameCount = 0;
+		uint32 m_MaxFrameCount = 0;
+		float m_FixedTimestep = 0.f;
+		float m_DeltaSeconds = 0.f;
 
 		LayerStack m_LayerStack;
 		SharedRef<GuiContext> m_GuiContext;
 
+		TaskGraph m_FrameTaskGraph;
+		FrameTasks m_FrameTasks{};
+
 		std::chrono::time_point<std::chrono::steady_clock> m_LastFrameTime = std::chrono::high_resolution_clock::now();
 
 	private:
 		static Application* s_Instance;
 	};
 
-	Application* CreateApplication();
+	Application* CreateApplication(ApplicationCommandLineArgs args);
 
 } // namespace Neon
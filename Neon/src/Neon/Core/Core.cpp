@@ -1,6 +1,8 @@
 #include "neopch.h"
 
 #include "Core.h"
+#include "JobSystem.h"
+#include "Profiler.h"
 
 namespace Neon
 {
@@ -10,10 +12,15 @@ namespace Neon
 
 		NEO_CORE_TRACE("Neon Engine");
 		NEO_CORE_TRACE("Initializing...");
+
+		Profiler::SetThreadName("Main");
+		JobSystem::Initialize();
 	}
 
 	void ShutdownCore()
 	{
 		NEO_CORE_TRACE("Shutting down...");
+
+		JobSystem::Shutdown();
 	}
 } // namespace Neon
@@ -4,12 +4,12 @@
 
 #include "Application.h"
 
-extern Neon::Application* Neon::CreateApplication();
+extern Neon::Application* Neon::CreateApplication(Neon::ApplicationCommandLineArgs args);
 
 int main(int argc, char** argv)
 {
 	Neon::InitializeCore();
-	auto app = Neon::CreateApplication();
+	auto app = Neon::CreateApplication({argc, argv});
 	app->Run();
 	delete app;
 	Neon::ShutdownCore();
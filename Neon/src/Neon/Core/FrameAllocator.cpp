@@ -0,0 +1,137 @@
+#include "neopch.h"
+
+#include "Neon/Core/FrameAllocator.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace Neon
+{
+	static constexpr size_t c_ArenaBlockSize = 256 * 1024;
+
+	struct FrameArenaBlock
+	{
+		UniqueRef<byte[]> Memory;
+		size_t Size = 0;
+	};
+
+	struct FrameArena
+	{
+		std::vector<FrameArenaBlock> Blocks;
+		size_t BlockIndex = 0;
+		size_t Offset = 0;
+		uint64 FrameNumber = 0;
+	};
+
+	static thread_local std::vector<FrameArena> t_FrameArenas;
+
+	static std::atomic<uint32> s_FramesInFlight = 0;
+	static std::atomic<uint64> s_FrameNumber = 0;
+	static std::atomic<uint64> s_ArenaBytes = 0;
+	static std::atomic<uint64> s_HeapAllocations = 0;
+	static std::atomic<uint64> s_FrameStartHeapAllocations = 0;
+	static std::atomic<uint64> s_LastFrameHeapAllocations = 0;
+	static std::atomic<uint64> s_LastFrameArenaBytes = 0;
+
+	void FrameAllocator::Initialize(uint32 framesInFlight)
+	{
+		NEO_CORE_ASSERT(framesInFlight > 0, "Frame allocator needs at least one frame in flight!");
+		NEO_CORE_ASSERT(s_FramesInFlight == 0, "Frame allocator is already initialized!");
+
+		s_FramesInFlight = framesInFlight;
+	}
+
+	void* FrameAllocator::Allocate(size_t size, size_t alignment /*= alignof(std::max_align_t)*/)
+	{
+		NEO_CORE_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment has to be a power of two!");
+
+		const uint32 framesInFlight = s_FramesInFlight.load(std::memory_order_relaxed);
+		NEO_CORE_ASSERT(framesInFlight > 0, "Frame allocator is not initialized!");
+		if (t_FrameArenas.size() != framesInFlight)
+		{
+			t_FrameArenas.resize(framesInFlight);
+		}
+
+		const uint64 frameNumber = s_FrameNumber.load(std::memory_order_acquire);
+		FrameArena& arena = t_FrameArenas[frameNumber % framesInFlight];
+		if (arena.FrameNumber != frameNumber)
+		{
+			arena.FrameNumber = frameNumber;
+			arena.BlockIndex = 0;
+			arena.Offset = 0;
+		}
+
+		s_ArenaBytes.fetch_add(size, std::memory_order_relaxed);
+
+		while (true)
+		{
+			if (arena.BlockIndex < arena.Blocks.size())
+			{
+				FrameArenaBlock& block = arena.Blocks[arena.BlockIndex];
+				uintptr_t base = reinterpret_cast<uintptr_t>(block.Memory.get());
+				uintptr_t aligned = (base + arena.Offset + alignment - 1) & ~(alignment - 1);
+				if (aligned + size <= base + block.Size)
+				{
+					arena.Offset = aligned + size - base;
+					return reinterpret_cast<void*>(aligned);
+				}
+
+				arena.BlockIndex++;
+				arena.Offset = 0;
+				continue;
+			}
+
+			// Blocks are kept around after a rewind, so this only happens while the arena grows
+			FrameArenaBlock& block = arena.Blocks.emplace_back();
+			block.Size = std::max(c_ArenaBlockSize, size + alignment);
+			block.Memory = UniqueRef<byte[]>(new byte[block.Size]);
+		}
+	}
+
+	void FrameAllocator::BeginFrame()
+	{
+		uint64 heapAllocations = s_HeapAllocations.load(std::memory_order_relaxed);
+		s_LastFrameHeapAllocations = heapAllocations - s_FrameStartHeapAllocations.load();
+		s_FrameStartHeapAllocations = heapAllocations;
+		s_LastFrameArenaBytes = s_ArenaBytes.exchange(0, std::memory_order_relaxed);
+
+		s_FrameNumber.fetch_add(1, std::memory_order_release);
+	}
+
+	FrameAllocatorStats FrameAllocator::GetLastFrameStats()
+	{
+		FrameAllocatorStats stats;
+		stats.HeapAllocations = s_LastFrameHeapAllocations.load();
+		stats.ArenaBytes = s_LastFrameArenaBytes.load();
+		return stats;
+	}
+
+	uint64 FrameAllocator::GetHeapAllocationCount()
+	{
+		return s_HeapAllocations.load(std::memory_order_relaxed);
+	}
+} // namespace Neon
+
+#if NEO_TRACK_HEAP_ALLOCATIONS
+// Replaces the global allocation functions to count heap allocations, array and nothrow versions forward to these
+void* operator new(size_t size)
+{
+	Neon::s_HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+	void* memory = std::malloc(size > 0 ? size : 1);
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+#endif
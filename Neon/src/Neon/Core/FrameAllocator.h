@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Replacing global operator new costs every allocation, it is only done for builds generated with --track-allocations
+#ifndef NEO_TRACK_HEAP_ALLOCATIONS
+	#define NEO_TRACK_HEAP_ALLOCATIONS 0
+#endif
+
+namespace Neon
+{
+	struct FrameAllocatorStats
+	{
+		// Global operator new calls during the last frame, always 0 without NEO_TRACK_HEAP_ALLOCATIONS
+		uint64 HeapAllocations = 0;
+		// Bytes handed out by frame arenas during the last frame
+		uint64 ArenaBytes = 0;
+	};
+
+	// Linear allocator for transient data which does not outlive the frames in flight. Every thread bump allocates
+	// from its own arena for the current frame, arenas are rewound wholesale once their frame slot comes around again.
+	class FrameAllocator
+	{
+	public:
+		// Takes one arena per frame the renderer keeps in flight, has to run before the first allocation
+		static void Initialize(uint32 framesInFlight);
+
+		static void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		// Starts a new frame, memory allocated frames in flight frames ago is reused from now on
+		static void BeginFrame();
+
+		static FrameAllocatorStats GetLastFrameStats();
+
+		static uint64 GetHeapAllocationCount();
+	};
+
+	// STL allocator on top of the frame arenas, deallocation is a no-op
+	template<typename T>
+	class FrameStlAllocator
+	{
+	public:
+		using value_type = T;
+		using propagate_on_container_move_assignment = std::true_type;
+		using is_always_equal = std::true_type;
+
+		FrameStlAllocator() = default;
+		template<typename U>
+		FrameStlAllocator(const FrameStlAllocator<U>&)
+		{
+		}
+
+		T* allocate(size_t count)
+		{
+			return static_cast<T*>(FrameAllocator::Allocate(count * sizeof(T), alignof(T)));
+		}
+		void deallocate(T*, size_t)
+		{
+		}
+
+		template<typename U>
+		bool operator==(const FrameStlAllocator<U>&) const
+		{
+			return true;
+		}
+		template<typename U>
+		bool operator!=(const FrameStlAllocator<U>&) const
+		{
+			return false;
+		}
+	};
+
+	// Containers have to be dropped (not just cleared) before their frame slot is reused
+	template<typename T>
+	using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+} // namespace Neon
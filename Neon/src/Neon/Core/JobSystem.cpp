@@ -0,0 +1,412 @@
+#include "neopch.h"
+
+#include "Neon/Core/JobSystem.h"
+#include "Neon/Core/Profiler.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace Neon
+{
+	static constexpr uint32 c_MaxJobsPerThread = 4096;
+	static constexpr uint32 c_IdleSpinCount = 64;
+
+	// Chase-Lev work stealing deque. Only the owning thread pushes and pops from the bottom, other threads steal from the top.
+	class JobDeque
+	{
+	public:
+		bool Push(Job* job)
+		{
+			int64 bottom = m_Bottom.load(std::memory_order_relaxed);
+			int64 top = m_Top.load(std::memory_order_acquire);
+			if (bottom - top >= static_cast<int64>(c_MaxJobsPerThread))
+			{
+				return false;
+			}
+
+			m_Jobs[bottom & (c_MaxJobsPerThread - 1)].store(job, std::memory_order_relaxed);
+			m_Bottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		Job* Pop()
+		{
+			int64 bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+			m_Bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 top = m_Top.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			Job* job = m_Jobs[bottom & (c_MaxJobsPerThread - 1)].load(std::memory_order_relaxed);
+			if (top == bottom)
+			{
+				// Last job, race against thieves
+				if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					job = nullptr;
+				}
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+			return job;
+		}
+
+		Job* Steal()
+		{
+			int64 top = m_Top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 bottom = m_Bottom.load(std::memory_order_acquire);
+
+			if (top >= bottom)
+			{
+				return nullptr;
+			}
+
+			Job* job = m_Jobs[top & (c_MaxJobsPerThread - 1)].load(std::memory_order_relaxed);
+			if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				return nullptr;
+			}
+			return job;
+		}
+
+		bool IsEmpty() const
+		{
+			return m_Bottom.load(std::memory_order_acquire) <= m_Top.load(std::memory_order_acquire);
+		}
+
+	private:
+		alignas(64) std::atomic<int64> m_Top = 0;
+		alignas(64) std::atomic<int64> m_Bottom = 0;
+		std::array<std::atomic<Job*>, c_MaxJobsPerThread> m_Jobs{};
+	};
+
+	struct JobWorker
+	{
+		JobDeque Queue;
+		std::array<Job, c_MaxJobsPerThread> Jobs;
+		uint32 AllocatedJobs = 0;
+		uint32 RandomState = 0;
+
+		std::atomic<uint64> JobsExecuted = 0;
+		std::atomic<uint64> JobsStolen = 0;
+	};
+
+	static std::vector<UniqueRef<JobWorker>> s_Workers;
+	static std::vector<std::thread> s_Threads;
+	static std::atomic<bool> s_Running = false;
+
+	static std::mutex s_SleepMutex;
+	static std::condition_variable s_SleepCondition;
+	static std::atomic<uint32> s_SleepingWorkers = 0;
+
+	// Jobs whose dependency was not satisfied at submit time
+	static std::mutex s_DeferredMutex;
+	static std::vector<Job*> s_DeferredJobs;
+	static std::atomic<uint32> s_DeferredJobCount = 0;
+
+	static thread_local int32 t_ThreadIndex = -1;
+
+	static void WakeWorker()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (s_SleepingWorkers.load(std::memory_order_seq_cst) > 0)
+		{
+			std::lock_guard<std::mutex> lock(s_SleepMutex);
+			s_SleepCondition.notify_one();
+		}
+	}
+
+	static Job* TakeDeferredJob()
+	{
+		if (s_DeferredJobCount.load(std::memory_order_relaxed) == 0)
+		{
+			return nullptr;
+		}
+
+		std::lock_guard<std::mutex> lock(s_DeferredMutex);
+		for (auto it = s_DeferredJobs.begin(); it != s_DeferredJobs.end(); it++)
+		{
+			if ((*it)->Dependency->IsDone())
+			{
+				Job* job = *it;
+				s_DeferredJobs.erase(it);
+				s_DeferredJobCount.fetch_sub(1, std::memory_order_relaxed);
+				return job;
+			}
+		}
+		return nullptr;
+	}
+
+	static Job* TakeJob(uint32 threadIndex)
+	{
+		JobWorker& worker = *s_Workers[threadIndex];
+		if (Job* job = worker.Queue.Pop())
+		{
+			return job;
+		}
+
+		uint32 workerCount = static_cast<uint32>(s_Workers.size());
+		worker.RandomState ^= worker.RandomState << 13;
+		worker.RandomState ^= worker.RandomState >> 17;
+		worker.RandomState ^= worker.RandomState << 5;
+		uint32 offset = worker.RandomState % workerCount;
+		for (uint32 i = 0; i < workerCount; i++)
+		{
+			uint32 victimIndex = (offset + i) % workerCount;
+			if (victimIndex == threadIndex)
+			{
+				continue;
+			}
+			if (Job* job = s_Workers[victimIndex]->Queue.Steal())
+			{
+				worker.JobsStolen.fetch_add(1, std::memory_order_relaxed);
+				return job;
+			}
+		}
+
+		return TakeDeferredJob();
+	}
+
+	static bool HasPendingWork()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		for (const auto& worker : s_Workers)
+		{
+			if (!worker->Queue.IsEmpty())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static void WorkerThread(uint32 threadIndex)
+	{
+		t_ThreadIndex = static_cast<int32>(threadIndex);
+		Profiler::SetThreadName("Worker " + std::to_string(threadIndex));
+
+		uint32 idleSpins = 0;
+		while (s_Running.load(std::memory_order_acquire))
+		{
+			if (JobSystem::RunPendingJob())
+			{
+				idleSpins = 0;
+				continue;
+			}
+
+			if (++idleSpins < c_IdleSpinCount)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(s_SleepMutex);
+			s_SleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+			if (s_Running.load(std::memory_order_acquire) && !HasPendingWork())
+			{
+				if (s_DeferredJobCount.load(std::memory_order_relaxed) > 0)
+				{
+					s_SleepCondition.wait_for(lock, std::chrono::milliseconds(1));
+				}
+				else
+				{
+					s_SleepCondition.wait(lock);
+				}
+			}
+			s_SleepingWorkers.fetch_sub(1, std::memory_order_seq_cst);
+			idleSpins = 0;
+		}
+	}
+
+	void JobSystem::Initialize(uint32 workerCount /*= c_HardwareWorkerCount*/)
+	{
+		NEO_CORE_ASSERT(!IsInitialized(), "Job system already initialized!");
+
+		if (workerCount == c_HardwareWorkerCount)
+		{
+			workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+		}
+
+		// Index 0 belongs to the thread which initialized job system
+		uint32 threadCount = workerCount + 1;
+		s_Workers.reserve(threadCount);
+		for (uint32 i = 0; i < threadCount; i++)
+		{
+			auto& worker = s_Workers.emplace_back(CreateUnique<JobWorker>());
+			worker->RandomState = 0x9E3779B9u * (i + 1);
+		}
+		t_ThreadIndex = 0;
+
+		s_Running = true;
+		s_Threads.reserve(workerCount);
+		for (uint32 i = 1; i < threadCount; i++)
+		{
+			s_Threads.emplace_back(WorkerThread, i);
+		}
+
+		NEO_CORE_INFO("Job system initialized with {0} worker threads", workerCount);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		NEO_CORE_ASSERT(t_ThreadIndex == 0, "Job system has to be shut down from the thread which initialized it!");
+
+		// Let everything that is still queued finish, deferred jobs point into the job arrays of the workers freed below
+		while (HasPendingWork() || s_DeferredJobCount.load(std::memory_order_relaxed) > 0)
+		{
+			if (!RunPendingJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_SleepMutex);
+			s_Running = false;
+			s_SleepCondition.notify_all();
+		}
+
+		for (std::thread& thread : s_Threads)
+		{
+			if (thread.joinable())
+			{
+				thread.join();
+			}
+		}
+
+		NEO_CORE_ASSERT(s_DeferredJobs.empty(), "Deferred jobs left behind at shutdown!");
+		s_DeferredJobs.clear();
+		s_DeferredJobCount = 0;
+
+		s_Threads.clear();
+		s_Workers.clear();
+		t_ThreadIndex = -1;
+	}
+
+	void JobSystem::Wait(const JobCounter& counter)
+	{
+		while (!counter.IsDone())
+		{
+			if (!RunPendingJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bool JobSystem::RunPendingJob()
+	{
+		if (t_ThreadIndex < 0)
+		{
+			return false;
+		}
+
+		uint32 threadIndex = static_cast<uint32>(t_ThreadIndex);
+		Job* job = TakeJob(threadIndex);
+		if (!job)
+		{
+			return false;
+		}
+
+		Execute(job);
+		s_Workers[threadIndex]->JobsExecuted.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	uint32 JobSystem::GetThreadCount()
+	{
+		return std::max(1u, static_cast<uint32>(s_Workers.size()));
+	}
+
+	uint32 JobSystem::GetCurrentThreadIndex()
+	{
+		NEO_CORE_ASSERT(t_ThreadIndex >= 0, "Calling thread is not owned by the job system!");
+		return static_cast<uint32>(t_ThreadIndex);
+	}
+
+	bool JobSystem::IsInitialized()
+	{
+		return !s_Workers.empty();
+	}
+
+	JobSystemStats JobSystem::GetStats()
+	{
+		JobSystemStats stats;
+		stats.WorkerCount = static_cast<uint32>(s_Threads.size());
+		for (const auto& worker : s_Workers)
+		{
+			stats.JobsExecuted += worker->JobsExecuted.load(std::memory_order_relaxed);
+			stats.JobsStolen += worker->JobsStolen.load(std::memory_order_relaxed);
+		}
+		return stats;
+	}
+
+	bool JobSystem::IsJobSystemThread()
+	{
+		return t_ThreadIndex >= 0;
+	}
+
+	Job* JobSystem::AllocateJob()
+	{
+		NEO_CORE_ASSERT(t_ThreadIndex >= 0, "Jobs are only allocated on threads owned by the job system!");
+
+		JobWorker& worker = *s_Workers[t_ThreadIndex];
+		while (true)
+		{
+			Job* job = &worker.Jobs[worker.AllocatedJobs & (c_MaxJobsPerThread - 1)];
+			if (!job->InUse.load(std::memory_order_acquire))
+			{
+				worker.AllocatedJobs++;
+				job->InUse.store(true, std::memory_order_relaxed);
+				return job;
+			}
+
+			// Oldest job is still in flight, help out until it gets released
+			if (!RunPendingJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void JobSystem::Submit(Job* job)
+	{
+		if (job->Dependency && !job->Dependency->IsDone())
+		{
+			std::lock_guard<std::mutex> lock(s_DeferredMutex);
+			s_DeferredJobs.push_back(job);
+			s_DeferredJobCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		else
+		{
+			bool pushed = s_Workers[t_ThreadIndex]->Queue.Push(job);
+			NEO_CORE_ASSERT(pushed, "Job queue overflow!");
+			if (!pushed)
+			{
+				Execute(job);
+				return;
+			}
+		}
+
+		WakeWorker();
+	}
+
+	void JobSystem::Execute(Job* job)
+	{
+		job->Function(*job);
+
+		JobCounter* counter = job->Counter;
+		job->InUse.store(false, std::memory_order_release);
+
+		if (counter && counter->Decrement() && s_DeferredJobCount.load(std::memory_order_relaxed) > 0)
+		{
+			WakeWorker();
+		}
+	}
+} // namespace Neon
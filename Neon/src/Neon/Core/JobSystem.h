@@ -0,0 +1,179 @@
+#pragma once
+
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+namespace Neon
+{
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		bool IsDone() const
+		{
+			return m_Value.load(std::memory_order_acquire) == 0;
+		}
+
+		uint32 GetValue() const
+		{
+			return m_Value.load(std::memory_order_acquire);
+		}
+
+	private:
+		void Increment(uint32 count = 1)
+		{
+			m_Value.fetch_add(count, std::memory_order_relaxed);
+		}
+		// Returns true when counter reaches zero
+		bool Decrement()
+		{
+			return m_Value.fetch_sub(1, std::memory_order_acq_rel) == 1;
+		}
+
+	private:
+		std::atomic<uint32> m_Value = 0;
+
+		friend class JobSystem;
+	};
+
+	// Job payload is stored inline, so captures have to fit into c_JobDataSize bytes
+	struct alignas(64) Job
+	{
+		static constexpr uint32 c_JobDataSize = 32;
+
+		void (*Function)(Job& job) = nullptr;
+		JobCounter* Counter = nullptr;
+		const JobCounter* Dependency = nullptr;
+		std::atomic<bool> InUse = false;
+		alignas(8) byte Data[c_JobDataSize];
+	};
+
+	struct JobSystemStats
+	{
+		uint32 WorkerCount = 0;
+		uint64 JobsExecuted = 0;
+		uint64 JobsStolen = 0;
+	};
+
+	class JobSystem
+	{
+	public:
+		// One worker per hardware thread besides the initializing one
+		static constexpr uint32 c_HardwareWorkerCount = std::numeric_limits<uint32>::max();
+
+		// Worker threads are started in addition to the calling thread, which becomes thread 0. With no workers every job
+		// runs on the calling thread while it waits.
+		static void Initialize(uint32 workerCount = c_HardwareWorkerCount);
+		static void Shutdown();
+
+		// Queues a job on the calling thread's deque. Counter (if any) is decremented once the job finishes and
+		// the job will not start before dependency reaches zero.
+		template<typename F>
+		static void Run(F&& func, JobCounter* counter = nullptr, const JobCounter* dependency = nullptr)
+		{
+			using FuncType = std::decay_t<F>;
+			static_assert(sizeof(FuncType) <= Job::c_JobDataSize, "Job capture is too big!");
+			static_assert(alignof(FuncType) <= 8, "Job capture alignment is too big!");
+
+			// Threads which are not owned by the job system run the job right away, nested jobs included
+			if (!IsJobSystemThread())
+			{
+				if (dependency)
+				{
+					Wait(*dependency);
+				}
+				std::forward<F>(func)();
+				return;
+			}
+
+			Job* job = AllocateJob();
+			new (job->Data) FuncType(std::forward<F>(func));
+			job->Function = [](Job& job) {
+				FuncType* function = reinterpret_cast<FuncType*>(job.Data);
+				(*function)();
+				function->~FuncType();
+			};
+			job->Counter = counter;
+			job->Dependency = dependency;
+			if (counter)
+			{
+				counter->Increment();
+			}
+
+			Submit(job);
+		}
+
+		// Splits [0, count) into batches and calls func(begin, end) for each of them. Calling thread takes part
+		// in the work and returns once every batch is finished.
+		template<typename F>
+		static void ParallelFor(uint32 count, F&& func, uint32 batchSize = 0)
+		{
+			if (count == 0)
+			{
+				return;
+			}
+
+			if (batchSize == 0)
+			{
+				batchSize = std::max(1u, count / (GetThreadCount() * 4));
+			}
+
+			if (batchSize >= count)
+			{
+				func(0u, count);
+				return;
+			}
+
+			JobCounter counter;
+			auto* function = &func;
+			for (uint32 begin = 0; begin < count; begin += batchSize)
+			{
+				uint32 end = std::min(count, begin + batchSize);
+				Run([function, begin, end]() { (*function)(begin, end); }, &counter);
+			}
+			Wait(counter);
+		}
+
+		template<typename Container, typename F>
+		static void ParallelForEach(Container& container, F&& func, uint32 batchSize = 0)
+		{
+			auto first = std::begin(container);
+			ParallelFor(
+				static_cast<uint32>(std::size(container)),
+				[first, &func](uint32 begin, uint32 end) {
+					auto it = std::next(first, begin);
+					for (uint32 i = begin; i < end; i++, ++it)
+					{
+						func(*it);
+					}
+				},
+				batchSize);
+		}
+
+		// Executes pending jobs on the calling thread until counter reaches zero
+		static void Wait(const JobCounter& counter);
+
+		// Tries to execute a single pending job on the calling thread
+		static bool RunPendingJob();
+
+		// Main thread counts as a worker as well
+		static uint32 GetThreadCount();
+		static uint32 GetCurrentThreadIndex();
+		static bool IsInitialized();
+
+		static JobSystemStats GetStats();
+
+	private:
+		static bool IsJobSystemThread();
+		static Job* AllocateJob();
+		static void Submit(Job* job);
+		static void Execute(Job* job);
+	};
+} // namespace Neon
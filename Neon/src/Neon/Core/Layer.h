@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Event/Event.h"
+#include "TaskGraph.h"
 
 namespace Neon
 {
@@ -17,12 +18,24 @@ namespace Neon
 
 		virtual void OnDetach() = 0;
 
+		// Called every frame on a job thread while physics simulates, for CPU side work like ticking the scene and
+		// culling. Must not touch the window, gui or the render command buffers.
+		virtual void Update(float deltaSeconds)
+		{
+		}
+
+		// Called every frame on the main thread after all layers updated, records the rendering of the layer
 		virtual void Tick(float deltaSeconds) = 0;
 
 		virtual void OnRenderGui() = 0;
 
 		virtual void OnEvent(Event& event) = 0;
 
+		// Called every frame after application tasks are added, lets layer hook its own tasks into the frame
+		virtual void OnFrameTasks(TaskGraph& taskGraph, const FrameTasks& frameTasks)
+		{
+		}
+
 		inline const std::string& GetName() const
 		{
 			return m_DebugName;
@@ -0,0 +1,239 @@
+#include "neopch.h"
+
+#include "Neon/Core/Profiler.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+
+namespace Neon
+{
+	static constexpr uint32 c_MaxZonesPerThread = 16384;
+	static constexpr uint32 c_FrameHistorySize = 8;
+
+	// Single writer ring buffer, readers copy it out and drop entries which got overwritten in the meantime
+	struct ProfilerThreadData
+	{
+		std::string Name;
+		uint32 Id = 0;
+		uint32 Depth = 0;
+
+		std::array<ProfileZone, c_MaxZonesPerThread> Zones;
+		std::atomic<uint64> WriteIndex = 0;
+	};
+
+	static const std::chrono::steady_clock::time_point s_StartTime = std::chrono::steady_clock::now();
+
+	static std::mutex s_ThreadsMutex;
+	static std::vector<UniqueRef<ProfilerThreadData>> s_Threads;
+
+	static std::mutex s_StringsMutex;
+	static std::unordered_set<std::string> s_InternedStrings;
+
+	static std::mutex s_TrackZonesMutex;
+
+	static std::array<std::atomic<uint64>, c_FrameHistorySize> s_FrameStarts = {};
+	static std::atomic<uint64> s_FrameCount = 0;
+
+	static thread_local ProfilerThreadData* t_ThreadData = nullptr;
+
+	static ProfilerThreadData& GetThreadData()
+	{
+		if (!t_ThreadData)
+		{
+			std::lock_guard<std::mutex> lock(s_ThreadsMutex);
+			auto& threadData = s_Threads.emplace_back(CreateUnique<ProfilerThreadData>());
+			threadData->Id = static_cast<uint32>(s_Threads.size() - 1);
+			threadData->Name = "Thread " + std::to_string(threadData->Id);
+			t_ThreadData = threadData.get();
+		}
+		return *t_ThreadData;
+	}
+
+	void Profiler::SetEnabled(bool enabled)
+	{
+		s_Enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	uint64 Profiler::GetTimestamp()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_StartTime).count();
+	}
+
+	void Profiler::SetThreadName(const std::string& name)
+	{
+		ProfilerThreadData& threadData = GetThreadData();
+
+		std::lock_guard<std::mutex> lock(s_ThreadsMutex);
+		threadData.Name = name;
+	}
+
+	const char* Profiler::InternString(const std::string& str)
+	{
+		std::lock_guard<std::mutex> lock(s_StringsMutex);
+		return s_InternedStrings.insert(str).first->c_str();
+	}
+
+	void Profiler::MarkFrame()
+	{
+		uint64 frameCount = s_FrameCount.load();
+		s_FrameStarts[frameCount % c_FrameHistorySize] = GetTimestamp();
+		s_FrameCount = frameCount + 1;
+	}
+
+	uint64 Profiler::GetLastFrameStart(uint32 framesAgo /*= 0*/)
+	{
+		uint64 frameCount = s_FrameCount.load();
+		if (framesAgo + 2 > frameCount || framesAgo + 2 > c_FrameHistorySize)
+		{
+			return 0;
+		}
+		return s_FrameStarts[(frameCount - framesAgo - 2) % c_FrameHistorySize].load();
+	}
+
+	uint64 Profiler::GetLastFrameEnd(uint32 framesAgo /*= 0*/)
+	{
+		uint64 frameCount = s_FrameCount.load();
+		if (framesAgo + 2 > frameCount || framesAgo + 2 > c_FrameHistorySize)
+		{
+			return 0;
+		}
+		return s_FrameStarts[(frameCount - framesAgo - 1) % c_FrameHistorySize].load();
+	}
+
+	void Profiler::BeginZone()
+	{
+		GetThreadData().Depth++;
+	}
+
+	void Profiler::EndZone(const char* name, const char* category, uint64 start)
+	{
+		uint64 end = GetTimestamp();
+
+		ProfilerThreadData& threadData = GetThreadData();
+		threadData.Depth--;
+
+		uint64 writeIndex = threadData.WriteIndex.load(std::memory_order_relaxed);
+		ProfileZone& zone = threadData.Zones[writeIndex % c_MaxZonesPerThread];
+		zone.Name = name;
+		zone.Category = category;
+		zone.Start = start;
+		zone.End = end;
+		zone.Depth = threadData.Depth;
+		threadData.WriteIndex.store(writeIndex + 1, std::memory_order_release);
+	}
+
+	uint32 Profiler::CreateTrack(const std::string& name)
+	{
+		std::lock_guard<std::mutex> lock(s_ThreadsMutex);
+		auto& trackData = s_Threads.emplace_back(CreateUnique<ProfilerThreadData>());
+		trackData->Id = static_cast<uint32>(s_Threads.size() - 1);
+		trackData->Name = name;
+		return trackData->Id;
+	}
+
+	void Profiler::SubmitZone(uint32 track, const ProfileZone& zone)
+	{
+		ProfilerThreadData* trackData = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(s_ThreadsMutex);
+			NEO_CORE_ASSERT(track < s_Threads.size(), "Invalid profiler track!");
+			trackData = s_Threads[track].get();
+		}
+
+		// Any thread can submit to a track, serialize them so the ring keeps a single writer
+		std::lock_guard<std::mutex> lock(s_TrackZonesMutex);
+		uint64 writeIndex = trackData->WriteIndex.load(std::memory_order_relaxed);
+		trackData->Zones[writeIndex % c_MaxZonesPerThread] = zone;
+		trackData->WriteIndex.store(writeIndex + 1, std::memory_order_release);
+	}
+
+	std::vector<ProfileTrack> Profiler::CaptureZones(uint64 start /*= 0*/, uint64 end /*= ~0ull*/)
+	{
+		std::lock_guard<std::mutex> lock(s_ThreadsMutex);
+
+		std::vector<ProfileTrack> tracks;
+		tracks.reserve(s_Threads.size());
+		for (const auto& threadData : s_Threads)
+		{
+			ProfileTrack& track = tracks.emplace_back();
+			track.Name = threadData->Name;
+			track.Id = threadData->Id;
+
+			uint64 lastIndex = threadData->WriteIndex.load(std::memory_order_acquire);
+			uint64 firstIndex = lastIndex > c_MaxZonesPerThread ? lastIndex - c_MaxZonesPerThread : 0;
+			std::vector<ProfileZone> zones(threadData->Zones.begin(), threadData->Zones.end());
+
+			// Writer might have lapped us while copying, skip slots which could have been overwritten
+			uint64 newLastIndex = threadData->WriteIndex.load(std::memory_order_acquire);
+			if (newLastIndex > c_MaxZonesPerThread)
+			{
+				firstIndex = std::max(firstIndex, newLastIndex - c_MaxZonesPerThread + 1);
+			}
+
+			for (uint64 i = firstIndex; i < lastIndex; i++)
+			{
+				const ProfileZone& zone = zones[i % c_MaxZonesPerThread];
+				if (zone.End > start && zone.Start < end)
+				{
+					track.Zones.push_back(zone);
+				}
+			}
+		}
+
+		return tracks;
+	}
+
+	static void WriteJsonString(std::ofstream& out, const char* str)
+	{
+		out << '"';
+		for (const char* c = str ? str : ""; *c; c++)
+		{
+			if (*c == '"' || *c == '\\')
+			{
+				out << '\\';
+			}
+			out << *c;
+		}
+		out << '"';
+	}
+
+	bool Profiler::ExportChromeTrace(const std::string& filepath)
+	{
+		std::ofstream out(filepath);
+		if (!out)
+		{
+			NEO_CORE_ERROR("Failed to open {0} for writing profiler trace", filepath);
+			return false;
+		}
+
+		std::vector<ProfileTrack> tracks = CaptureZones();
+
+		out << std::fixed << std::setprecision(3);
+		out << "{\"traceEvents\":[";
+		bool first = true;
+		for (const ProfileTrack& track : tracks)
+		{
+			out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << track.Id
+				<< ",\"args\":{\"name\":";
+			WriteJsonString(out, track.Name.c_str());
+			out << "}}";
+			first = false;
+
+			for (const ProfileZone& zone : track.Zones)
+			{
+				out << ",\n{\"name\":";
+				WriteJsonString(out, zone.Name);
+				out << ",\"cat\":";
+				WriteJsonString(out, zone.Category);
+				out << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << track.Id << ",\"ts\":" << zone.Start / 1000.0
+					<< ",\"dur\":" << (zone.End - zone.Start) / 1000.0 << "}";
+			}
+		}
+		out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+		NEO_CORE_INFO("Profiler trace exported to {0}", filepath);
+		return true;
+	}
+} // namespace Neon
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+
+#ifndef NEO_ENABLE_PROFILING
+	#define NEO_ENABLE_PROFILING 1
+#endif
+
+namespace Neon
+{
+	struct ProfileZone
+	{
+		const char* Name = nullptr;
+		const char* Category = nullptr;
+		uint64 Start = 0;
+		uint64 End = 0;
+		uint32 Depth = 0;
+	};
+
+	struct ProfileTrack
+	{
+		std::string Name;
+		uint32 Id = 0;
+		std::vector<ProfileZone> Zones;
+	};
+
+	class Profiler
+	{
+	public:
+		static void SetEnabled(bool enabled);
+		static bool IsEnabled()
+		{
+			return s_Enabled.load(std::memory_order_relaxed);
+		}
+
+		// Nanoseconds since profiler start
+		static uint64 GetTimestamp();
+
+		static void SetThreadName(const std::string& name);
+
+		// Zones keep raw name pointers, dynamic names have to outlive the profiler
+		static const char* InternString(const std::string& str);
+
+		// Marks the start of a new frame on the main thread, the last few frame boundaries are kept around
+		static void MarkFrame();
+		static uint64 GetLastFrameStart(uint32 framesAgo = 0);
+		static uint64 GetLastFrameEnd(uint32 framesAgo = 0);
+
+		static void BeginZone();
+		static void EndZone(const char* name, const char* category, uint64 start);
+
+		// Tracks which are not tied to a CPU thread, e.g. GPU queues. Zones are submitted after the fact.
+		static uint32 CreateTrack(const std::string& name);
+		static void SubmitZone(uint32 track, const ProfileZone& zone);
+
+		// Returns every recorded zone which overlaps [start, end), grouped per thread
+		static std::vector<ProfileTrack> CaptureZones(uint64 start = 0, uint64 end = ~0ull);
+
+		static bool ExportChromeTrace(const std::string& filepath);
+
+	private:
+		inline static std::atomic<bool> s_Enabled = false;
+	};
+
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const char* name, const char* category)
+			: m_Name(name)
+			, m_Category(category)
+		{
+			if (Profiler::IsEnabled())
+			{
+				Profiler::BeginZone();
+				m_Start = Profiler::GetTimestamp();
+				m_Active = true;
+			}
+		}
+
+		~ProfileScope()
+		{
+			if (m_Active)
+			{
+				Profiler::EndZone(m_Name, m_Category, m_Start);
+			}
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		const char* m_Name;
+		const char* m_Category;
+		uint64 m_Start = 0;
+		bool m_Active = false;
+	};
+} // namespace Neon
+
+#if NEO_ENABLE_PROFILING
+	#define NEO_PROFILE_CONCAT_INTERNAL(a, b) a##b
+	#define NEO_PROFILE_CONCAT(a, b) NEO_PROFILE_CONCAT_INTERNAL(a, b)
+	#define NEO_PROFILE_SCOPE_CATEGORY(name, category)                                                                           \
+		::Neon::ProfileScope NEO_PROFILE_CONCAT(profileScope, __LINE__)(name, category)
+	#define NEO_PROFILE_SCOPE(name) NEO_PROFILE_SCOPE_CATEGORY(name, "Default")
+	#define NEO_PROFILE_FUNCTION() NEO_PROFILE_SCOPE(__FUNCTION__)
+#else
+	#define NEO_PROFILE_SCOPE_CATEGORY(name, category)
+	#define NEO_PROFILE_SCOPE(name)
+	#define NEO_PROFILE_FUNCTION()
+#endif
@@ -1,27 +1,113 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
+
 // Intrinsic ref counting system
 namespace Neon
 {
+	class RefCounted;
+
+	// Shared between an object and its weak references, outlives the object until the last weak reference is gone
+	struct WeakRefControlBlock
+	{
+		std::mutex Mutex;
+		RefCounted* Object = nullptr;
+		// One reference held by the object itself plus one per weak reference
+		std::atomic<uint32> RefCount = 1;
+
+		void Release()
+		{
+			if (RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				delete this;
+			}
+		}
+	};
+
 	class RefCounted
 	{
 	public:
+		RefCounted() = default;
+		// Reference counts belong to the instance, copies start unreferenced
+		RefCounted(const RefCounted&)
+		{
+		}
+		RefCounted& operator=(const RefCounted&)
+		{
+			return *this;
+		}
+
+		~RefCounted()
+		{
+			WeakRefControlBlock* controlBlock = m_WeakControlBlock.load(std::memory_order_acquire);
+			if (controlBlock)
+			{
+				{
+					std::lock_guard<std::mutex> lock(controlBlock->Mutex);
+					controlBlock->Object = nullptr;
+				}
+				controlBlock->Release();
+			}
+		}
+
 		void AddRef() const
 		{
-			m_RefCount++;
+			m_RefCount.fetch_add(1, std::memory_order_relaxed);
 		}
-		void RemoveRef() const
+		// Returns true when the last reference was removed
+		bool RemoveRef() const
 		{
-			m_RefCount--;
+			return m_RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1;
 		}
 
 		uint32 GetRefCount() const
 		{
-			return m_RefCount;
+			return m_RefCount.load(std::memory_order_relaxed);
+		}
+
+	private:
+		// Only succeeds while the object still has strong references
+		bool TryAddRef() const
+		{
+			uint32 refCount = m_RefCount.load(std::memory_order_relaxed);
+			while (refCount != 0)
+			{
+				if (m_RefCount.compare_exchange_weak(refCount, refCount + 1, std::memory_order_relaxed))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		WeakRefControlBlock* AcquireWeakControlBlock() const
+		{
+			WeakRefControlBlock* controlBlock = m_WeakControlBlock.load(std::memory_order_acquire);
+			if (!controlBlock)
+			{
+				WeakRefControlBlock* newControlBlock = new WeakRefControlBlock();
+				newControlBlock->Object = const_cast<RefCounted*>(this);
+				if (m_WeakControlBlock.compare_exchange_strong(controlBlock, newControlBlock, std::memory_order_acq_rel))
+				{
+					controlBlock = newControlBlock;
+				}
+				else
+				{
+					delete newControlBlock;
+				}
+			}
+
+			controlBlock->RefCount.fetch_add(1, std::memory_order_relaxed);
+			return controlBlock;
 		}
 
+		template<class T>
+		friend class WeakRef;
+
 	private:
-		mutable uint32 m_RefCount = 0;
+		mutable std::atomic<uint32> m_RefCount = 0;
+		mutable std::atomic<WeakRefControlBlock*> m_WeakControlBlock = nullptr;
 	};
 
 	template<typename T>
@@ -53,7 +139,7 @@ namespace Neon
 		}
 
 		template<typename T2>
-		SharedRef(SharedRef<T2>&& other)
+		SharedRef(SharedRef<T2>&& other) noexcept
 		{
 			m_Ptr = (T*)other.m_Ptr;
 			other.m_Ptr = nullptr;
@@ -70,6 +156,12 @@ namespace Neon
 			AddRef();
 		}
 
+		SharedRef(SharedRef<T>&& other) noexcept
+			: m_Ptr(other.m_Ptr)
+		{
+			other.m_Ptr = nullptr;
+		}
+
 		SharedRef& operator=(std::nullptr_t)
 		{
 			RemoveRef();
@@ -96,8 +188,20 @@ namespace Neon
 			return *this;
 		}
 
+		SharedRef& operator=(SharedRef<T>&& other) noexcept
+		{
+			if (this != &other)
+			{
+				RemoveRef();
+
+				m_Ptr = other.m_Ptr;
+				other.m_Ptr = nullptr;
+			}
+			return *this;
+		}
+
 		template<typename T2>
-		SharedRef& operator=(SharedRef<T2>&& other)
+		SharedRef& operator=(SharedRef<T2>&& other) noexcept
 		{
 			RemoveRef();
 
@@ -149,15 +253,25 @@ namespace Neon
 
 		void Reset(T* ptr = nullptr)
 		{
+			if (ptr)
+			{
+				ptr->AddRef();
+			}
 			RemoveRef();
 			m_Ptr = ptr;
 		}
 
 		template<typename T2>
-		SharedRef<T2> As() const
+		SharedRef<T2> As() const&
 		{
 			return SharedRef<T2>(*this);
 		}
+		// Casting a temporary hands its reference over instead of taking a new one
+		template<typename T2>
+		SharedRef<T2> As() &&
+		{
+			return SharedRef<T2>(std::move(*this));
+		}
 
 		template<typename... Args>
 		static SharedRef<T> Create(Args&&... args)
@@ -167,28 +281,146 @@ namespace Neon
 
 		template<class T2>
 		friend class SharedRef;
+		template<class T2>
+		friend class WeakRef;
 
 	private:
+		struct AdoptTag
+		{
+		};
+		// Takes over a reference which was already added
+		SharedRef(T* ptr, AdoptTag)
+			: m_Ptr(ptr)
+		{
+		}
+
 		void AddRef() const
 		{
 			if (m_Ptr)
 			{
 				m_Ptr->AddRef();
-			}	
+			}
 		}
 
 		void RemoveRef() const
 		{
-			if (m_Ptr)
+			if (m_Ptr && m_Ptr->RemoveRef())
 			{
-				m_Ptr->RemoveRef();
-				if (m_Ptr->GetRefCount() == 0)
-				{
-					delete m_Ptr;
-				}
+				delete m_Ptr;
 			}
 		}
 
 		T* m_Ptr;
 	};
+
+	// Non owning reference which can be promoted to a SharedRef as long as the object is alive, e.g. for caches
+	template<typename T>
+	class WeakRef
+	{
+	public:
+		WeakRef() = default;
+
+		WeakRef(std::nullptr_t)
+		{
+		}
+
+		template<typename T2>
+		WeakRef(const SharedRef<T2>& ref)
+		{
+			static_assert(std::is_base_of<T, T2>::value || std::is_base_of<T2, T>::value, "Incompatible reference types!");
+			if (ref)
+			{
+				m_Ptr = (T*)ref.m_Ptr;
+				m_ControlBlock = ref.m_Ptr->AcquireWeakControlBlock();
+			}
+		}
+
+		WeakRef(const WeakRef<T>& other)
+			: m_Ptr(other.m_Ptr)
+			, m_ControlBlock(other.m_ControlBlock)
+		{
+			if (m_ControlBlock)
+			{
+				m_ControlBlock->RefCount.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		WeakRef(WeakRef<T>&& other) noexcept
+			: m_Ptr(other.m_Ptr)
+			, m_ControlBlock(other.m_ControlBlock)
+		{
+			other.m_Ptr = nullptr;
+			other.m_ControlBlock = nullptr;
+		}
+
+		~WeakRef()
+		{
+			Reset();
+		}
+
+		WeakRef& operator=(const WeakRef<T>& other)
+		{
+			if (this != &other)
+			{
+				WeakRef<T> copy(other);
+				std::swap(m_Ptr, copy.m_Ptr);
+				std::swap(m_ControlBlock, copy.m_ControlBlock);
+			}
+			return *this;
+		}
+
+		WeakRef& operator=(WeakRef<T>&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Reset();
+				m_Ptr = other.m_Ptr;
+				m_ControlBlock = other.m_ControlBlock;
+				other.m_Ptr = nullptr;
+				other.m_ControlBlock = nullptr;
+			}
+			return *this;
+		}
+
+		// Returns a null reference once the object was destroyed
+		SharedRef<T> Lock() const
+		{
+			if (!m_ControlBlock)
+			{
+				return nullptr;
+			}
+
+			std::lock_guard<std::mutex> lock(m_ControlBlock->Mutex);
+			if (m_ControlBlock->Object && m_Ptr->TryAddRef())
+			{
+				return SharedRef<T>(m_Ptr, typename SharedRef<T>::AdoptTag());
+			}
+			return nullptr;
+		}
+
+		bool IsValid() const
+		{
+			if (!m_ControlBlock)
+			{
+				return false;
+			}
+
+			std::lock_guard<std::mutex> lock(m_ControlBlock->Mutex);
+			return m_ControlBlock->Object && m_Ptr->GetRefCount() > 0;
+		}
+
+		void Reset()
+		{
+			if (m_ControlBlock)
+			{
+				m_ControlBlock->Release();
+			}
+			m_Ptr = nullptr;
+			m_ControlBlock = nullptr;
+		}
+
+	private:
+		T* m_Ptr = nullptr;
+		WeakRefControlBlock* m_ControlBlock = nullptr;
+	};
 } // namespace Neon
@@ -0,0 +1,156 @@
+#include "neopch.h"
+
+#include "Neon/Core/Profiler.h"
+#include "Neon/Core/TaskGraph.h"
+
+namespace Neon
+{
+	TaskHandle TaskGraph::AddTask(const std::string& name, std::function<void()> function,
+								  std::initializer_list<TaskHandle> dependencies /*= {}*/,
+								  TaskAffinity affinity /*= TaskAffinity::Any*/)
+	{
+		TaskHandle handle = static_cast<TaskHandle>(m_Tasks.size());
+
+		auto& task = m_Tasks.emplace_back(CreateUnique<Task>());
+		task->Name = name;
+		task->ProfileName = Profiler::InternString(name);
+		task->Function = std::move(function);
+		task->Affinity = affinity;
+
+		for (TaskHandle dependency : dependencies)
+		{
+			AddDependency(handle, dependency);
+		}
+
+		return handle;
+	}
+
+	void TaskGraph::AddDependency(TaskHandle task, TaskHandle dependsOn)
+	{
+		NEO_CORE_ASSERT(task < m_Tasks.size() && dependsOn < m_Tasks.size(), "Invalid task handle!");
+		NEO_CORE_ASSERT(task != dependsOn, "Task can not depend on itself!");
+
+		m_Tasks[dependsOn]->Dependents.push_back(task);
+		m_Tasks[task]->DependencyCount++;
+	}
+
+	void TaskGraph::Execute()
+	{
+		NEO_CORE_ASSERT(IsAcyclic(), "Task graph contains a cycle!");
+		NEO_CORE_ASSERT(JobSystem::GetCurrentThreadIndex() == 0, "Task graph has to be executed from the main thread!");
+
+		m_FinishedTasks = 0;
+		for (auto& task : m_Tasks)
+		{
+			task->RemainingDependencies = task->DependencyCount;
+		}
+
+		for (TaskHandle handle = 0; handle < m_Tasks.size(); handle++)
+		{
+			if (m_Tasks[handle]->DependencyCount == 0)
+			{
+				Schedule(handle);
+			}
+		}
+
+		const uint32 taskCount = GetTaskCount();
+		while (m_FinishedTasks.load(std::memory_order_acquire) < taskCount)
+		{
+			TaskHandle mainThreadTask = ~0u;
+			{
+				std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+				if (!m_MainThreadTasks.empty())
+				{
+					mainThreadTask = m_MainThreadTasks.front();
+					m_MainThreadTasks.erase(m_MainThreadTasks.begin());
+				}
+			}
+
+			if (mainThreadTask != ~0u)
+			{
+				RunTask(mainThreadTask);
+			}
+			else if (!JobSystem::RunPendingJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// Jobs decrement the counter after the task is marked as finished
+		JobSystem::Wait(m_Counter);
+	}
+
+	void TaskGraph::Reset()
+	{
+		NEO_CORE_ASSERT(m_Counter.IsDone(), "Resetting task graph while it is executing!");
+
+		m_Tasks.clear();
+		m_MainThreadTasks.clear();
+		m_FinishedTasks = 0;
+	}
+
+	void TaskGraph::Schedule(TaskHandle task)
+	{
+		if (m_Tasks[task]->Affinity == TaskAffinity::MainThread)
+		{
+			std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+			m_MainThreadTasks.push_back(task);
+		}
+		else
+		{
+			JobSystem::Run([this, task]() { RunTask(task); }, &m_Counter);
+		}
+	}
+
+	void TaskGraph::RunTask(TaskHandle task)
+	{
+		Task& currentTask = *m_Tasks[task];
+		if (currentTask.Function)
+		{
+			NEO_PROFILE_SCOPE_CATEGORY(currentTask.ProfileName, "Task");
+			currentTask.Function();
+		}
+
+		for (TaskHandle dependent : currentTask.Dependents)
+		{
+			if (m_Tasks[dependent]->RemainingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				Schedule(dependent);
+			}
+		}
+
+		m_FinishedTasks.fetch_add(1, std::memory_order_release);
+	}
+
+	bool TaskGraph::IsAcyclic() const
+	{
+		std::vector<uint32> dependencyCounts(m_Tasks.size());
+		std::vector<TaskHandle> readyTasks;
+		for (TaskHandle handle = 0; handle < m_Tasks.size(); handle++)
+		{
+			dependencyCounts[handle] = m_Tasks[handle]->DependencyCount;
+			if (dependencyCounts[handle] == 0)
+			{
+				readyTasks.push_back(handle);
+			}
+		}
+
+		uint32 visitedCount = 0;
+		while (!readyTasks.empty())
+		{
+			TaskHandle handle = readyTasks.back();
+			readyTasks.pop_back();
+			visitedCount++;
+
+			for (TaskHandle dependent : m_Tasks[handle]->Dependents)
+			{
+				if (--dependencyCounts[dependent] == 0)
+				{
+					readyTasks.push_back(dependent);
+				}
+			}
+		}
+
+		return visitedCount == m_Tasks.size();
+	}
+} // namespace Neon
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Neon/Core/JobSystem.h"
+
+#include <mutex>
+
+namespace Neon
+{
+	using TaskHandle = uint32;
+
+	enum class TaskAffinity
+	{
+		Any,
+		MainThread
+	};
+
+	// Directed acyclic graph of tasks executed on the job system. Tasks start as soon as all of their dependencies
+	// are finished, main thread tasks are only picked up by the thread calling Execute.
+	class TaskGraph
+	{
+	public:
+		TaskGraph() = default;
+		TaskGraph(const TaskGraph&) = delete;
+		TaskGraph& operator=(const TaskGraph&) = delete;
+
+		TaskHandle AddTask(const std::string& name, std::function<void()> function,
+						   std::initializer_list<TaskHandle> dependencies = {}, TaskAffinity affinity = TaskAffinity::Any);
+		void AddDependency(TaskHandle task, TaskHandle dependsOn);
+
+		void Execute();
+		void Reset();
+
+		uint32 GetTaskCount() const
+		{
+			return static_cast<uint32>(m_Tasks.size());
+		}
+		const std::string& GetTaskName(TaskHandle task) const
+		{
+			return m_Tasks[task]->Name;
+		}
+
+	private:
+		struct Task
+		{
+			std::string Name;
+			const char* ProfileName = nullptr;
+			std::function<void()> Function;
+			TaskAffinity Affinity = TaskAffinity::Any;
+
+			std::vector<TaskHandle> Dependents;
+			uint32 DependencyCount = 0;
+			std::atomic<uint32> RemainingDependencies = 0;
+		};
+
+		void Schedule(TaskHandle task);
+		void RunTask(TaskHandle task);
+		bool IsAcyclic() const;
+
+	private:
+		std::vector<UniqueRef<Task>> m_Tasks;
+
+		std::mutex m_MainThreadMutex;
+		std::vector<TaskHandle> m_MainThreadTasks;
+
+		JobCounter m_Counter;
+		std::atomic<uint32> m_FinishedTasks = 0;
+	};
+
+	// Tasks added by the application every frame, layers can hook their own tasks in between
+	struct FrameTasks
+	{
+		TaskHandle PhysicsSimulate;
+		TaskHandle BeginFrame;
+		TaskHandle LayerUpdate;
+		TaskHandle LayerTick;
+		TaskHandle PhysicsSync;
+		TaskHandle RenderGui;
+		TaskHandle Present;
+	};
+} // namespace Neon
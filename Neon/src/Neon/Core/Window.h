@@ -13,6 +13,7 @@ namespace Neon
 		std::string Title;
 		uint32 Width;
 		uint32 Height;
+		bool Headless = false;
 
 		WindowProps(const std::string& title = "Neon Engine", uint32 width = 1920, uint32 height = 1080)
 			: Title(title)
@@ -0,0 +1,109 @@
+#include "neopch.h"
+
+#include "Neon/Editor/Panels/ProfilerPanel.h"
+#include "Neon/Renderer/RendererContext.h"
+
+#include <imgui/imgui.h>
+
+namespace Neon
+{
+	static ImU32 GetCategoryColor(const char* category)
+	{
+		// FNV-1a over category name so the same category always gets the same color
+		uint32 hash = 2166136261u;
+		for (const char* c = category ? category : ""; *c; c++)
+		{
+			hash = (hash ^ static_cast<uint8>(*c)) * 16777619u;
+		}
+		return IM_COL32(80 + (hash & 0x7F), 80 + ((hash >> 8) & 0x7F), 80 + ((hash >> 16) & 0x7F), 255);
+	}
+
+	void ProfilerPanel::Render() const
+	{
+		ImGui::Begin("Profiler");
+
+		bool enabled = Profiler::IsEnabled();
+		if (ImGui::Checkbox("Enabled##ProfilerEnabled", &enabled))
+		{
+			Profiler::SetEnabled(enabled);
+		}
+		ImGui::SameLine();
+		ImGui::Checkbox("Pause##ProfilerPause", &m_Paused);
+		ImGui::SameLine();
+		if (ImGui::Button("Export Chrome Trace"))
+		{
+			Profiler::ExportChromeTrace("profiler_trace.json");
+		}
+
+		if (!m_Paused && enabled)
+		{
+			// GPU zones are resolved once their frame slot gets reused, show a frame for which they are already in
+			uint32 framesAgo = RendererContext::Get()->GetTargetMaxFramesInFlight() - 1;
+			m_FrameStart = Profiler::GetLastFrameStart(framesAgo);
+			m_FrameEnd = Profiler::GetLastFrameEnd(framesAgo);
+			m_Tracks = Profiler::CaptureZones(m_FrameStart, m_FrameEnd);
+		}
+
+		if (m_FrameEnd <= m_FrameStart)
+		{
+			ImGui::End();
+			return;
+		}
+
+		const double frameDuration = static_cast<double>(m_FrameEnd - m_FrameStart);
+		ImGui::Text("Frame: %.3fms", frameDuration / 1e6);
+
+		const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+		const float width = ImGui::GetContentRegionAvail().x;
+		ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+		for (const ProfileTrack& track : m_Tracks)
+		{
+			if (track.Zones.empty())
+			{
+				continue;
+			}
+
+			ImGui::TextUnformatted(track.Name.c_str());
+
+			uint32 maxDepth = 0;
+			for (const ProfileZone& zone : track.Zones)
+			{
+				maxDepth = std::max(maxDepth, zone.Depth);
+			}
+
+			ImVec2 origin = ImGui::GetCursorScreenPos();
+			ImGui::Dummy(ImVec2(width, rowHeight * (maxDepth + 1)));
+
+			for (const ProfileZone& zone : track.Zones)
+			{
+				uint64 zoneStart = std::max(zone.Start, m_FrameStart);
+				uint64 zoneEnd = std::min(zone.End, m_FrameEnd);
+
+				ImVec2 min(origin.x + static_cast<float>((zoneStart - m_FrameStart) / frameDuration) * width,
+						   origin.y + zone.Depth * rowHeight);
+				ImVec2 max(origin.x + static_cast<float>((zoneEnd - m_FrameStart) / frameDuration) * width,
+						   min.y + rowHeight - 1.f);
+				if (max.x - min.x < 1.f)
+				{
+					max.x = min.x + 1.f;
+				}
+
+				drawList->AddRectFilled(min, max, GetCategoryColor(zone.Category));
+				drawList->PushClipRect(min, max, true);
+				drawList->AddText(ImVec2(min.x + 2.f, min.y), IM_COL32_WHITE, zone.Name);
+				drawList->PopClipRect();
+
+				if (ImGui::IsMouseHoveringRect(min, max))
+				{
+					ImGui::BeginTooltip();
+					ImGui::Text("%s [%s]", zone.Name, zone.Category);
+					ImGui::Text("%.3fms", (zone.End - zone.Start) / 1e6);
+					ImGui::EndTooltip();
+				}
+			}
+		}
+
+		ImGui::End();
+	}
+} // namespace Neon
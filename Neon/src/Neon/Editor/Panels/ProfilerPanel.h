@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Neon/Core/Profiler.h"
+#include "Neon/Editor/Panels/Panel.h"
+
+namespace Neon
+{
+	class ProfilerPanel : public Panel
+	{
+	public:
+		void Render() const override;
+
+	private:
+		mutable bool m_Paused = false;
+		mutable uint64 m_FrameStart = 0;
+		mutable uint64 m_FrameEnd = 0;
+		mutable std::vector<ProfileTrack> m_Tracks;
+	};
+} // namespace Neon
@@ -0,0 +1,46 @@
+#include "neopch.h"
+
+#include "Neon/Math/Bounds.h"
+
+namespace Neon
+{
+	void BoundingBox::Expand(const glm::vec3& point)
+	{
+		Min = glm::min(Min, point);
+		Max = glm::max(Max, point);
+	}
+
+	void BoundingBox::Expand(const BoundingBox& other)
+	{
+		Min = glm::min(Min, other.Min);
+		Max = glm::max(Max, other.Max);
+	}
+
+	BoundingBox BoundingBox::Transform(const glm::mat4& transform) const
+	{
+		if (!IsValid())
+		{
+			return *this;
+		}
+
+		// Extents are projected onto the absolute axes of the transform
+		glm::vec3 center = glm::vec3(transform * glm::vec4(GetCenter(), 1.f));
+		glm::vec3 extents = GetExtents();
+		glm::vec3 newExtents = glm::abs(glm::vec3(transform[0])) * extents.x + glm::abs(glm::vec3(transform[1])) * extents.y +
+							   glm::abs(glm::vec3(transform[2])) * extents.z;
+
+		BoundingBox result;
+		result.Min = center - newExtents;
+		result.Max = center + newExtents;
+		return result;
+	}
+
+	glm::vec4 TransformBoundingSphere(const glm::vec4& sphere, const glm::mat4& transform)
+	{
+		glm::vec3 center = glm::vec3(transform * glm::vec4(glm::vec3(sphere), 1.f));
+		float scale = glm::sqrt(glm::max(glm::max(glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])),
+												  glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1]))),
+										 glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2]))));
+		return glm::vec4(center, sphere.w * scale);
+	}
+} // namespace Neon
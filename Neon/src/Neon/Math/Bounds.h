@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <limits>
+
+namespace Neon
+{
+	// Axis aligned, starts out empty and grows with every point added
+	struct BoundingBox
+	{
+		glm::vec3 Min = glm::vec3(std::numeric_limits<float>::max());
+		glm::vec3 Max = glm::vec3(std::numeric_limits<float>::lowest());
+
+		void Expand(const glm::vec3& point);
+		void Expand(const BoundingBox& other);
+
+		bool IsValid() const
+		{
+			return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z;
+		}
+
+		glm::vec3 GetCenter() const
+		{
+			return (Min + Max) * 0.5f;
+		}
+		glm::vec3 GetExtents() const
+		{
+			return (Max - Min) * 0.5f;
+		}
+
+		// Smallest axis aligned box around the transformed box
+		BoundingBox Transform(const glm::mat4& transform) const;
+	};
+
+	// Sphere is given as center and radius in w, the radius grows with the largest axis scale of the transform
+	glm::vec4 TransformBoundingSphere(const glm::vec4& sphere, const glm::mat4& transform);
+} // namespace Neon
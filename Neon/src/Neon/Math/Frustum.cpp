@@ -0,0 +1,156 @@
+#include "neopch.h"
+
+#include "Neon/Math/Frustum.h"
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+	#define NEO_TARGET_AVX
+#else
+	#define NEO_TARGET_AVX __attribute__((target("avx")))
+#endif
+
+namespace Neon
+{
+	static bool IsAVXSupported()
+	{
+		static const bool s_Supported = []() {
+#ifdef _MSC_VER
+			int32 info[4];
+			__cpuid(info, 1);
+			const uint32 ecx = static_cast<uint32>(info[2]);
+
+			const bool osxsave = ecx & BIT(27);
+			const bool avx = ecx & BIT(28);
+			if (!(osxsave && avx))
+			{
+				return false;
+			}
+
+			// OS has to save YMM registers on context switch
+			return (_xgetbv(0) & 0x6) == 0x6;
+#else
+			return __builtin_cpu_supports("avx");
+#endif
+		}();
+		return s_Supported;
+	}
+
+	Frustum Frustum::FromMatrix(const glm::mat4& viewProjection)
+	{
+		// glm is column major, rows of the matrix are gathered from every column
+		const glm::mat4 rows = glm::transpose(viewProjection);
+
+		Frustum frustum;
+		frustum.Planes[0] = rows[3] + rows[0];
+		frustum.Planes[1] = rows[3] - rows[0];
+		frustum.Planes[2] = rows[3] + rows[1];
+		frustum.Planes[3] = rows[3] - rows[1];
+		frustum.Planes[4] = rows[3] + rows[2];
+		frustum.Planes[5] = rows[3] - rows[2];
+
+		for (glm::vec4& plane : frustum.Planes)
+		{
+			plane /= glm::length(glm::vec3(plane));
+		}
+
+		return frustum;
+	}
+
+	bool Frustum::IntersectsSphere(const glm::vec3& center, float radius) const
+	{
+		for (const glm::vec4& plane : Planes)
+		{
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Frustum::IntersectsBox(const glm::vec3& center, const glm::vec3& extents) const
+	{
+		for (const glm::vec4& plane : Planes)
+		{
+			// Extents projected onto the plane normal
+			float radius = glm::dot(glm::abs(glm::vec3(plane)), extents);
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static void CullBoxesScalar(const Frustum& frustum, const BoxArrays& boxes, uint32 begin, uint32 end, uint8* outVisible)
+	{
+		for (uint32 i = begin; i < end; i++)
+		{
+			glm::vec3 center = {boxes.CenterX[i], boxes.CenterY[i], boxes.CenterZ[i]};
+			glm::vec3 extents = {boxes.ExtentX[i], boxes.ExtentY[i], boxes.ExtentZ[i]};
+			outVisible[i] = frustum.IntersectsBox(center, extents) ? 1 : 0;
+		}
+	}
+
+	NEO_TARGET_AVX static void CullBoxesAVX(const Frustum& frustum, const BoxArrays& boxes, uint32 count, uint8* outVisible)
+	{
+		__m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+		__m256 absPlaneX[6], absPlaneY[6], absPlaneZ[6];
+		for (uint32 p = 0; p < 6; p++)
+		{
+			const glm::vec4& plane = frustum.Planes[p];
+			planeX[p] = _mm256_set1_ps(plane.x);
+			planeY[p] = _mm256_set1_ps(plane.y);
+			planeZ[p] = _mm256_set1_ps(plane.z);
+			planeW[p] = _mm256_set1_ps(plane.w);
+			absPlaneX[p] = _mm256_set1_ps(glm::abs(plane.x));
+			absPlaneY[p] = _mm256_set1_ps(glm::abs(plane.y));
+			absPlaneZ[p] = _mm256_set1_ps(glm::abs(plane.z));
+		}
+		const __m256 zero = _mm256_setzero_ps();
+
+		uint32 i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 centerX = _mm256_loadu_ps(boxes.CenterX + i);
+			__m256 centerY = _mm256_loadu_ps(boxes.CenterY + i);
+			__m256 centerZ = _mm256_loadu_ps(boxes.CenterZ + i);
+			__m256 extentX = _mm256_loadu_ps(boxes.ExtentX + i);
+			__m256 extentY = _mm256_loadu_ps(boxes.ExtentY + i);
+			__m256 extentZ = _mm256_loadu_ps(boxes.ExtentZ + i);
+
+			// A box is outside once it is fully behind any plane
+			__m256 outside = zero;
+			for (uint32 p = 0; p < 6; p++)
+			{
+				__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(centerX, planeX[p]), _mm256_mul_ps(centerY, planeY[p])),
+												_mm256_add_ps(_mm256_mul_ps(centerZ, planeZ[p]), planeW[p]));
+				__m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(extentX, absPlaneX[p]), _mm256_mul_ps(extentY, absPlaneY[p])),
+											  _mm256_mul_ps(extentZ, absPlaneZ[p]));
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_LT_OQ));
+			}
+
+			int outsideMask = _mm256_movemask_ps(outside);
+			for (uint32 k = 0; k < 8; k++)
+			{
+				outVisible[i + k] = (outsideMask >> k) & 1 ? 0 : 1;
+			}
+		}
+
+		CullBoxesScalar(frustum, boxes, i, count, outVisible);
+	}
+
+	void Frustum::CullBoxes(const BoxArrays& boxes, uint32 count, uint8* outVisible) const
+	{
+		if (IsAVXSupported())
+		{
+			CullBoxesAVX(*this, boxes, count, outVisible);
+		}
+		else
+		{
+			CullBoxesScalar(*this, boxes, 0, count, outVisible);
+		}
+	}
+} // namespace Neon
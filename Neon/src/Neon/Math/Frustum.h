@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Neon/Math/Bounds.h"
+
+#include <glm/glm.hpp>
+
+namespace Neon
+{
+	// Boxes as centers and half extents, one array per component
+	struct BoxArrays
+	{
+		const float* CenterX;
+		const float* CenterY;
+		const float* CenterZ;
+		const float* ExtentX;
+		const float* ExtentY;
+		const float* ExtentZ;
+	};
+
+	// Normalized planes facing inwards, a point is inside when dot(plane.xyz, point) + plane.w >= 0 for all of them
+	struct Frustum
+	{
+		// Left, right, bottom, top, near, far
+		glm::vec4 Planes[6];
+
+		// Assumes a [-1, 1] clip depth range, which keeps the near plane conservative for [0, 1] as well
+		static Frustum FromMatrix(const glm::mat4& viewProjection);
+
+		bool IntersectsSphere(const glm::vec3& center, float radius) const;
+		bool IntersectsBox(const glm::vec3& center, const glm::vec3& extents) const;
+
+		// Writes 1 for every box which is at least partly inside and 0 otherwise. Tests 8 boxes at a time with AVX.
+		void CullBoxes(const BoxArrays& boxes, uint32 count, uint8* outVisible) const;
+	};
+} // namespace Neon
@@ -0,0 +1,140 @@
+#include "neopch.h"
+
+#include "Neon/Core/JobSystem.h"
+#include "Neon/Math/HalfFloat.h"
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+	#define NEO_TARGET_F16C
+#else
+	#define NEO_TARGET_F16C __attribute__((target("avx,f16c")))
+#endif
+
+namespace Neon
+{
+	static constexpr uint16 c_HalfOne = 0x3C00;
+
+	uint16 FloatToHalf(float value)
+	{
+		uint32 bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		uint32 sign = bits & 0x80000000u;
+		bits ^= sign;
+
+		uint32 result;
+		if (bits >= 0x47800000u)
+		{
+			// Overflow, infinity or NaN
+			result = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+		}
+		else if (bits < 0x38800000u)
+		{
+			// Denormal or zero, let float addition do the rounding
+			constexpr uint32 denormMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+			float magic;
+			memcpy(&magic, &denormMagic, sizeof(magic));
+
+			float f;
+			memcpy(&f, &bits, sizeof(f));
+			f += magic;
+			memcpy(&result, &f, sizeof(result));
+			result -= denormMagic;
+		}
+		else
+		{
+			uint32 mantissaOdd = (bits >> 13) & 1;
+			bits += ((15u - 127u) << 23) + 0xFFFu;
+			bits += mantissaOdd;
+			result = bits >> 13;
+		}
+
+		return static_cast<uint16>(result | (sign >> 16));
+	}
+
+	bool IsF16CSupported()
+	{
+		static const bool s_Supported = []() {
+#ifdef _MSC_VER
+			int32 info[4];
+			__cpuid(info, 1);
+			const uint32 ecx = static_cast<uint32>(info[2]);
+
+			const bool osxsave = ecx & BIT(27);
+			const bool avx = ecx & BIT(28);
+			const bool f16c = ecx & BIT(29);
+			if (!(osxsave && avx && f16c))
+			{
+				return false;
+			}
+
+			// OS has to save YMM registers on context switch
+			return (_xgetbv(0) & 0x6) == 0x6;
+#else
+			return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+#endif
+		}();
+		return s_Supported;
+	}
+
+	static void ConvertRGB32FToRGBA16FScalar(const float* src, uint16* dest, size_t pixelCount)
+	{
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			dest[4 * i] = FloatToHalf(src[3 * i]);
+			dest[4 * i + 1] = FloatToHalf(src[3 * i + 1]);
+			dest[4 * i + 2] = FloatToHalf(src[3 * i + 2]);
+			dest[4 * i + 3] = c_HalfOne;
+		}
+	}
+
+	NEO_TARGET_F16C static void ConvertRGB32FToRGBA16FF16C(const float* src, uint16* dest, size_t pixelCount)
+	{
+		const __m128 one = _mm_set1_ps(1.f);
+
+		// 4 pixels per iteration: three loads of r0g0b0r1 g1b1r2g2 b2r3g3b3 reshuffled to four RGBA vectors
+		size_t i = 0;
+		for (; i + 4 <= pixelCount; i += 4)
+		{
+			const float* s = src + 3 * i;
+			__m128 a = _mm_loadu_ps(s);
+			__m128 b = _mm_loadu_ps(s + 4);
+			__m128 c = _mm_loadu_ps(s + 8);
+
+			__m128 p0 = _mm_blend_ps(a, one, 0x8);
+			__m128 t1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 3, 3));
+			__m128 p1 = _mm_blend_ps(_mm_shuffle_ps(t1, t1, _MM_SHUFFLE(3, 3, 2, 1)), one, 0x8);
+			__m128 p2 = _mm_blend_ps(_mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 0, 3, 2)), one, 0x8);
+			__m128 p3 = _mm_blend_ps(_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 2, 1)), one, 0x8);
+
+			__m128i h01 = _mm256_cvtps_ph(_mm256_set_m128(p1, p0), _MM_FROUND_TO_NEAREST_INT);
+			__m128i h23 = _mm256_cvtps_ph(_mm256_set_m128(p3, p2), _MM_FROUND_TO_NEAREST_INT);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 4 * i), h01);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 4 * i + 8), h23);
+		}
+
+		ConvertRGB32FToRGBA16FScalar(src + 3 * i, dest + 4 * i, pixelCount - i);
+	}
+
+	void ConvertRGB32FToRGBA16F(const float* src, uint16* dest, size_t pixelCount)
+	{
+		if (IsF16CSupported())
+		{
+			ConvertRGB32FToRGBA16FF16C(src, dest, pixelCount);
+		}
+		else
+		{
+			ConvertRGB32FToRGBA16FScalar(src, dest, pixelCount);
+		}
+	}
+
+	void ConvertRGB32FToRGBA16FParallel(const float* src, uint16* dest, uint32 width, uint32 height)
+	{
+		JobSystem::ParallelFor(height, [src, dest, width](uint32 beginRow, uint32 endRow) {
+			size_t offset = static_cast<size_t>(width) * beginRow;
+			ConvertRGB32FToRGBA16F(src + 3 * offset, dest + 4 * offset, static_cast<size_t>(width) * (endRow - beginRow));
+		});
+	}
+} // namespace Neon
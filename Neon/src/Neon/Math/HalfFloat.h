@@ -0,0 +1,15 @@
+#pragma once
+
+namespace Neon
+{
+	// Round to nearest even, same as F16C hardware conversion
+	uint16 FloatToHalf(float value);
+
+	bool IsF16CSupported();
+
+	// Converts pixelCount tightly packed RGB32F pixels to RGBA16F with alpha set to 1
+	void ConvertRGB32FToRGBA16F(const float* src, uint16* dest, size_t pixelCount);
+
+	// Same as above but rows are split across job system workers
+	void ConvertRGB32FToRGBA16FParallel(const float* src, uint16* dest, uint32 width, uint32 height);
+} // namespace Neon
@@ -0,0 +1,89 @@
+#include "neopch.h"
+
+#include "Neon/Core/JobSystem.h"
+#include "Neon/Physics/PhysX/PhysXCpuDispatcher.h"
+
+#include <task/PxTask.h>
+
+namespace Neon
+{
+	PhysXCpuDispatcher::PhysXCpuDispatcher(uint32 workerCount /*= 0*/)
+		: m_WorkerCount(workerCount == 0 ? JobSystem::GetThreadCount()
+										 : std::min(workerCount, JobSystem::GetThreadCount()))
+	{
+		NEO_CORE_INFO("PhysX dispatcher using {0} of {1} job system threads", m_WorkerCount, JobSystem::GetThreadCount());
+	}
+
+	PhysXCpuDispatcher::~PhysXCpuDispatcher()
+	{
+		while (m_ActiveWorkers.load(std::memory_order_acquire) > 0)
+		{
+			if (!JobSystem::RunPendingJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void PhysXCpuDispatcher::submitTask(physx::PxBaseTask& task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_TaskMutex);
+			m_Tasks.push(&task);
+			m_PendingTasks.fetch_add(1, std::memory_order_acq_rel);
+		}
+
+		TryStartWorker();
+	}
+
+	uint32_t PhysXCpuDispatcher::getWorkerCount() const
+	{
+		return m_WorkerCount;
+	}
+
+	void PhysXCpuDispatcher::TryStartWorker()
+	{
+		uint32 activeWorkers = m_ActiveWorkers.load(std::memory_order_relaxed);
+		while (activeWorkers < m_WorkerCount)
+		{
+			if (m_ActiveWorkers.compare_exchange_weak(activeWorkers, activeWorkers + 1, std::memory_order_acq_rel))
+			{
+				JobSystem::Run([this]() { WorkerJob(); });
+				return;
+			}
+		}
+	}
+
+	void PhysXCpuDispatcher::WorkerJob()
+	{
+		while (true)
+		{
+			physx::PxBaseTask* task = nullptr;
+			{
+				std::lock_guard<std::mutex> lock(m_TaskMutex);
+				if (!m_Tasks.empty())
+				{
+					task = m_Tasks.front();
+					m_Tasks.pop();
+					m_PendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+				}
+			}
+
+			if (!task)
+			{
+				break;
+			}
+
+			task->run();
+			task->release();
+		}
+
+		m_ActiveWorkers.fetch_sub(1, std::memory_order_acq_rel);
+
+		// Task could have been submitted after the queue was seen empty but before this worker retired
+		if (m_PendingTasks.load(std::memory_order_acquire) > 0)
+		{
+			TryStartWorker();
+		}
+	}
+} // namespace Neon
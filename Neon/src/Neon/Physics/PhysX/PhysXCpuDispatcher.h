@@ -0,0 +1,33 @@
+#pragma once
+
+#include <task/PxCpuDispatcher.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace Neon
+{
+	// Runs PhysX tasks as job system jobs so physics shares cores with the rest of the engine.
+	// At most workerCount PhysX tasks run at the same time.
+	class PhysXCpuDispatcher : public physx::PxCpuDispatcher
+	{
+	public:
+		explicit PhysXCpuDispatcher(uint32 workerCount = 0);
+		virtual ~PhysXCpuDispatcher() override;
+
+		virtual void submitTask(physx::PxBaseTask& task) override;
+		virtual uint32_t getWorkerCount() const override;
+
+	private:
+		void TryStartWorker();
+		void WorkerJob();
+
+	private:
+		uint32 m_WorkerCount;
+
+		std::mutex m_TaskMutex;
+		std::queue<physx::PxBaseTask*> m_Tasks;
+		std::atomic<uint32> m_PendingTasks = 0;
+		std::atomic<uint32> m_ActiveWorkers = 0;
+	};
+} // namespace Neon
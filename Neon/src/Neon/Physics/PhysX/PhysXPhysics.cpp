@@ -1,5 +1,6 @@
 #include "neopch.h"
 
+#include "Neon/Physics/PhysX/PhysXCpuDispatcher.h"
 #include "Neon/Physics/PhysX/PhysXErrorCallback.h"
 #include "Neon/Physics/PhysX/PhysXPhysics.h"
 #include "Neon/Physics/PhysX/PhysXPhysicsDebugger.h"
@@ -15,7 +16,7 @@ namespace Neon
 	static physx::PxPhysics* s_Physics = nullptr;
 	static physx::PxCooking* s_CookingFactory = nullptr;
 	static physx::PxOverlapHit s_OverlapBuffer[OVERLAP_MAX_COLLIDERS];
-	static physx::PxDefaultCpuDispatcher* s_CPUDispatcher = nullptr;
+	static PhysXCpuDispatcher* s_CPUDispatcher = nullptr;
 
 	physx::PxFoundation& PhysXPhysics::GetFoundation()
 	{
@@ -24,7 +25,7 @@ namespace Neon
 		return *s_Foundation;
 	}
 
-	physx::PxDefaultCpuDispatcher* PhysXPhysics::GetCPUDispatcher() const
+	physx::PxCpuDispatcher* PhysXPhysics::GetCPUDispatcher() const
 	{
 		NEO_CORE_ASSERT(s_CPUDispatcher);
 
@@ -61,7 +62,7 @@ namespace Neon
 		bool extentionsLoaded = PxInitExtensions(*s_Physics, PhysXPhysicsDebugger::GetDebugger());
 		NEO_CORE_ASSERT(extentionsLoaded, "Failed to initialize PhysX Extensions.");
 
-		s_CPUDispatcher = physx::PxDefaultCpuDispatcherCreate(1);
+		s_CPUDispatcher = new PhysXCpuDispatcher(s_Settings.WorkerThreads);
 
 		s_CookingFactory = PxCreateCooking(PX_PHYSICS_VERSION, *s_Foundation, s_Physics->getTolerancesScale());
 		NEO_CORE_ASSERT(s_CookingFactory, "PxCreatePhysics Failed!");
@@ -69,8 +70,7 @@ namespace Neon
 
 	void PhysXPhysics::InternalShutdown()
 	{
-		if (s_CPUDispatcher)
-			s_CPUDispatcher->release();
+		delete s_CPUDispatcher;
 		s_CPUDispatcher = nullptr;
 
 		if (s_CookingFactory)
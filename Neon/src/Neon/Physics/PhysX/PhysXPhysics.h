@@ -36,7 +36,7 @@ namespace Neon
 		PhysXPhysics() = default;
 		virtual ~PhysXPhysics() = default;
 
-		physx::PxDefaultCpuDispatcher* GetCPUDispatcher() const;
+		physx::PxCpuDispatcher* GetCPUDispatcher() const;
 
 	protected:
 		virtual void* InternalGetPhysicsSDK() const override;
@@ -1,5 +1,7 @@
 #include "neopch.h"
 
+#include "Neon/Core/Profiler.h"
+#include "Neon/Core/JobSystem.h"
 #include "Neon/Physics/PhysX/PhysXContactListener.h"
 #include "Neon/Physics/PhysX/PhysXPhysics.h"
 #include "Neon/Physics/PhysX/PhysXPhysicsBody.h"
@@ -39,24 +41,60 @@ namespace Neon
 	{
 	}
 
-	void PhysXPhysicsScene::Tick(float deltaSeconds)
+	void PhysXPhysicsScene::BeginSimulation(float deltaSeconds)
 	{
+		NEO_PROFILE_SCOPE_CATEGORY("PhysXPhysicsScene::BeginSimulation", "Physics");
+
+		NEO_CORE_ASSERT(!m_Simulating, "Simulation already running!");
+
 		uint32 substepCount = GetNumSubsteps(deltaSeconds);
 
 		if (substepCount <= 0)
 		{
-			return;			
+			return;
 		}
 
-		for (uint32_t i = 0; i < substepCount; i++)
+		// Only the last substep overlaps with the rest of the frame
+		for (uint32_t i = 0; i < substepCount - 1; i++)
 		{
 			m_PhysXScene->simulate(m_SubStepSize);
-			m_PhysXScene->fetchResults(true);
+			FetchResults();
+		}
+
+		m_PhysXScene->simulate(m_SubStepSize);
+		m_Simulating = true;
+	}
+
+	void PhysXPhysicsScene::EndSimulation()
+	{
+		if (!m_Simulating)
+		{
+			return;
 		}
+
+		FetchResults();
+		m_Simulating = false;
+	}
+
+	void PhysXPhysicsScene::FetchResults()
+	{
+		NEO_PROFILE_SCOPE_CATEGORY("PhysXPhysicsScene::FetchResults", "Physics");
+
+		// PhysX tasks run on the job system, help out instead of blocking the thread
+		while (!m_PhysXScene->checkResults(false))
+		{
+			if (!JobSystem::RunPendingJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+		m_PhysXScene->fetchResults(true);
 	}
 
 	void PhysXPhysicsScene::Destroy()
 	{
+		EndSimulation();
+
 		for (auto& physicsBody : m_PhysicsBodies)
 		{
 			m_PhysXScene->removeActor(*static_cast<physx::PxRigidActor*>(physicsBody->GetHandle()));
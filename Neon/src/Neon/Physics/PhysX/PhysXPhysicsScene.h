@@ -12,7 +12,8 @@ namespace Neon
 		PhysXPhysicsScene(const PhysicsSettings& settings);
 		virtual ~PhysXPhysicsScene() override;
 
-		virtual void Tick(float deltaSeconds) override;
+		virtual void BeginSimulation(float deltaSeconds) override;
+		virtual void EndSimulation() override;
 
 		virtual void Destroy() override;
 
@@ -23,7 +24,12 @@ namespace Neon
 		virtual SharedRef<PhysicsBody> AddPhysicsBody(PhysicsBodyType physicsBodyType, const Transform& transform, const SharedRef<PhysicsMaterial>& material) override;
 		virtual void RemovePhysicsBody(SharedRef<PhysicsBody>& physicsBody) override;
 
+	private:
+		void FetchResults();
+
 	private:
 		physx::PxScene* m_PhysXScene;
+
+		bool m_Simulating = false;
 	};
 } // namespace Neon
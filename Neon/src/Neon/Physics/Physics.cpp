@@ -26,6 +26,20 @@ namespace Neon
 		s_Scene->Tick(deltaSeconds);
 	}
 
+	void Physics::BeginSimulation(float deltaSeconds)
+	{
+		NEO_CORE_ASSERT(s_Scene);
+
+		s_Scene->BeginSimulation(deltaSeconds);
+	}
+
+	void Physics::EndSimulation()
+	{
+		NEO_CORE_ASSERT(s_Scene);
+
+		s_Scene->EndSimulation();
+	}
+
 	void Physics::Initialize()
 	{
 		NEO_CORE_ASSERT(!s_Physics, "Physics already initialized!");
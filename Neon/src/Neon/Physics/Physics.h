@@ -24,6 +24,8 @@ namespace Neon
 		static void* GetPhysicsSDK();
 
 		static void TickPhysics(float deltaSeconds);
+		static void BeginSimulation(float deltaSeconds);
+		static void EndSimulation();
 
 		static void Initialize();
 		static void Shutdown();
@@ -33,6 +35,12 @@ namespace Neon
 
 		static PhysicsEngine GetCurrentEngine();
 
+		// Changes are picked up by the next Initialize and CreateScene
+		static PhysicsSettings& GetSettings()
+		{
+			return s_Settings;
+		}
+
 		static SharedRef<PhysicsScene> GetCurrentScene();
 
 		static const SharedRef<Physics> Get();
@@ -16,6 +16,12 @@ namespace Neon
 	{
 	}
 
+	void PhysicsScene::Tick(float deltaSeconds)
+	{
+		BeginSimulation(deltaSeconds);
+		EndSimulation();
+	}
+
 	uint32 PhysicsScene::GetNumSubsteps(float deltaSeconds)
 	{
 		if (m_Accumulator > m_SubStepSize)
@@ -12,7 +12,11 @@ namespace Neon
 		PhysicsScene(const PhysicsSettings& settings);
 		virtual ~PhysicsScene();
 
-		virtual void Tick(float deltaSeconds) = 0;
+		void Tick(float deltaSeconds);
+
+		// Starts simulating the last substep of this frame without waiting for it, results are applied in EndSimulation
+		virtual void BeginSimulation(float deltaSeconds) = 0;
+		virtual void EndSimulation() = 0;
 
 		uint32 GetNumSubsteps(float deltaSeconds);
 
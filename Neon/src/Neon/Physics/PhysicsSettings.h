@@ -35,6 +35,7 @@ namespace Neon
 		FrictionType FrictionModel = FrictionType::Patch;
 		uint32_t SolverIterations = 6;
 		uint32_t SolverVelocityIterations = 1;
+		uint32_t WorkerThreads = 0; // 0 uses every job system thread
 		bool DebugOnPlay = true;
 		DebugType DebugType = DebugType::LiveDebug;
 	};
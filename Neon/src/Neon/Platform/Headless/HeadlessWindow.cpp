@@ -0,0 +1,23 @@
+#include "neopch.h"
+
+#include "HeadlessWindow.h"
+
+namespace Neon
+{
+	HeadlessWindow::HeadlessWindow(const WindowProps& props)
+		: Window(props)
+	{
+		m_Data.VSync = false;
+		m_RendererContext = RendererContext::Create(nullptr);
+	}
+
+	void HeadlessWindow::Init()
+	{
+		m_RendererContext->Init();
+	}
+
+	void HeadlessWindow::SwapBuffers()
+	{
+		m_RendererContext->SwapBuffers();
+	}
+} // namespace Neon
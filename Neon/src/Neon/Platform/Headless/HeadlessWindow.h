@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Neon/Core/Window.h"
+
+namespace Neon
+{
+	// Window without an OS window, renderer context renders offscreen and paces frames by fences only
+	class HeadlessWindow : public Window
+	{
+	public:
+		HeadlessWindow(const WindowProps& props = WindowProps());
+		virtual ~HeadlessWindow() = default;
+
+		void Init() override;
+
+		void ProcessEvents() override
+		{
+		}
+		void SwapBuffers() override;
+
+		uint32_t GetWidth() const override
+		{
+			return m_Data.Width;
+		}
+		uint32_t GetHeight() const override
+		{
+			return m_Data.Height;
+		}
+
+		std::pair<uint32_t, uint32_t> GetSize() const override
+		{
+			return {m_Data.Width, m_Data.Height};
+		}
+		std::pair<float, float> GetWindowPos() const override
+		{
+			return {0.f, 0.f};
+		}
+
+		void SetEventCallback(const EventCallbackFn& callback) override
+		{
+			m_Data.EventCallback = callback;
+		}
+		void SetVSync(bool enabled) override
+		{
+			m_Data.VSync = enabled;
+		}
+		bool IsVSync() const override
+		{
+			return m_Data.VSync;
+		}
+
+		const std::string& GetTitle() const override
+		{
+			return m_Data.Title;
+		}
+		void SetTitle(const std::string& title) override
+		{
+			m_Data.Title = title;
+		}
+
+		void* GetHandle() const override
+		{
+			return nullptr;
+		}
+
+		SharedRef<RendererContext> GetRenderContext() override
+		{
+			return m_RendererContext;
+		}
+
+		void Maximize() override
+		{
+		}
+
+	private:
+		SharedRef<RendererContext> m_RendererContext;
+	};
+} // namespace Neon
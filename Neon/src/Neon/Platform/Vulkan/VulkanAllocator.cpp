@@ -3,27 +3,229 @@
 #include "VulkanAllocator.h"
 #include "VulkanContext.h"
 
+#include <mutex>
+
+#define VMA_IMPLEMENTATION
+#include <vk_mem_alloc.h>
+
 namespace Neon
 {
+	static constexpr uint32 c_PoolTypeCount = 3;
+	// Indexed by pool type, resources larger than half a block get dedicated memory instead of wasting the rest of it
+	static constexpr std::array<uint64, c_PoolTypeCount> c_PoolBlockSizes = {64ull * 1024 * 1024, 128ull * 1024 * 1024,
+																			  32ull * 1024 * 1024};
+
+	struct VulkanAllocatorTag
+	{
+		std::string Name;
+		uint64 Bytes = 0;
+		uint32 AllocationCount = 0;
+	};
+
+	struct VulkanAllocatorData
+	{
+		VmaAllocator Allocator = nullptr;
+		SharedRef<VulkanPhysicalDevice> PhysicalDevice;
+		vk::Device Device;
+
+		// Created on first use, indexed by pool type and memory type
+		std::mutex PoolsMutex;
+		std::array<std::array<VmaPool, VK_MAX_MEMORY_TYPES>, c_PoolTypeCount> Pools = {};
+
+		// Tag 0 collects allocations of untagged allocators
+		std::mutex TagsMutex;
+		std::vector<VulkanAllocatorTag> Tags = {{"Untagged"}};
+
+		// Held during defragmentation, so owners can not go away while their buffers are moved
+		std::mutex BufferOwnersMutex;
+		std::vector<VulkanBufferOwner*> BufferOwners;
+
+		uint32 FrameIndex = 0;
+	};
+	static VulkanAllocatorData s_Data;
+
+	static uint32 RegisterTag(const std::string& tag)
+	{
+		std::lock_guard<std::mutex> lock(s_Data.TagsMutex);
+		for (uint32 i = 0; i < s_Data.Tags.size(); i++)
+		{
+			if (s_Data.Tags[i].Name == tag)
+			{
+				return i;
+			}
+		}
+
+		s_Data.Tags.push_back({tag});
+		return static_cast<uint32>(s_Data.Tags.size() - 1);
+	}
+
+	static void UpdateTagUsage(uint32 tagIndex, uint64 bytes, bool allocated)
+	{
+		std::lock_guard<std::mutex> lock(s_Data.TagsMutex);
+		VulkanAllocatorTag& tag = s_Data.Tags[tagIndex];
+		if (allocated)
+		{
+			tag.Bytes += bytes;
+			tag.AllocationCount++;
+		}
+		else
+		{
+			tag.Bytes -= bytes;
+			tag.AllocationCount--;
+		}
+	}
+
+	static uint64 GetBlockSize(uint32 poolIndex, uint32 memoryTypeIndex)
+	{
+		const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+		vmaGetMemoryProperties(s_Data.Allocator, &memoryProperties);
+
+		// Small heaps, e.g. host visible device memory, would be used up by a few full size blocks
+		const uint64 heapSize = memoryProperties->memoryHeaps[memoryProperties->memoryTypes[memoryTypeIndex].heapIndex].size;
+		return std::min(c_PoolBlockSizes[poolIndex], heapSize / 8);
+	}
+
+	static VmaPool GetPool(uint32 poolIndex, uint32 memoryTypeIndex)
+	{
+		std::lock_guard<std::mutex> lock(s_Data.PoolsMutex);
+		VmaPool& pool = s_Data.Pools[poolIndex][memoryTypeIndex];
+		if (!pool)
+		{
+			VmaPoolCreateInfo poolCreateInfo = {};
+			poolCreateInfo.memoryTypeIndex = memoryTypeIndex;
+			poolCreateInfo.blockSize = GetBlockSize(poolIndex, memoryTypeIndex);
+			VK_CHECK_RESULT(static_cast<vk::Result>(vmaCreatePool(s_Data.Allocator, &poolCreateInfo, &pool)));
+		}
+		return pool;
+	}
+
+	VulkanAllocation::~VulkanAllocation()
+	{
+		Free();
+	}
+
+	VulkanAllocation::VulkanAllocation(VulkanAllocation&& other) noexcept
+		: m_Handle(other.m_Handle)
+		, m_Size(other.m_Size)
+		, m_TagIndex(other.m_TagIndex)
+		, m_MapCount(other.m_MapCount.load())
+	{
+		other.m_Handle = nullptr;
+		other.m_Size = 0;
+		other.m_MapCount = 0;
+	}
+
+	VulkanAllocation& VulkanAllocation::operator=(VulkanAllocation&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Free();
+
+			m_Handle = other.m_Handle;
+			m_Size = other.m_Size;
+			m_TagIndex = other.m_TagIndex;
+			m_MapCount = other.m_MapCount.load();
+			other.m_Handle = nullptr;
+			other.m_Size = 0;
+			other.m_MapCount = 0;
+		}
+		return *this;
+	}
+
+	void* VulkanAllocation::Map() const
+	{
+		NEO_CORE_ASSERT(m_Handle, "Mapping empty allocation!");
+
+		void* data = nullptr;
+		VK_CHECK_RESULT(static_cast<vk::Result>(vmaMapMemory(s_Data.Allocator, m_Handle, &data)));
+		m_MapCount++;
+		return data;
+	}
+
+	void VulkanAllocation::Unmap() const
+	{
+		NEO_CORE_ASSERT(m_MapCount > 0, "Allocation is not mapped!");
+
+		vmaUnmapMemory(s_Data.Allocator, m_Handle);
+		m_MapCount--;
+	}
+
+	void VulkanAllocation::Free()
+	{
+		if (!m_Handle)
+		{
+			return;
+		}
+
+		// Allocations which outlived the allocator are left to the driver
+		if (s_Data.Allocator)
+		{
+			for (; m_MapCount > 0; m_MapCount--)
+			{
+				vmaUnmapMemory(s_Data.Allocator, m_Handle);
+			}
+			vmaFreeMemory(s_Data.Allocator, m_Handle);
+			UpdateTagUsage(m_TagIndex, m_Size, false);
+		}
+
+		m_Handle = nullptr;
+		m_Size = 0;
+		m_MapCount = 0;
+	}
+
 	VulkanAllocator::VulkanAllocator(const SharedRef<VulkanDevice>& device, const std::string& tag)
 		: m_Tag(tag)
+		, m_TagIndex(RegisterTag(tag))
 		, m_Device(device)
 	{
 	}
 
-	void VulkanAllocator::Allocate(vk::MemoryRequirements requirements, vk::UniqueDeviceMemory& outDeviceMemory,
-								   vk::MemoryPropertyFlags flags /*= vk::MemoryPropertyFlagBits::eDeviceLocal*/)
+	void VulkanAllocator::AllocateMemory(PoolType poolType, const vk::MemoryRequirements& requirements,
+										 vk::MemoryPropertyFlags flags, VulkanAllocation& outAllocation) const
 	{
-		NEO_CORE_ASSERT(m_Device, "Device not initialized!");
+		NEO_CORE_ASSERT(s_Data.Allocator, "Allocator not initialized!");
 		NEO_CORE_TRACE("VulkanAllocator ({0}): allocating {1} bytes", m_Tag, requirements.size);
 
-		vk::MemoryAllocateInfo memAlloc = {};
-		memAlloc.allocationSize = requirements.size;
-		memAlloc.memoryTypeIndex = m_Device->GetPhysicalDevice()->GetMemoryTypeIndex(requirements.memoryTypeBits, flags);
-		outDeviceMemory = m_Device->GetHandle().allocateMemoryUnique(memAlloc);
+		const uint32 poolIndex = static_cast<uint32>(poolType);
+		const uint32 memoryTypeIndex = s_Data.PhysicalDevice->GetMemoryTypeIndex(requirements.memoryTypeBits, flags);
+
+		VmaAllocationCreateInfo allocationCreateInfo = {};
+		if (requirements.size > GetBlockSize(poolIndex, memoryTypeIndex) / 2)
+		{
+			allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+			allocationCreateInfo.memoryTypeBits = 1u << memoryTypeIndex;
+		}
+		else
+		{
+			allocationCreateInfo.pool = GetPool(poolIndex, memoryTypeIndex);
+		}
+
+		outAllocation.Free();
+
+		VkMemoryRequirements memoryRequirements = requirements;
+		VmaAllocation allocation = nullptr;
+		VK_CHECK_RESULT(static_cast<vk::Result>(
+			vmaAllocateMemory(s_Data.Allocator, &memoryRequirements, &allocationCreateInfo, &allocation, nullptr)));
+
+		outAllocation.m_Handle = allocation;
+		outAllocation.m_Size = requirements.size;
+		outAllocation.m_TagIndex = m_TagIndex;
+		UpdateTagUsage(m_TagIndex, requirements.size, true);
+	}
+
+	void VulkanAllocator::AllocateImage(vk::Image image, VulkanAllocation& outAllocation,
+										vk::MemoryPropertyFlags flags /*= vk::MemoryPropertyFlagBits::eDeviceLocal*/)
+	{
+		NEO_CORE_ASSERT(m_Device, "Device not initialized!");
+
+		vk::MemoryRequirements memRequirements = m_Device->GetHandle().getImageMemoryRequirements(image);
+		AllocateMemory(PoolType::Image, memRequirements, flags, outAllocation);
+
+		VK_CHECK_RESULT(
+			static_cast<vk::Result>(vmaBindImageMemory(s_Data.Allocator, outAllocation.m_Handle, static_cast<VkImage>(image))));
 	}
 
-	void VulkanAllocator::AllocateBuffer(VulkanBuffer& outBuffer, uint32 size, vk::BufferUsageFlagBits usage,
+	void VulkanAllocator::AllocateBuffer(VulkanBuffer& outBuffer, uint32 size, vk::BufferUsageFlags usage,
 										 vk::MemoryPropertyFlags memPropFlags)
 	{
 		NEO_CORE_ASSERT(m_Device, "Device not initialized!");
@@ -36,11 +238,15 @@ namespace Neon
 
 		outBuffer.Handle = m_Device->GetHandle().createBufferUnique(bufferInfo);
 
+		// Staging buffers are short lived, keeping them apart stops them from fragmenting the long lived buffer blocks
 		vk::MemoryRequirements memRequirements = m_Device->GetHandle().getBufferMemoryRequirements(outBuffer.Handle.get());
-		Allocate(memRequirements, outBuffer.Memory, memPropFlags);
+		AllocateMemory(usage == vk::BufferUsageFlagBits::eTransferSrc ? PoolType::Staging : PoolType::Buffer, memRequirements,
+					   memPropFlags, outBuffer.Memory);
 
-		m_Device->GetHandle().bindBufferMemory(outBuffer.Handle.get(), outBuffer.Memory.get(), 0);
+		VK_CHECK_RESULT(static_cast<vk::Result>(
+			vmaBindBufferMemory(s_Data.Allocator, outBuffer.Memory.m_Handle, static_cast<VkBuffer>(outBuffer.Handle.get()))));
 		outBuffer.Size = size;
+		outBuffer.Usage = usage;
 	}
 
 	void VulkanAllocator::UpdateBuffer(VulkanBuffer& outBuffer, const void* data, uint32 size /*= 0*/)
@@ -53,10 +259,241 @@ namespace Neon
 		}
 		NEO_CORE_ASSERT(size > 0, "Updating buffer size of 0!");
 
-		void* dest;
-		m_Device->GetHandle().mapMemory(outBuffer.Memory.get(), 0, size, vk::MemoryMapFlags(), &dest);
+		void* dest = outBuffer.Memory.Map();
 		memcpy(dest, data, size);
-		m_Device->GetHandle().unmapMemory(outBuffer.Memory.get());
+		outBuffer.Memory.Unmap();
+	}
+
+	void VulkanAllocator::ReadBuffer(const VulkanBuffer& buffer, void* outData, uint32 size /*= 0*/) const
+	{
+		NEO_CORE_ASSERT(m_Device, "Device not initialized!");
+		NEO_CORE_ASSERT(buffer.Size >= size, "Buffer out of range!");
+		if (size == 0)
+		{
+			size = buffer.Size;
+		}
+		NEO_CORE_ASSERT(size > 0, "Reading buffer size of 0!");
+
+		const void* src = buffer.Memory.Map();
+		memcpy(outData, src, size);
+		buffer.Memory.Unmap();
+	}
+
+	void VulkanAllocator::Init(vk::Instance instance, const SharedRef<VulkanPhysicalDevice>& physicalDevice, vk::Device device,
+							   bool memoryBudgetSupported)
+	{
+		NEO_CORE_ASSERT(!s_Data.Allocator, "Allocator already initialized!");
+
+		VmaAllocatorCreateInfo allocatorCreateInfo = {};
+		// Newest version the allocator knows about, nothing it relies on changed in 1.2
+		allocatorCreateInfo.vulkanApiVersion = VK_API_VERSION_1_1;
+		allocatorCreateInfo.instance = static_cast<VkInstance>(instance);
+		allocatorCreateInfo.physicalDevice = static_cast<VkPhysicalDevice>(physicalDevice->GetHandle());
+		allocatorCreateInfo.device = static_cast<VkDevice>(device);
+		if (memoryBudgetSupported)
+		{
+			allocatorCreateInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+		}
+		VK_CHECK_RESULT(static_cast<vk::Result>(vmaCreateAllocator(&allocatorCreateInfo, &s_Data.Allocator)));
+
+		s_Data.PhysicalDevice = physicalDevice;
+		s_Data.Device = device;
+	}
+
+	void VulkanAllocator::Shutdown()
+	{
+		if (!s_Data.Allocator)
+		{
+			return;
+		}
+
+		uint32 liveAllocationCount = 0;
+		{
+			std::lock_guard<std::mutex> lock(s_Data.TagsMutex);
+			for (const VulkanAllocatorTag& tag : s_Data.Tags)
+			{
+				if (tag.AllocationCount > 0)
+				{
+					NEO_CORE_WARN("VulkanAllocator ({0}): {1} allocations ({2} bytes) still alive at shutdown", tag.Name,
+								  tag.AllocationCount, tag.Bytes);
+					liveAllocationCount += tag.AllocationCount;
+				}
+			}
+		}
+
+		// Destroying blocks which still hold allocations asserts, those are left to the driver instead
+		if (liveAllocationCount == 0)
+		{
+			for (const auto& pools : s_Data.Pools)
+			{
+				for (VmaPool pool : pools)
+				{
+					if (pool)
+					{
+						vmaDestroyPool(s_Data.Allocator, pool);
+					}
+				}
+			}
+			vmaDestroyAllocator(s_Data.Allocator);
+		}
+
+		s_Data.Pools = {};
+		s_Data.Allocator = nullptr;
+		s_Data.PhysicalDevice = nullptr;
+		s_Data.Device = nullptr;
+	}
+
+	void VulkanAllocator::BeginFrame()
+	{
+		vmaSetCurrentFrameIndex(s_Data.Allocator, ++s_Data.FrameIndex);
+	}
+
+	void VulkanAllocator::RegisterBufferOwner(VulkanBufferOwner* owner)
+	{
+		std::lock_guard<std::mutex> lock(s_Data.BufferOwnersMutex);
+		s_Data.BufferOwners.push_back(owner);
+	}
+
+	void VulkanAllocator::UnregisterBufferOwner(VulkanBufferOwner* owner)
+	{
+		std::lock_guard<std::mutex> lock(s_Data.BufferOwnersMutex);
+		auto it = std::find(s_Data.BufferOwners.begin(), s_Data.BufferOwners.end(), owner);
+		NEO_CORE_ASSERT(it != s_Data.BufferOwners.end(), "Buffer owner is not registered!");
+		*it = s_Data.BufferOwners.back();
+		s_Data.BufferOwners.pop_back();
+	}
+
+	void VulkanAllocator::DefragmentBuffers()
+	{
+		NEO_CORE_ASSERT(s_Data.Allocator, "Allocator not initialized!");
+
+		std::lock_guard<std::mutex> lock(s_Data.BufferOwnersMutex);
+
+		// Owner of each buffer is remembered, so only owners of moved buffers get notified
+		std::vector<VulkanBuffer*> buffers;
+		std::vector<uint32> bufferOwners;
+		for (uint32 i = 0; i < s_Data.BufferOwners.size(); i++)
+		{
+			s_Data.BufferOwners[i]->GetMovableBuffers(buffers);
+			bufferOwners.resize(buffers.size(), i);
+		}
+
+		std::vector<VmaAllocation> allocations;
+		std::vector<uint32> allocationBuffers;
+		for (uint32 i = 0; i < buffers.size(); i++)
+		{
+			if (buffers[i]->Memory)
+			{
+				allocations.push_back(buffers[i]->Memory.m_Handle);
+				allocationBuffers.push_back(i);
+			}
+		}
+		if (allocations.empty())
+		{
+			return;
+		}
+
+		// Pending uploads copy into the current handles and frames in flight still read from them
+		VulkanContext::GetUploadManager().Flush();
+		VulkanContext::Get()->WaitIdle();
+
+		SharedRef<CommandBuffer> commandBuffer = VulkanContext::Get()->GetCommandBuffer(CommandBufferType::Graphics, true);
+
+		// Host visible memory is moved on the CPU, everything else by copies recorded into the command buffer. Dedicated
+		// allocations stay where they are.
+		std::vector<VkBool32> allocationsChanged(allocations.size(), VK_FALSE);
+		VmaDefragmentationInfo2 defragmentationInfo = {};
+		defragmentationInfo.allocationCount = static_cast<uint32>(allocations.size());
+		defragmentationInfo.pAllocations = allocations.data();
+		defragmentationInfo.pAllocationsChanged = allocationsChanged.data();
+		defragmentationInfo.maxCpuBytesToMove = VK_WHOLE_SIZE;
+		defragmentationInfo.maxCpuAllocationsToMove = UINT32_MAX;
+		defragmentationInfo.maxGpuBytesToMove = VK_WHOLE_SIZE;
+		defragmentationInfo.maxGpuAllocationsToMove = UINT32_MAX;
+		defragmentationInfo.commandBuffer = static_cast<VkCommandBuffer>(commandBuffer->GetHandle());
+
+		VmaDefragmentationStats defragmentationStats = {};
+		VmaDefragmentationContext defragmentationContext = nullptr;
+		VkResult result =
+			vmaDefragmentationBegin(s_Data.Allocator, &defragmentationInfo, &defragmentationStats, &defragmentationContext);
+		NEO_CORE_ASSERT(result >= VK_SUCCESS, "Defragmentation failed!");
+
+		// Copies have to be finished before the moves are committed
+		VulkanContext::Get()->SubmitCommandBuffer(commandBuffer);
+		vmaDefragmentationEnd(s_Data.Allocator, defragmentationContext);
+
+		std::vector<bool> ownersChanged(s_Data.BufferOwners.size(), false);
+		for (uint32 i = 0; i < allocations.size(); i++)
+		{
+			if (!allocationsChanged[i])
+			{
+				continue;
+			}
+
+			// Old handle is still bound to the memory the buffer was moved out of, nothing uses it with the device idle
+			VulkanBuffer& buffer = *buffers[allocationBuffers[i]];
+			vk::BufferCreateInfo bufferInfo{};
+			bufferInfo.size = buffer.Size;
+			bufferInfo.usage = buffer.Usage;
+			bufferInfo.sharingMode = vk::SharingMode::eExclusive;
+
+			buffer.Handle = s_Data.Device.createBufferUnique(bufferInfo);
+			VK_CHECK_RESULT(static_cast<vk::Result>(
+				vmaBindBufferMemory(s_Data.Allocator, buffer.Memory.m_Handle, static_cast<VkBuffer>(buffer.Handle.get()))));
+
+			ownersChanged[bufferOwners[allocationBuffers[i]]] = true;
+		}
+
+		for (uint32 i = 0; i < s_Data.BufferOwners.size(); i++)
+		{
+			if (ownersChanged[i])
+			{
+				s_Data.BufferOwners[i]->OnBuffersMoved();
+			}
+		}
+
+		NEO_CORE_INFO("VulkanAllocator: defragmentation moved {0} of {1} buffers ({2} bytes), freed {3} blocks",
+					  defragmentationStats.allocationsMoved, allocations.size(), defragmentationStats.bytesMoved,
+					  defragmentationStats.deviceMemoryBlocksFreed);
+	}
+
+	GpuMemoryStats VulkanAllocator::GetStats()
+	{
+		GpuMemoryStats stats;
+		if (!s_Data.Allocator)
+		{
+			return stats;
+		}
+
+		const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+		vmaGetMemoryProperties(s_Data.Allocator, &memoryProperties);
+		std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets = {};
+		vmaGetBudget(s_Data.Allocator, budgets.data());
+
+		for (uint32 i = 0; i < memoryProperties->memoryHeapCount; i++)
+		{
+			GpuMemoryHeap& heap = stats.Heaps.emplace_back();
+			heap.BlockBytes = budgets[i].blockBytes;
+			heap.AllocationBytes = budgets[i].allocationBytes;
+			heap.Usage = budgets[i].usage;
+			heap.Budget = budgets[i].budget;
+			heap.DeviceLocal = (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_Data.TagsMutex);
+			for (const VulkanAllocatorTag& tag : s_Data.Tags)
+			{
+				if (tag.AllocationCount > 0)
+				{
+					stats.Tags.push_back({tag.Name, tag.Bytes, tag.AllocationCount});
+				}
+			}
+		}
+		std::sort(stats.Tags.begin(), stats.Tags.end(),
+				  [](const GpuMemoryTag& a, const GpuMemoryTag& b) { return a.Bytes > b.Bytes; });
+
+		return stats;
 	}
 
 } // namespace Neon
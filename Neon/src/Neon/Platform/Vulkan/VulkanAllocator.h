@@ -1,28 +1,89 @@
 #pragma once
 
+#include "Neon/Renderer/RendererContext.h"
 #include "Vulkan.h"
 #include "VulkanDevice.h"
 
+#include <atomic>
 #include <string>
 
+struct VmaAllocation_T;
+
 namespace Neon
 {
+	// Range of a memory block handed out by the allocator, returned to its block on destruction
+	class VulkanAllocation
+	{
+	public:
+		VulkanAllocation() = default;
+		~VulkanAllocation();
+
+		VulkanAllocation(VulkanAllocation&& other) noexcept;
+		VulkanAllocation& operator=(VulkanAllocation&& other) noexcept;
+
+		VulkanAllocation(const VulkanAllocation&) = delete;
+		VulkanAllocation& operator=(const VulkanAllocation&) = delete;
+
+		// Mapping is reference counted per block, so several allocations of the same block can be mapped at once.
+		// Mappings still open are closed when the allocation is freed.
+		void* Map() const;
+		void Unmap() const;
+
+		void Free();
+
+		uint64 GetSize() const
+		{
+			return m_Size;
+		}
+
+		explicit operator bool() const
+		{
+			return m_Handle != nullptr;
+		}
+
+	private:
+		VmaAllocation_T* m_Handle = nullptr;
+		uint64 m_Size = 0;
+		uint32 m_TagIndex = 0;
+		// Shared buffers are mapped and unmapped from several recording threads
+		mutable std::atomic<uint32> m_MapCount = 0;
+
+		friend class VulkanAllocator;
+	};
+
 	struct VulkanBuffer
 	{
 		uint32 Size;
+		// Kept to recreate the buffer once defragmentation moved its memory
+		vk::BufferUsageFlags Usage;
 		vk::UniqueBuffer Handle;
-		vk::UniqueDeviceMemory Memory;
+		VulkanAllocation Memory;
 	};
 
-	struct VulkanImage
+	// Owner of buffers defragmentation is allowed to move, registered with the allocator for as long as the buffers live
+	class VulkanBufferOwner
+	{
+	public:
+		virtual ~VulkanBufferOwner() = default;
+
+		virtual void GetMovableBuffers(std::vector<VulkanBuffer*>& outBuffers) = 0;
+		// Some of the buffers got new handles bound to their new memory. Whatever was taken from the old ones, like descriptors
+		// or mapped pointers, has to be refreshed. The device is idle meanwhile.
+		virtual void OnBuffersMoved() = 0;
+	};
+
+	// Reference counted, so work recorded later (e.g. by the upload manager) can keep an image alive past its texture
+	struct VulkanImage : public RefCounted
 	{
 		uint32 Width;
 		uint32 Height;
 		vk::Format Format;
 		vk::UniqueImage Handle;
-		vk::UniqueDeviceMemory DeviceMemory;
+		VulkanAllocation Memory;
 	};
 
+	// Sub-allocates buffers and images from large memory blocks. Buffers, images and staging buffers get separate pools
+	// per memory type, resources too large for a pool block get dedicated memory. Usage is tracked per allocator tag.
 	class VulkanAllocator
 	{
 	public:
@@ -30,16 +91,49 @@ namespace Neon
 		VulkanAllocator(const SharedRef<VulkanDevice>& device, const std::string& tag);
 		~VulkanAllocator() = default;
 
-		void Allocate(vk::MemoryRequirements requirements, vk::UniqueDeviceMemory& outDeviceMemory,
-					  vk::MemoryPropertyFlags flags = vk::MemoryPropertyFlagBits::eDeviceLocal);
+		// Allocates memory for the image and binds it
+		void AllocateImage(vk::Image image, VulkanAllocation& outAllocation,
+						   vk::MemoryPropertyFlags flags = vk::MemoryPropertyFlagBits::eDeviceLocal);
 
-		void AllocateBuffer(VulkanBuffer& outBuffer, uint32 size, vk::BufferUsageFlagBits usage,
+		// Transfer source only buffers are treated as staging buffers
+		void AllocateBuffer(VulkanBuffer& outBuffer, uint32 size, vk::BufferUsageFlags usage,
 							vk::MemoryPropertyFlags memPropFlags);
 
 		void UpdateBuffer(VulkanBuffer& outBuffer, const void* data, uint32 size = 0);
+		// Host visible buffers only, GPU writes have to be finished and made available to the host
+		void ReadBuffer(const VulkanBuffer& buffer, void* outData, uint32 size = 0) const;
+
+		// Called by the device, allocations have to be freed before shutdown
+		static void Init(vk::Instance instance, const SharedRef<VulkanPhysicalDevice>& physicalDevice, vk::Device device,
+						 bool memoryBudgetSupported);
+		static void Shutdown();
+
+		// Budgets are refreshed once per frame
+		static void BeginFrame();
+
+		static void RegisterBufferOwner(VulkanBufferOwner* owner);
+		static void UnregisterBufferOwner(VulkanBufferOwner* owner);
+
+		// Compacts the buffer pools by moving the buffers of registered owners, device local memory is copied on the GPU.
+		// Moved buffers are recreated on their new memory before their owners are notified. Waits for the device to be idle,
+		// so it has to be called between frames.
+		static void DefragmentBuffers();
+
+		static GpuMemoryStats GetStats();
+
+	private:
+		enum class PoolType
+		{
+			Buffer = 0,
+			Image,
+			Staging
+		};
+		void AllocateMemory(PoolType poolType, const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags flags,
+							VulkanAllocation& outAllocation) const;
 
 	private:
 		std::string m_Tag;
+		uint32 m_TagIndex = 0;
 		SharedRef<VulkanDevice> m_Device;
 	};
 } // namespace Neon
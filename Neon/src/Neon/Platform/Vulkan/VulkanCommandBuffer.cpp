@@ -1,27 +1,88 @@
 #include "neopch.h"
 
+#include "Neon/Core/FrameAllocator.h"
+#include "Neon/Core/Profiler.h"
 #include "Neon/Platform/Vulkan/VulkanContext.h"
 #include "Neon/Platform/Vulkan/VulkanPipeline.h"
+#include "Neon/Platform/Vulkan/VulkanRenderPass.h"
 #include "Neon/Platform/Vulkan/VulkanShader.h"
 #include "VulkanCommandBuffer.h"
 
 namespace Neon
 {
-	VulkanCommandBuffer::VulkanCommandBuffer(const SharedRef<CommandPool>& commandPool)
-		: CommandBuffer(commandPool)
+	static uint32 GetQueueFamilyIndex(CommandBufferType type)
+	{
+		const auto& physicalDevice = VulkanContext::GetDevice()->GetPhysicalDevice();
+		switch (type)
+		{
+			case CommandBufferType::Graphics:
+				return physicalDevice->GetGraphicsQueueIndex();
+			case CommandBufferType::Compute:
+				return physicalDevice->GetComputeQueueIndex();
+			case CommandBufferType::Transfer:
+				return physicalDevice->GetTransferQueueIndex();
+			default:
+				NEO_CORE_ERROR("Unknown command buffer type!");
+				return 0;
+		}
+	}
+
+	VulkanCommandBuffer::VulkanCommandBuffer(const SharedRef<CommandPool>& commandPool, bool secondary /*= false*/)
+		: CommandBuffer(commandPool, secondary)
 	{
 		vk::CommandBufferAllocateInfo cmdBufAllocateInfo = {};
 		cmdBufAllocateInfo.commandPool = (VkCommandPool)commandPool->GetHandle();
-		cmdBufAllocateInfo.level = vk::CommandBufferLevel::ePrimary;
+		cmdBufAllocateInfo.level = secondary ? vk::CommandBufferLevel::eSecondary : vk::CommandBufferLevel::ePrimary;
 		cmdBufAllocateInfo.commandBufferCount = 1;
 
 		m_Handle = std::move(VulkanContext::GetDevice()->GetHandle().allocateCommandBuffersUnique(cmdBufAllocateInfo)[0]);
+
+		// Queues without valid timestamp bits can not write timestamps at all
+		uint32 timestampValidBits = VulkanContext::GetDevice()
+										->GetPhysicalDevice()
+										->GetQueueFamilyProperties(GetQueueFamilyIndex(commandPool->GetType()))
+										.timestampValidBits;
+		// Secondary command buffers run inside render passes which are timed by their primary one
+		m_TimestampsSupported = timestampValidBits > 0 && !secondary;
+		m_TimestampMask = timestampValidBits >= 64 ? ~0ull : (1ull << timestampValidBits) - 1;
+
+		m_MultiDrawIndirectSupported = VulkanContext::GetDevice()->GetPhysicalDevice()->GetSupportedFeatures().multiDrawIndirect;
+		m_DrawIndirectCountSupported = VulkanContext::GetDevice()->IsDrawIndirectCountSupported();
 	}
 
 	void VulkanCommandBuffer::Begin() const
 	{
 		vk::CommandBufferBeginInfo beginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit};
 		m_Handle.get().begin(beginInfo);
+
+		ResetRecordingState();
+
+		m_TimestampNames.clear();
+		m_TimestampOpen = false;
+		if (m_TimestampQueryPool)
+		{
+			m_Handle.get().resetQueryPool(m_TimestampQueryPool.get(), 0, c_MaxTimestampQueries);
+		}
+	}
+
+	void VulkanCommandBuffer::BeginSecondary(const SharedRef<RenderPass>& renderPass) const
+	{
+		NEO_CORE_ASSERT(m_Secondary, "Primary command buffers can not continue a render pass!");
+
+		vk::CommandBufferInheritanceInfo inheritanceInfo = {};
+		inheritanceInfo.renderPass = (VkRenderPass)renderPass->GetHandle();
+		inheritanceInfo.subpass = 0;
+		inheritanceInfo.framebuffer = (VkFramebuffer)renderPass->GetTargetFramebuffer()->GetHandle();
+
+		vk::CommandBufferBeginInfo beginInfo{
+			vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inheritanceInfo};
+		m_Handle.get().begin(beginInfo);
+
+		ResetRecordingState();
+
+		// Dynamic state is not inherited from the primary command buffer
+		SetViewportAndScissor(renderPass->GetTargetFramebuffer()->GetSpecification().Width,
+							  renderPass->GetTargetFramebuffer()->GetSpecification().Height);
 	}
 
 	void VulkanCommandBuffer::End() const
@@ -49,29 +110,42 @@ namespace Neon
 				break;
 		}
 
+		vk::TimelineSemaphoreSubmitInfo timelineInfo = {};
+		timelineInfo.waitSemaphoreValueCount = static_cast<uint32>(m_WaitValues.size());
+		timelineInfo.pWaitSemaphoreValues = m_WaitValues.data();
+		timelineInfo.signalSemaphoreValueCount = static_cast<uint32>(m_SignalValues.size());
+		timelineInfo.pSignalSemaphoreValues = m_SignalValues.data();
+
 		vk::SubmitInfo submitInfo = {};
+		submitInfo.pNext = &timelineInfo;
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &m_Handle.get();
-		submitInfo.pWaitDstStageMask = &m_WaitStage;
+		submitInfo.pWaitDstStageMask = m_WaitStages.data();
 		submitInfo.pWaitSemaphores = m_WaitSemaphores.data();
 		submitInfo.waitSemaphoreCount = static_cast<uint32>(m_WaitSemaphores.size());
 		submitInfo.pSignalSemaphores = m_SignalSemaphores.data();
 		submitInfo.signalSemaphoreCount = static_cast<uint32>(m_SignalSemaphores.size());
 
-		queue.submit(submitInfo, m_Fence);
+		{
+			std::lock_guard<std::mutex> lock(device->GetQueueMutex());
+			m_SubmitTime = Profiler::GetTimestamp();
+			queue.submit(submitInfo, m_Fence);
+		}
 
 		m_WaitSemaphores.clear();
+		m_WaitStages.clear();
+		m_WaitValues.clear();
 		m_SignalSemaphores.clear();
-		m_WaitStage = {};
+		m_SignalValues.clear();
 		m_Fence = vk::Fence();
 	}
 
-	void VulkanCommandBuffer::BeginRenderPass(const SharedRef<RenderPass>& renderPass) const
+	void VulkanCommandBuffer::BeginRenderPass(const SharedRef<RenderPass>& renderPass, bool secondaryContents /*= false*/) const
 	{
 		uint32 width = renderPass->GetTargetFramebuffer()->GetSpecification().Width;
 		uint32 height = renderPass->GetTargetFramebuffer()->GetSpecification().Height;
 
-		std::vector<vk::ClearValue> clearValues;
+		FrameVector<vk::ClearValue> clearValues;
 		for (const auto& attachment : renderPass->GetSpecification().Attachments)
 		{
 			vk::ClearValue& clearValue = clearValues.emplace_back();
@@ -97,58 +171,180 @@ namespace Neon
 		renderPassBeginInfo.pClearValues = clearValues.data();
 		renderPassBeginInfo.framebuffer = (VkFramebuffer)renderPass->GetTargetFramebuffer()->GetHandle();
 
-		// Update viewport state
-		vk::Viewport sceneViewport = {};
-		sceneViewport.x = 0.f;
-		sceneViewport.y = 0.f;
-		sceneViewport.width = (float)width;
-		sceneViewport.height = (float)height;
-		sceneViewport.minDepth = 0.f;
-		sceneViewport.maxDepth = 1.f;
-
-		m_Handle.get().setViewport(0, 1, &sceneViewport);
+		SetViewportAndScissor(width, height);
 
-		// Update scissor state
-		vk::Rect2D sceneCcissor = {};
-		sceneCcissor.offset.x = 0;
-		sceneCcissor.offset.y = 0;
-		sceneCcissor.extent.width = width;
-		sceneCcissor.extent.height = height;
+		if (m_TimestampsSupported)
+		{
+			BeginTimestamp(renderPass.As<VulkanRenderPass>()->GetProfileName(), vk::PipelineStageFlagBits::eTopOfPipe);
+		}
 
-		m_Handle.get().setScissor(0, 1, &sceneCcissor);
+		m_Handle.get().beginRenderPass(renderPassBeginInfo, secondaryContents ? vk::SubpassContents::eSecondaryCommandBuffers
+																			 : vk::SubpassContents::eInline);
 
-		m_Handle.get().beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
+		ResetBoundState();
 	}
 
 	void VulkanCommandBuffer::EndRenderPass() const
 	{
 		m_Handle.get().endRenderPass();
+
+		EndTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe);
+	}
+
+	void VulkanCommandBuffer::ExecuteCommands(const SharedRef<CommandBuffer>* commandBuffers, uint32 count) const
+	{
+		FrameVector<vk::CommandBuffer> handles;
+		handles.reserve(count);
+		for (uint32 i = 0; i < count; i++)
+		{
+			NEO_CORE_ASSERT(commandBuffers[i]->IsSecondary(), "Only secondary command buffers can be executed!");
+			handles.push_back((VkCommandBuffer)commandBuffers[i]->GetHandle());
+			m_Stats.Add(commandBuffers[i]->GetStats());
+		}
+
+		m_Handle.get().executeCommands(count, handles.data());
+
+		// State bound by the secondary command buffers is undefined afterwards
+		ResetBoundState();
 	}
 
 	void VulkanCommandBuffer::BindVertexBuffer(const SharedRef<VertexBuffer>& vertexBuffer) const
 	{
-		m_Handle.get().bindVertexBuffers(0, {(VkBuffer)vertexBuffer->GetHandle()}, {0});
+		vk::Buffer buffer = (VkBuffer)vertexBuffer->GetHandle();
+		if (buffer == m_BoundVertexBuffer)
+		{
+			m_Stats.SkippedBinds++;
+			return;
+		}
+
+		m_Handle.get().bindVertexBuffers(0, {buffer}, {0});
+		m_BoundVertexBuffer = buffer;
+		m_Stats.VertexBufferBinds++;
 	}
 
 	void VulkanCommandBuffer::BindIndexBuffer(const SharedRef<IndexBuffer>& indexBuffer) const
 	{
-		m_Handle.get().bindIndexBuffer((VkBuffer)indexBuffer->GetHandle(), 0, vk::IndexType::eUint32);
+		vk::Buffer buffer = (VkBuffer)indexBuffer->GetHandle();
+		if (buffer == m_BoundIndexBuffer)
+		{
+			m_Stats.SkippedBinds++;
+			return;
+		}
+
+		m_Handle.get().bindIndexBuffer(buffer, 0, vk::IndexType::eUint32);
+		m_BoundIndexBuffer = buffer;
+		m_Stats.IndexBufferBinds++;
+	}
+
+	void VulkanCommandBuffer::BindInstanceData(const void* data, uint32 size) const
+	{
+		VulkanUniformBufferRing& ring = VulkanContext::GetUniformBufferRing();
+		uint32 offset;
+		if (!ring.Push(data, size, offset))
+		{
+			m_DrawDataDropped = true;
+			return;
+		}
+
+		m_Handle.get().bindVertexBuffers(1, {ring.GetBuffer()}, {static_cast<vk::DeviceSize>(offset)});
+		m_Stats.VertexBufferBinds++;
 	}
 
 	void VulkanCommandBuffer::BindPipeline(const SharedRef<Pipeline>& pipeline) const
 	{
 		SharedRef<VulkanShader> vulkanShader = pipeline->GetShader().As<VulkanShader>();
 
-		vulkanShader->PrepareDescriptorSet();
+		// Descriptor set contents changed, it has to be bound again even if the handle matches
+		if (vulkanShader->PrepareDescriptorSet())
+		{
+			m_BoundDescriptorSet = vk::DescriptorSet();
+		}
+
+		vk::PipelineBindPoint bindPoint = NeonToVulkanPipelineBindPoint(pipeline->GetBindPoint());
+		vk::Pipeline pipelineHandle = (VkPipeline)pipeline->GetHandle();
+		vk::PipelineLayout pipelineLayout = (VkPipelineLayout)pipeline->GetLayout();
+		vk::DescriptorSet descriptorSet = vulkanShader->GetDescriptorSet();
+		vk::DescriptorSet frameDescriptorSet;
+		if (vulkanShader->UsesFrameData())
+		{
+			const uint32 frameIndex = VulkanContext::Get()->GetCurrentFrameIndex();
+			frameDescriptorSet = VulkanContext::GetFrameDescriptors().GetDescriptorSet(frameIndex);
+		}
+
+		std::array<uint32, VulkanShader::c_MaxDynamicUniformBuffers> dynamicOffsets;
+		uint32 dynamicOffsetCount;
+		// Everything recorded up to the next pipeline bind is dropped instead of reading the uniforms of another draw
+		m_DrawDataDropped = !vulkanShader->PrepareDynamicOffsets(dynamicOffsets, dynamicOffsetCount);
+		if (m_DrawDataDropped)
+		{
+			return;
+		}
 
-		m_Handle.get().bindPipeline(NeonToVulkanPipelineBindPoint(pipeline->GetBindPoint()), (VkPipeline)pipeline->GetHandle());
-		m_Handle.get().bindDescriptorSets(NeonToVulkanPipelineBindPoint(pipeline->GetBindPoint()),
-										  (VkPipelineLayout)pipeline->GetLayout(), 0, 1, &vulkanShader->GetDescriptorSet(), 0,
-										  nullptr);
+		if (pipeline->GetBindPoint() == PipelineBindPoint::Compute)
+		{
+			if (m_TimestampsSupported)
+			{
+				m_DispatchName = vulkanShader->GetProfileName();
+			}
 
-		for (const auto& [name, pushConstant] : vulkanShader->m_PushConstants)
+			// Only graphics state is tracked
+			m_Handle.get().bindPipeline(bindPoint, pipelineHandle);
+			if (frameDescriptorSet)
+			{
+				m_Handle.get().bindDescriptorSets(bindPoint, pipelineLayout, VulkanShaderProgram::c_FrameDescriptorSet, 1,
+												  &frameDescriptorSet, 0, nullptr);
+				m_Stats.DescriptorSetBinds++;
+			}
+			m_Handle.get().bindDescriptorSets(bindPoint, pipelineLayout, VulkanShaderProgram::c_MaterialDescriptorSet, 1,
+											  &descriptorSet, dynamicOffsetCount, dynamicOffsets.data());
+			m_Stats.PipelineBinds++;
+			m_Stats.DescriptorSetBinds++;
+		}
+		else
 		{
-			m_Handle.get().pushConstants((VkPipelineLayout)pipeline->GetLayout(), pushConstant.ShaderStage, 0, pushConstant.Size,
+			if (pipelineHandle != m_BoundPipeline)
+			{
+				m_Handle.get().bindPipeline(bindPoint, pipelineHandle);
+				m_BoundPipeline = pipelineHandle;
+				m_Stats.PipelineBinds++;
+			}
+			else
+			{
+				m_Stats.SkippedBinds++;
+			}
+
+			// Every pipeline layout starts with the same frame set layout, so binding other pipelines or material sets
+			// leaves it bound
+			if (frameDescriptorSet && frameDescriptorSet != m_BoundFrameDescriptorSet)
+			{
+				m_Handle.get().bindDescriptorSets(bindPoint, pipelineLayout, VulkanShaderProgram::c_FrameDescriptorSet, 1,
+												  &frameDescriptorSet, 0, nullptr);
+				m_BoundFrameDescriptorSet = frameDescriptorSet;
+				m_Stats.DescriptorSetBinds++;
+			}
+
+			bool offsetsChanged = dynamicOffsetCount != m_BoundDynamicOffsetCount ||
+								  !std::equal(dynamicOffsets.begin(), dynamicOffsets.begin() + dynamicOffsetCount,
+											  m_BoundDynamicOffsets.begin());
+			if (descriptorSet != m_BoundDescriptorSet || offsetsChanged)
+			{
+				m_Handle.get().bindDescriptorSets(bindPoint, pipelineLayout, VulkanShaderProgram::c_MaterialDescriptorSet, 1,
+												  &descriptorSet, dynamicOffsetCount, dynamicOffsets.data());
+				m_BoundDescriptorSet = descriptorSet;
+				m_BoundDynamicOffsets = dynamicOffsets;
+				m_BoundDynamicOffsetCount = dynamicOffsetCount;
+				m_Stats.DescriptorSetBinds++;
+			}
+			else
+			{
+				m_Stats.SkippedBinds++;
+			}
+		}
+
+		// Push constant data can change between binds of the same pipeline, always record it
+		for (const VulkanShader::PushConstant& pushConstant : vulkanShader->m_PushConstants)
+		{
+			m_Handle.get().pushConstants(pipelineLayout, pushConstant.ShaderStage, 0, pushConstant.Size,
 										 pushConstant.Data.get());
 		}
 	}
@@ -156,22 +352,164 @@ namespace Neon
 	void VulkanCommandBuffer::DrawIndexed(uint32 indexCount, uint32 instanceCount, uint32 firstIndex, int32 vertexOffset,
 										  uint32 firstInstance) const
 	{
+		if (m_DrawDataDropped)
+		{
+			m_Stats.DroppedDraws++;
+			return;
+		}
+
 		m_Handle.get().drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+		m_Stats.DrawCalls++;
+		m_Stats.Instances += instanceCount;
+	}
+
+	void VulkanCommandBuffer::SetIndirectCommands(const DrawIndexedIndirectCommand* commands, uint32 count) const
+	{
+		static_assert(sizeof(DrawIndexedIndirectCommand) == sizeof(vk::DrawIndexedIndirectCommand));
+
+		VulkanUniformBufferRing& ring = VulkanContext::GetUniformBufferRing();
+		uint32 offset = 0;
+		m_IndirectCommandsDropped = !ring.Push(commands, count * sizeof(DrawIndexedIndirectCommand), offset);
+		m_IndirectOffset = offset;
+		m_IndirectBuffer = ring.GetBuffer();
+		m_IndirectCommands = commands;
+		m_IndirectCommandCount = count;
+	}
+
+	void VulkanCommandBuffer::DrawIndexedIndirect(uint32 firstCommand, uint32 drawCount) const
+	{
+		NEO_CORE_ASSERT(m_IndirectBuffer && firstCommand + drawCount <= m_IndirectCommandCount, "Indirect commands not set!");
+
+		if (m_DrawDataDropped || m_IndirectCommandsDropped)
+		{
+			m_Stats.DroppedDraws += drawCount;
+			return;
+		}
+
+		constexpr uint32 stride = sizeof(DrawIndexedIndirectCommand);
+		vk::DeviceSize offset = m_IndirectOffset + firstCommand * stride;
+		if (m_MultiDrawIndirectSupported)
+		{
+			m_Handle.get().drawIndexedIndirect(m_IndirectBuffer, offset, drawCount, stride);
+			m_Stats.DrawCalls++;
+		}
+		else
+		{
+			for (uint32 i = 0; i < drawCount; i++)
+			{
+				m_Handle.get().drawIndexedIndirect(m_IndirectBuffer, offset + i * stride, 1, stride);
+			}
+			m_Stats.DrawCalls += drawCount;
+		}
+
+		for (uint32 i = firstCommand; i < firstCommand + drawCount; i++)
+		{
+			m_Stats.Instances += m_IndirectCommands[i].InstanceCount;
+		}
+	}
+
+	void VulkanCommandBuffer::BindInstanceBuffer(const SharedRef<Shader>& shader, const ShaderParamHandle& storageBuffer,
+												 uint32 offset) const
+	{
+		vk::Buffer buffer = shader.As<VulkanShader>()->GetStorageBufferHandle(storageBuffer);
+		m_Handle.get().bindVertexBuffers(1, {buffer}, {offset});
+		m_Stats.VertexBufferBinds++;
+	}
+
+	void VulkanCommandBuffer::DrawIndexedIndirectCount(const SharedRef<Shader>& shader, const ShaderParamHandle& commandsBuffer,
+													   uint32 commandsOffset, const ShaderParamHandle& countBuffer,
+													   uint32 countOffset, uint32 maxDrawCount) const
+	{
+		if (m_DrawDataDropped)
+		{
+			m_Stats.DroppedDraws++;
+			return;
+		}
+
+		const SharedRef<VulkanShader> vulkanShader = shader.As<VulkanShader>();
+		vk::Buffer commands = vulkanShader->GetStorageBufferHandle(commandsBuffer);
+
+		// Instance counts are only known on the GPU and do not show up in the stats
+		constexpr uint32 stride = sizeof(DrawIndexedIndirectCommand);
+		if (m_DrawIndirectCountSupported)
+		{
+			m_Handle.get().drawIndexedIndirectCountKHR(commands, commandsOffset, vulkanShader->GetStorageBufferHandle(countBuffer),
+													   countOffset, maxDrawCount, stride);
+			m_Stats.DrawCalls++;
+		}
+		else if (m_MultiDrawIndirectSupported)
+		{
+			m_Handle.get().drawIndexedIndirect(commands, commandsOffset, maxDrawCount, stride);
+			m_Stats.DrawCalls++;
+		}
+		else
+		{
+			for (uint32 i = 0; i < maxDrawCount; i++)
+			{
+				m_Handle.get().drawIndexedIndirect(commands, commandsOffset + i * stride, 1, stride);
+			}
+			m_Stats.DrawCalls += maxDrawCount;
+		}
 	}
 
 	void VulkanCommandBuffer::Dispatch(uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ) const
 	{
+		if (m_DrawDataDropped)
+		{
+			m_Stats.DroppedDraws++;
+			return;
+		}
+
+		BeginTimestamp(m_DispatchName ? m_DispatchName : "Dispatch", vk::PipelineStageFlagBits::eTopOfPipe);
 		m_Handle.get().dispatch(groupCountX, groupCountY, groupCountZ);
+		EndTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe);
+	}
+
+	void VulkanCommandBuffer::ComputeToDrawBarrier() const
+	{
+		vk::MemoryBarrier memoryBarrier;
+		memoryBarrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+		memoryBarrier.dstAccessMask = vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eVertexAttributeRead |
+									  vk::AccessFlagBits::eHostRead;
+		m_Handle.get().pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+									   vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput |
+										   vk::PipelineStageFlagBits::eHost,
+									   vk::DependencyFlags(), 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+	}
+
+	void VulkanCommandBuffer::ComputeBarrier() const
+	{
+		vk::PipelineStageFlags srcStages = vk::PipelineStageFlagBits::eComputeShader;
+		vk::PipelineStageFlags dstStages = vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer;
+		vk::MemoryBarrier memoryBarrier;
+		memoryBarrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+		memoryBarrier.dstAccessMask =
+			vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eTransferRead;
+
+		// Compute queues do not support graphics stages
+		if (GetType() == CommandBufferType::Graphics)
+		{
+			srcStages |= vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader;
+			dstStages |= vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexShader |
+						 vk::PipelineStageFlagBits::eFragmentShader;
+			memoryBarrier.dstAccessMask |= vk::AccessFlagBits::eIndirectCommandRead;
+		}
+
+		m_Handle.get().pipelineBarrier(srcStages, dstStages, vk::DependencyFlags(), 1, &memoryBarrier, 0, nullptr, 0, nullptr);
 	}
 
-	void VulkanCommandBuffer::AddSignalSemaphore(vk::Semaphore signalSemaphore)
+	void VulkanCommandBuffer::AddSignalSemaphore(vk::Semaphore signalSemaphore, uint64 value /*= 0*/)
 	{
 		m_SignalSemaphores.push_back(signalSemaphore);
+		m_SignalValues.push_back(value);
 	}
 
-	void VulkanCommandBuffer::AddWaitSemaphore(vk::Semaphore waitSemaphore)
+	void VulkanCommandBuffer::AddWaitSemaphore(vk::Semaphore waitSemaphore, vk::PipelineStageFlags waitStage,
+											   uint64 value /*= 0*/)
 	{
 		m_WaitSemaphores.push_back(waitSemaphore);
+		m_WaitStages.push_back(waitStage);
+		m_WaitValues.push_back(value);
 	}
 
 	void VulkanCommandBuffer::SetFence(vk::Fence fence)
@@ -179,30 +517,141 @@ namespace Neon
 		m_Fence = fence;
 	}
 
-	void VulkanCommandBuffer::SetWaitStage(vk::PipelineStageFlags waitStage)
+	void VulkanCommandBuffer::ResolveTimestamps(uint32 profilerTrack, std::vector<GpuTiming>& timings)
+	{
+		if (m_TimestampNames.empty())
+		{
+			return;
+		}
+
+		const auto& device = VulkanContext::GetDevice();
+
+		std::array<uint64, c_MaxTimestampQueries> timestamps;
+		uint32 queryCount = static_cast<uint32>(m_TimestampNames.size()) * 2;
+		vk::Result result = device->GetHandle().getQueryPoolResults(m_TimestampQueryPool.get(), 0, queryCount,
+																	 queryCount * sizeof(uint64), timestamps.data(),
+																	 sizeof(uint64), vk::QueryResultFlagBits::e64);
+		// Never stall on the GPU, results which are not ready are dropped
+		if (result != vk::Result::eSuccess)
+		{
+			m_TimestampNames.clear();
+			return;
+		}
+
+		// GPU clock domain is unrelated to the CPU one, zones are placed relative to the submit time
+		const double timestampPeriod = device->GetPhysicalDevice()->GetProperties().limits.timestampPeriod;
+		const uint64 gpuStart = timestamps[0];
+		for (uint32 i = 0; i < m_TimestampNames.size(); i++)
+		{
+			uint64 begin = (timestamps[i * 2] - gpuStart) & m_TimestampMask;
+			uint64 end = (timestamps[i * 2 + 1] - gpuStart) & m_TimestampMask;
+			if (end < begin)
+			{
+				continue;
+			}
+
+			if (Profiler::IsEnabled())
+			{
+				ProfileZone zone;
+				zone.Name = m_TimestampNames[i];
+				zone.Category = "GPU";
+				zone.Start = m_SubmitTime + static_cast<uint64>(begin * timestampPeriod);
+				zone.End = m_SubmitTime + static_cast<uint64>(end * timestampPeriod);
+				Profiler::SubmitZone(profilerTrack, zone);
+			}
+
+			auto it = std::find_if(timings.begin(), timings.end(),
+								   [&](const GpuTiming& timing) { return timing.Name == m_TimestampNames[i]; });
+			GpuTiming& timing = it != timings.end() ? *it : timings.emplace_back();
+			timing.Name = m_TimestampNames[i];
+			timing.Milliseconds += (end - begin) * timestampPeriod / 1e6;
+			timing.Count++;
+		}
+
+		m_TimestampNames.clear();
+	}
+
+	void VulkanCommandBuffer::ResetRecordingState() const
+	{
+		m_Stats = {};
+		ResetBoundState();
+		m_IndirectBuffer = vk::Buffer();
+		m_IndirectCommands = nullptr;
+		m_IndirectCommandCount = 0;
+		m_DrawDataDropped = false;
+		m_IndirectCommandsDropped = false;
+	}
+
+	void VulkanCommandBuffer::ResetBoundState() const
+	{
+		m_BoundPipeline = vk::Pipeline();
+		m_BoundDescriptorSet = vk::DescriptorSet();
+		m_BoundFrameDescriptorSet = vk::DescriptorSet();
+		m_BoundVertexBuffer = vk::Buffer();
+		m_BoundIndexBuffer = vk::Buffer();
+		m_BoundDynamicOffsetCount = 0;
+	}
+
+	void VulkanCommandBuffer::SetViewportAndScissor(uint32 width, uint32 height) const
 	{
-		m_WaitStage = waitStage;
+		// Update viewport state
+		vk::Viewport sceneViewport = {};
+		sceneViewport.x = 0.f;
+		sceneViewport.y = 0.f;
+		sceneViewport.width = (float)width;
+		sceneViewport.height = (float)height;
+		sceneViewport.minDepth = 0.f;
+		sceneViewport.maxDepth = 1.f;
+
+		m_Handle.get().setViewport(0, 1, &sceneViewport);
+
+		// Update scissor state
+		vk::Rect2D sceneCcissor = {};
+		sceneCcissor.offset.x = 0;
+		sceneCcissor.offset.y = 0;
+		sceneCcissor.extent.width = width;
+		sceneCcissor.extent.height = height;
+
+		m_Handle.get().setScissor(0, 1, &sceneCcissor);
+	}
+
+	void VulkanCommandBuffer::BeginTimestamp(const char* name, vk::PipelineStageFlagBits stage) const
+	{
+		if (!m_TimestampsSupported || m_TimestampNames.size() * 2 >= c_MaxTimestampQueries)
+		{
+			return;
+		}
+
+		if (!m_TimestampQueryPool)
+		{
+			vk::QueryPoolCreateInfo queryPoolCreateInfo = {};
+			queryPoolCreateInfo.queryType = vk::QueryType::eTimestamp;
+			queryPoolCreateInfo.queryCount = c_MaxTimestampQueries;
+			m_TimestampQueryPool = VulkanContext::GetDevice()->GetHandle().createQueryPoolUnique(queryPoolCreateInfo);
+			m_Handle.get().resetQueryPool(m_TimestampQueryPool.get(), 0, c_MaxTimestampQueries);
+		}
+
+		m_Handle.get().writeTimestamp(stage, m_TimestampQueryPool.get(), static_cast<uint32>(m_TimestampNames.size()) * 2);
+		m_TimestampNames.push_back(name);
+		m_TimestampOpen = true;
+	}
+
+	void VulkanCommandBuffer::EndTimestamp(vk::PipelineStageFlagBits stage) const
+	{
+		if (!m_TimestampOpen)
+		{
+			return;
+		}
+
+		m_Handle.get().writeTimestamp(stage, m_TimestampQueryPool.get(), static_cast<uint32>(m_TimestampNames.size()) * 2 - 1);
+		m_TimestampOpen = false;
 	}
 
 	VulkanCommandPool::VulkanCommandPool(CommandBufferType type)
 		: CommandPool(type)
 	{
 		vk::CommandPoolCreateInfo cmdPoolInfo = {};
-		switch (type)
-		{
-			case CommandBufferType::Graphics:
-				cmdPoolInfo.queueFamilyIndex = VulkanContext::GetDevice()->GetPhysicalDevice()->GetGraphicsQueueIndex();
-				break;
-			case CommandBufferType::Compute:
-				cmdPoolInfo.queueFamilyIndex = VulkanContext::GetDevice()->GetPhysicalDevice()->GetComputeQueueIndex();
-				break;
-			case CommandBufferType::Transfer:
-				cmdPoolInfo.queueFamilyIndex = VulkanContext::GetDevice()->GetPhysicalDevice()->GetTransferQueueIndex();
-				break;
-			default:
-				NEO_CORE_ERROR("Unknown command buffer type!");
-				break;
-		}
+		cmdPoolInfo.queueFamilyIndex = GetQueueFamilyIndex(type);
 
 		cmdPoolInfo.flags = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
 		m_Handle = VulkanContext::GetDevice()->GetHandle().createCommandPoolUnique(cmdPoolInfo);
@@ -1,32 +1,50 @@
 #pragma once
 
 #include "Neon/Platform/Vulkan/Vulkan.h"
+#include "Neon/Platform/Vulkan/VulkanShader.h"
 #include "Neon/Renderer/CommandBuffer.h"
+#include "Neon/Renderer/RendererContext.h"
 
 namespace Neon
 {
 	class VulkanCommandBuffer : public CommandBuffer
 	{
 	public:
-		VulkanCommandBuffer(const SharedRef<CommandPool>& commandPool);
+		VulkanCommandBuffer(const SharedRef<CommandPool>& commandPool, bool secondary = false);
 
 		void Begin() const override;
+		void BeginSecondary(const SharedRef<RenderPass>& renderPass) const override;
 		void End() const override;
 		void Submit() override;
 
-		void BeginRenderPass(const SharedRef<RenderPass>& renderPass) const override;
+		void BeginRenderPass(const SharedRef<RenderPass>& renderPass, bool secondaryContents = false) const override;
 		void EndRenderPass() const override;
+		void ExecuteCommands(const SharedRef<CommandBuffer>* commandBuffers, uint32 count) const override;
 		void BindVertexBuffer(const SharedRef<VertexBuffer>& vertexBuffer) const override;
 		void BindIndexBuffer(const SharedRef<IndexBuffer>& indexBuffer) const override;
+		void BindInstanceData(const void* data, uint32 size) const override;
 		void BindPipeline(const SharedRef<Pipeline>& pipeline) const override;
 		void DrawIndexed(uint32 indexCount, uint32 instanceCount, uint32 firstIndex, int32 vertexOffset,
 						 uint32 firstInstance) const override;
+		void SetIndirectCommands(const DrawIndexedIndirectCommand* commands, uint32 count) const override;
+		void DrawIndexedIndirect(uint32 firstCommand, uint32 drawCount) const override;
+		void BindInstanceBuffer(const SharedRef<Shader>& shader, const ShaderParamHandle& storageBuffer,
+								uint32 offset) const override;
+		void DrawIndexedIndirectCount(const SharedRef<Shader>& shader, const ShaderParamHandle& commandsBuffer,
+									  uint32 commandsOffset, const ShaderParamHandle& countBuffer, uint32 countOffset,
+									  uint32 maxDrawCount) const override;
 		void Dispatch(uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ) const override;
+		void ComputeToDrawBarrier() const override;
+		void ComputeBarrier() const override;
 
-		void AddSignalSemaphore(vk::Semaphore signalSemaphore);
-		void AddWaitSemaphore(vk::Semaphore waitSemaphore);
+		// Values are only used by timeline semaphores
+		void AddSignalSemaphore(vk::Semaphore signalSemaphore, uint64 value = 0);
+		void AddWaitSemaphore(vk::Semaphore waitSemaphore, vk::PipelineStageFlags waitStage, uint64 value = 0);
 		void SetFence(vk::Fence fence);
-		void SetWaitStage(vk::PipelineStageFlags waitStage);
+
+		// Reads back timestamps of the last submission without waiting, the submission has to be finished already.
+		// Zones are sent to the given profiler track and accumulated into timings.
+		void ResolveTimestamps(uint32 profilerTrack, std::vector<GpuTiming>& timings);
 
 		void* GetHandle() const override
 		{
@@ -34,15 +52,56 @@ namespace Neon
 		}
 
 	private:
+		void ResetRecordingState() const;
+		void ResetBoundState() const;
+		void SetViewportAndScissor(uint32 width, uint32 height) const;
+
+		void BeginTimestamp(const char* name, vk::PipelineStageFlagBits stage) const;
+		void EndTimestamp(vk::PipelineStageFlagBits stage) const;
+
+	private:
+		static constexpr uint32 c_MaxTimestampQueries = 128;
+
 		vk::UniqueCommandBuffer m_Handle;
 
 		std::vector<vk::Semaphore> m_WaitSemaphores;
+		std::vector<vk::PipelineStageFlags> m_WaitStages;
+		std::vector<uint64> m_WaitValues;
 		std::vector<vk::Semaphore> m_SignalSemaphores;
-		vk::PipelineStageFlags m_WaitStage;
+		std::vector<uint64> m_SignalValues;
 		vk::Fence m_Fence;
 
 		vk::UniqueDescriptorPool m_DescPool;
 		vk::UniqueDescriptorSet m_DescSet;
+
+		// Graphics state bound so far, used to drop redundant binds
+		mutable vk::Pipeline m_BoundPipeline;
+		mutable vk::DescriptorSet m_BoundDescriptorSet;
+		mutable vk::DescriptorSet m_BoundFrameDescriptorSet;
+		mutable std::array<uint32, VulkanShader::c_MaxDynamicUniformBuffers> m_BoundDynamicOffsets = {};
+		mutable uint32 m_BoundDynamicOffsetCount = 0;
+		mutable vk::Buffer m_BoundVertexBuffer;
+		mutable vk::Buffer m_BoundIndexBuffer;
+
+		bool m_MultiDrawIndirectSupported = false;
+		bool m_DrawIndirectCountSupported = false;
+		mutable vk::Buffer m_IndirectBuffer;
+		mutable vk::DeviceSize m_IndirectOffset = 0;
+		mutable const DrawIndexedIndirectCommand* m_IndirectCommands = nullptr;
+		mutable uint32 m_IndirectCommandCount = 0;
+
+		// Set when data of the current pipeline bind or the indirect commands did not fit into the uniform buffer ring
+		mutable bool m_DrawDataDropped = false;
+		mutable bool m_IndirectCommandsDropped = false;
+
+		// Query pool is created on first use, queries come in begin/end pairs
+		bool m_TimestampsSupported = false;
+		uint64 m_TimestampMask = 0;
+		mutable vk::UniqueQueryPool m_TimestampQueryPool;
+		mutable std::vector<const char*> m_TimestampNames;
+		mutable bool m_TimestampOpen = false;
+		mutable const char* m_DispatchName = nullptr;
+		uint64 m_SubmitTime = 0;
 	};
 
 	class VulkanCommandPool : public CommandPool
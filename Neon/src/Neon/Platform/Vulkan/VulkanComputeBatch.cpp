@@ -0,0 +1,85 @@
+#include "neopch.h"
+
+#include "Neon/Core/Profiler.h"
+#include "Neon/Platform/Vulkan/VulkanShader.h"
+#include "VulkanComputeBatch.h"
+
+namespace Neon
+{
+	static bool ContainsDescriptorSet(const std::vector<vk::DescriptorSet>& descriptorSets, vk::DescriptorSet descriptorSet)
+	{
+		return std::find(descriptorSets.begin(), descriptorSets.end(), descriptorSet) != descriptorSets.end();
+	}
+
+	VulkanComputeBatch::VulkanComputeBatch(bool asyncCompute)
+		: ComputeBatch(asyncCompute)
+	{
+	}
+
+	void VulkanComputeBatch::Dispatch(const SharedRef<ComputePipeline>& computePipeline, uint32 groupCountX, uint32 groupCountY,
+									  uint32 groupCountZ)
+	{
+		const SharedRef<VulkanShader> vulkanShader = computePipeline->GetShader().As<VulkanShader>();
+		vk::DescriptorSet descriptorSet = vulkanShader->GetDescriptorSet();
+
+		if (vulkanShader->HasPendingWrites())
+		{
+			if (ContainsDescriptorSet(m_RecordedDescriptorSets, descriptorSet))
+			{
+				Submit();
+			}
+			if (ContainsDescriptorSet(m_SubmittedDescriptorSets, descriptorSet))
+			{
+				NEO_PROFILE_SCOPE_CATEGORY("VulkanComputeBatch::WaitForDescriptorSet", "Wait");
+
+				RendererContext::Get()->WaitForSubmission(m_LastSubmission);
+				m_SubmittedDescriptorSets.clear();
+			}
+		}
+
+		if (!m_CommandBuffer)
+		{
+			m_CommandBuffer = RendererContext::Get()->GetCommandBuffer(
+				m_AsyncCompute ? CommandBufferType::Compute : CommandBufferType::Graphics, true);
+			// Resources written by the batch might still be read by work submitted before
+			m_CommandBuffer->ComputeBarrier();
+		}
+
+		m_CommandBuffer->BindPipeline(computePipeline);
+		m_CommandBuffer->Dispatch(groupCountX, groupCountY, groupCountZ);
+		m_CommandBuffer->ComputeBarrier();
+
+		if (!ContainsDescriptorSet(m_RecordedDescriptorSets, descriptorSet))
+		{
+			m_RecordedDescriptorSets.push_back(descriptorSet);
+		}
+	}
+
+	SubmissionToken VulkanComputeBatch::Submit()
+	{
+		if (!m_CommandBuffer)
+		{
+			return m_LastSubmission;
+		}
+
+		// Submissions to the same queue finish in order, so the last one covers every descriptor set submitted so far
+		if (RendererContext::Get()->IsSubmissionComplete(m_LastSubmission))
+		{
+			m_SubmittedDescriptorSets.clear();
+		}
+
+		m_LastSubmission = RendererContext::Get()->SubmitCommandBufferAsync(m_CommandBuffer);
+		m_CommandBuffer = nullptr;
+
+		for (vk::DescriptorSet descriptorSet : m_RecordedDescriptorSets)
+		{
+			if (!ContainsDescriptorSet(m_SubmittedDescriptorSets, descriptorSet))
+			{
+				m_SubmittedDescriptorSets.push_back(descriptorSet);
+			}
+		}
+		m_RecordedDescriptorSets.clear();
+
+		return m_LastSubmission;
+	}
+} // namespace Neon
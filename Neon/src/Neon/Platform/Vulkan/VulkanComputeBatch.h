@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Neon/Renderer/ComputeBatch.h"
+#include "Vulkan.h"
+
+namespace Neon
+{
+	class VulkanComputeBatch : public ComputeBatch
+	{
+	public:
+		VulkanComputeBatch(bool asyncCompute);
+		~VulkanComputeBatch() = default;
+
+		void Dispatch(const SharedRef<ComputePipeline>& computePipeline, uint32 groupCountX, uint32 groupCountY,
+					  uint32 groupCountZ) override;
+		SubmissionToken Submit() override;
+
+	private:
+		SharedRef<CommandBuffer> m_CommandBuffer;
+
+		// Descriptor sets bound by the recorded dispatches and by submissions which might still be executing
+		std::vector<vk::DescriptorSet> m_RecordedDescriptorSets;
+		std::vector<vk::DescriptorSet> m_SubmittedDescriptorSets;
+		SubmissionToken m_LastSubmission;
+	};
+} // namespace Neon
@@ -1,6 +1,9 @@
 #include "neopch.h"
 
+#include "Neon/Core/JobSystem.h"
+#include "Neon/Core/Profiler.h"
 #include "Neon/Platform/Vulkan/VulkanCommandBuffer.h"
+#include "Neon/Platform/Vulkan/VulkanShaderLibrary.h"
 #include "Neon/Renderer/RendererAPI.h"
 #include "VulkanContext.h"
 
@@ -10,6 +13,15 @@ VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE;
 
 namespace Neon
 {
+	// Every push is padded to at most 256 bytes, the largest minUniformBufferOffsetAlignment allowed
+	static constexpr uint32 c_UniformBufferRingFrameSize =
+		RendererContext::c_MaxInstancesPerFrame * static_cast<uint32>(sizeof(glm::mat4)) +
+		RendererContext::c_MaxDrawsPerFrame *
+			(static_cast<uint32>(sizeof(DrawIndexedIndirectCommand)) + RendererContext::c_MaxUniformBytesPerDraw + 2 * 256);
+	static constexpr uint32 c_UploadStagingSize = 64 * 1024 * 1024;
+	static constexpr const char* c_PipelineCachePath = "assets/cache/pipelines.cache";
+	static constexpr const char* c_ShaderDirectory = "assets/shaders";
+
 	static VKAPI_ATTR VkBool32 VKAPI_CALL VulkanDebugReportCallback(VkDebugReportFlagsEXT flags,
 																	VkDebugReportObjectTypeEXT objectType, uint64_t object,
 																	size_t location, int32_t messageCode, const char* pLayerPrefix,
@@ -26,12 +38,15 @@ namespace Neon
 		PFN_vkGetInstanceProcAddr vkGetInstanceProcAddr = dl.getProcAddress<PFN_vkGetInstanceProcAddr>("vkGetInstanceProcAddr");
 		VULKAN_HPP_DEFAULT_DISPATCHER.init(vkGetInstanceProcAddr);
 
-		NEO_CORE_ASSERT(glfwVulkanSupported(), "Vulkan is not supported");
+		if (!IsHeadless())
+		{
+			NEO_CORE_ASSERT(glfwVulkanSupported(), "Vulkan is not supported");
 
-		uint32_t glfwExtensionCount = 0;
-		const char** glfwExtensions;
-		glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-		m_InstanceExtensions.insert(m_InstanceExtensions.end(), glfwExtensions, glfwExtensions + glfwExtensionCount);
+			uint32_t glfwExtensionCount = 0;
+			const char** glfwExtensions;
+			glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+			m_InstanceExtensions.insert(m_InstanceExtensions.end(), glfwExtensions, glfwExtensions + glfwExtensionCount);
+		}
 
 		std::vector<vk::ExtensionProperties> supportedExtensions = vk::enumerateInstanceExtensionProperties();
 		for (const auto& extension : m_InstanceExtensions)
@@ -83,11 +98,23 @@ namespace Neon
 
 		VULKAN_HPP_DEFAULT_DISPATCHER.init(m_Device->GetHandle());
 
-		m_SwapChain.Init(s_Instance.get(), m_Device);
-		m_SwapChain.InitSurface(m_WindowHandle);
-		// This window size should be ignored
-		uint32 width = 1920, height = 1080;
-		m_SwapChain.Create(&width, &height);
+		if (IsHeadless())
+		{
+			vk::FenceCreateInfo fenceCreateInfo{vk::FenceCreateFlagBits::eSignaled};
+			m_HeadlessFrameFences.resize(m_SwapChain.GetTargetMaxFramesInFlight());
+			for (auto& fence : m_HeadlessFrameFences)
+			{
+				fence = m_Device->GetHandle().createFenceUnique(fenceCreateInfo);
+			}
+		}
+		else
+		{
+			m_SwapChain.Init(s_Instance.get(), m_Device);
+			m_SwapChain.InitSurface(m_WindowHandle);
+			// This window size should be ignored
+			uint32 width = 1920, height = 1080;
+			m_SwapChain.Create(&width, &height);
+		}
 
 		m_GraphicsCommandPool = CommandPool::Create(CommandBufferType::Graphics);
 		m_ComputeCommandPool = CommandPool::Create(CommandBufferType::Compute);
@@ -95,24 +122,125 @@ namespace Neon
 		for (uint32 i = 0; i < m_SwapChain.GetTargetMaxFramesInFlight(); i++)
 		{
 			m_RenderCommandBuffers.push_back(CommandBuffer::Create(m_GraphicsCommandPool));
+
+			auto& threadCommandBuffers = m_SecondaryCommandBuffers.emplace_back(JobSystem::GetThreadCount());
+			for (ThreadCommandBuffers& commandBuffers : threadCommandBuffers)
+			{
+				commandBuffers.Pool = CommandPool::Create(CommandBufferType::Graphics);
+			}
 		}
+
+		m_UniformBufferRing = CreateUnique<VulkanUniformBufferRing>(m_Device, m_SwapChain.GetTargetMaxFramesInFlight(),
+																	c_UniformBufferRingFrameSize);
+		m_UploadManager = CreateUnique<VulkanUploadManager>(m_Device, c_UploadStagingSize);
+		m_PipelineCache = CreateUnique<VulkanPipelineCache>(m_Device, c_PipelineCachePath);
+		// Programs check their frame set resources against its layout
+		m_FrameDescriptors = CreateUnique<VulkanFrameDescriptors>(m_Device, m_SwapChain.GetTargetMaxFramesInFlight());
+		VulkanShaderLibrary::CompileDirectory(c_ShaderDirectory);
+
+		vk::SemaphoreTypeCreateInfo semaphoreTypeInfo{vk::SemaphoreType::eTimeline, 0};
+		vk::SemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.pNext = &semaphoreTypeInfo;
+		for (auto& semaphore : m_SubmissionSemaphores)
+		{
+			semaphore = m_Device->GetHandle().createSemaphoreUnique(semaphoreInfo);
+		}
+
+		m_GraphicsProfilerTrack = Profiler::CreateTrack("GPU Graphics");
+		m_ComputeProfilerTrack = Profiler::CreateTrack("GPU Compute");
 	}
 
 	void VulkanContext::BeginFrame()
 	{
-		m_SwapChain.BeginFrame();
-		GetPrimaryRenderCommandBuffer()->Begin();
+		if (IsHeadless())
+		{
+			m_HeadlessFrameIndex = (m_HeadlessFrameIndex + 1) % m_SwapChain.GetTargetMaxFramesInFlight();
+
+			vk::Fence frameFence = m_HeadlessFrameFences[m_HeadlessFrameIndex].get();
+			VK_CHECK_RESULT(m_Device->GetHandle().waitForFences(frameFence, VK_TRUE, UINT64_MAX));
+			VK_CHECK_RESULT(m_Device->GetHandle().resetFences(1, &frameFence));
+
+			// Resources released while recording this slot last time are no longer in use
+			GetPrimaryRenderCommandBuffer()->Flush();
+		}
+		else
+		{
+			m_SwapChain.BeginFrame();
+		}
+
+		m_UniformBufferRing->BeginFrame(GetCurrentFrameIndex());
+		VulkanAllocator::BeginFrame();
+		ReleaseAsyncSubmissions();
+
+		for (ThreadCommandBuffers& commandBuffers : m_SecondaryCommandBuffers[GetCurrentFrameIndex()])
+		{
+			commandBuffers.UsedCount = 0;
+		}
+
+		// Frame fence was just waited on, so timestamps written the last time this slot was used are available
+		auto commandBuffer = GetPrimaryRenderCommandBuffer().As<VulkanCommandBuffer>();
+		{
+			std::lock_guard<std::mutex> lock(m_GpuTimingsMutex);
+			m_GpuTimings = std::move(m_PendingGpuTimings);
+			m_PendingGpuTimings.clear();
+			commandBuffer->ResolveTimestamps(m_GraphicsProfilerTrack, m_GpuTimings);
+		}
+
+		commandBuffer->Begin();
 	}
 
 	void VulkanContext::SwapBuffers()
 	{
 		GetPrimaryRenderCommandBuffer()->End();
-		m_SwapChain.Present();
+
+		// Uploads recorded during the frame are submitted ahead of it, so the graphics queue sees them in order
+		m_UploadManager->Flush();
+
+		// Async compute work submitted so far has to finish before the frame uses its results
+		{
+			std::lock_guard<std::mutex> lock(m_AsyncSubmissionsMutex);
+			const uint32 computeIndex = static_cast<uint32>(CommandBufferType::Compute);
+			if (m_SubmissionValues[computeIndex] > 0)
+			{
+				GetPrimaryRenderCommandBuffer().As<VulkanCommandBuffer>()->AddWaitSemaphore(
+					m_SubmissionSemaphores[computeIndex].get(), vk::PipelineStageFlagBits::eAllCommands,
+					m_SubmissionValues[computeIndex]);
+			}
+		}
+
+		if (IsHeadless())
+		{
+			// Nothing to present, the frame fence is waited on once this slot comes around again
+			auto commandBuffer = GetPrimaryRenderCommandBuffer().As<VulkanCommandBuffer>();
+			commandBuffer->SetFence(m_HeadlessFrameFences[m_HeadlessFrameIndex].get());
+			commandBuffer->Submit();
+		}
+		else
+		{
+			m_SwapChain.Present();
+		}
 	}
 
 	void VulkanContext::OnResize(uint32 width, uint32 height)
 	{
-		m_SwapChain.OnResize(width, height);
+		if (!IsHeadless())
+		{
+			m_SwapChain.OnResize(width, height);
+		}
+	}
+
+	SharedRef<CommandBuffer> VulkanContext::GetSecondaryRenderCommandBuffer()
+	{
+		auto& threadCommandBuffers = m_SecondaryCommandBuffers[GetCurrentFrameIndex()];
+		uint32 threadIndex = JobSystem::GetCurrentThreadIndex();
+		NEO_CORE_ASSERT(threadIndex < threadCommandBuffers.size(), "Secondary command buffers are only handed out to job threads!");
+
+		ThreadCommandBuffers& commandBuffers = threadCommandBuffers[threadIndex];
+		if (commandBuffers.UsedCount == commandBuffers.CommandBuffers.size())
+		{
+			commandBuffers.CommandBuffers.push_back(CommandBuffer::Create(commandBuffers.Pool, true));
+		}
+		return commandBuffers.CommandBuffers[commandBuffers.UsedCount++];
 	}
 
 	SharedRef<CommandBuffer> VulkanContext::GetCommandBuffer(CommandBufferType type, bool begin) const
@@ -151,6 +279,11 @@ namespace Neon
 
 		vulkanCommandBuffer->End();
 
+		// Compute queue is not ordered after the upload submissions, so it has to wait for them explicitly
+		m_UploadManager->Flush();
+		vulkanCommandBuffer->AddWaitSemaphore(m_UploadManager->GetSemaphore(), vk::PipelineStageFlagBits::eAllCommands,
+											  m_UploadManager->GetFlushedValue());
+
 		// Create fence to ensure that the command buffer has finished executing
 		vk::FenceCreateInfo fenceCreateInfo = {};
 		vk::UniqueFence fence = device->GetHandle().createFenceUnique(fenceCreateInfo);
@@ -160,6 +293,108 @@ namespace Neon
 
 		// Wait for the fence to signal that command buffer has finished executing
 		device->GetHandle().waitForFences(fence.get(), VK_TRUE, DEFAULT_FENCE_TIMEOUT);
+
+		std::lock_guard<std::mutex> lock(m_GpuTimingsMutex);
+		vulkanCommandBuffer->ResolveTimestamps(
+			commandBuffer->GetType() == CommandBufferType::Compute ? m_ComputeProfilerTrack : m_GraphicsProfilerTrack,
+			m_PendingGpuTimings);
+	}
+
+	SubmissionToken VulkanContext::SubmitCommandBufferAsync(SharedRef<CommandBuffer>& commandBuffer) const
+	{
+		NEO_CORE_ASSERT(commandBuffer && commandBuffer->GetType() != CommandBufferType::Transfer,
+						"Only graphics and compute command buffers can be submitted asynchronously!");
+
+		auto vulkanCommandBuffer = commandBuffer.As<VulkanCommandBuffer>();
+
+		vulkanCommandBuffer->End();
+
+		m_UploadManager->Flush();
+		vulkanCommandBuffer->AddWaitSemaphore(m_UploadManager->GetSemaphore(), vk::PipelineStageFlagBits::eAllCommands,
+											  m_UploadManager->GetFlushedValue());
+
+		// Values have to be signaled in increasing order, so they are assigned and submitted under the lock
+		std::lock_guard<std::mutex> lock(m_AsyncSubmissionsMutex);
+		const uint32 queueIndex = static_cast<uint32>(commandBuffer->GetType());
+		SubmissionToken token{commandBuffer->GetType(), ++m_SubmissionValues[queueIndex]};
+
+		vulkanCommandBuffer->AddSignalSemaphore(m_SubmissionSemaphores[queueIndex].get(), token.Value);
+		vulkanCommandBuffer->Submit();
+
+		m_AsyncSubmissions.push_back({commandBuffer, token});
+		return token;
+	}
+
+	bool VulkanContext::IsSubmissionComplete(const SubmissionToken& token) const
+	{
+		if (token.Value == 0)
+		{
+			return true;
+		}
+
+		vk::Semaphore semaphore = m_SubmissionSemaphores[static_cast<uint32>(token.Type)].get();
+		return m_Device->GetHandle().getSemaphoreCounterValue(semaphore) >= token.Value;
+	}
+
+	void VulkanContext::WaitForSubmission(const SubmissionToken& token) const
+	{
+		if (token.Value == 0)
+		{
+			return;
+		}
+
+		NEO_PROFILE_SCOPE_CATEGORY("VulkanContext::WaitForSubmission", "Wait");
+
+		vk::Semaphore semaphore = m_SubmissionSemaphores[static_cast<uint32>(token.Type)].get();
+		vk::SemaphoreWaitInfo waitInfo{{}, 1, &semaphore, &token.Value};
+		VK_CHECK_RESULT(m_Device->GetHandle().waitSemaphores(waitInfo, UINT64_MAX));
+
+		ReleaseAsyncSubmissions();
+	}
+
+	void VulkanContext::ReleaseAsyncSubmissions() const
+	{
+		std::lock_guard<std::mutex> lock(m_AsyncSubmissionsMutex);
+		if (m_AsyncSubmissions.empty())
+		{
+			return;
+		}
+
+		std::array<uint64, 2> completedValues;
+		for (uint32 i = 0; i < completedValues.size(); i++)
+		{
+			completedValues[i] = m_Device->GetHandle().getSemaphoreCounterValue(m_SubmissionSemaphores[i].get());
+		}
+
+		std::lock_guard<std::mutex> timingsLock(m_GpuTimingsMutex);
+		auto it = std::remove_if(m_AsyncSubmissions.begin(), m_AsyncSubmissions.end(), [&](AsyncSubmission& submission) {
+			if (submission.Token.Value > completedValues[static_cast<uint32>(submission.Token.Type)])
+			{
+				return false;
+			}
+
+			submission.CommandBuffer.As<VulkanCommandBuffer>()->ResolveTimestamps(
+				submission.Token.Type == CommandBufferType::Compute ? m_ComputeProfilerTrack : m_GraphicsProfilerTrack,
+				m_PendingGpuTimings);
+			return true;
+		});
+		m_AsyncSubmissions.erase(it, m_AsyncSubmissions.end());
+	}
+
+	std::vector<GpuTiming> VulkanContext::GetGpuTimings() const
+	{
+		std::lock_guard<std::mutex> lock(m_GpuTimingsMutex);
+		return m_GpuTimings;
+	}
+
+	GpuMemoryStats VulkanContext::GetMemoryStats() const
+	{
+		return VulkanAllocator::GetStats();
+	}
+
+	void VulkanContext::DefragmentMemory() const
+	{
+		VulkanAllocator::DefragmentBuffers();
 	}
 
 } // namespace Neon
@@ -2,13 +2,20 @@
 
 #include "Neon/Platform/Vulkan/Vulkan.h"
 #include "Neon/Platform/Vulkan/VulkanDevice.h"
+#include "Neon/Platform/Vulkan/VulkanFrameDescriptors.h"
+#include "Neon/Platform/Vulkan/VulkanPipelineCache.h"
 #include "Neon/Platform/Vulkan/VulkanSwapChain.h"
+#include "Neon/Platform/Vulkan/VulkanUniformBufferRing.h"
+#include "Neon/Platform/Vulkan/VulkanUploadManager.h"
 #include "Neon/Renderer/RendererContext.h"
 
+#include <mutex>
+
 struct GLFWwindow;
 
 namespace Neon
 {
+	// Without a window handle the context runs headless, frames are rendered offscreen without a surface or swapchain
 	class VulkanContext : public RendererContext
 	{
 	public:
@@ -42,9 +49,40 @@ namespace Neon
 			return Get()->m_Device;
 		}
 
+		static VulkanUniformBufferRing& GetUniformBufferRing()
+		{
+			return *Get()->m_UniformBufferRing;
+		}
+
+		static VulkanUploadManager& GetUploadManager()
+		{
+			return *Get()->m_UploadManager;
+		}
+
+		static VulkanPipelineCache& GetPipelineCache()
+		{
+			return *Get()->m_PipelineCache;
+		}
+
+		static VulkanFrameDescriptors& GetFrameDescriptors()
+		{
+			return *Get()->m_FrameDescriptors;
+		}
+
 		SharedRef<CommandBuffer>& GetPrimaryRenderCommandBuffer() override
 		{
-			return m_RenderCommandBuffers[m_SwapChain.GetCurrentFrameIndex()];
+			return m_RenderCommandBuffers[GetCurrentFrameIndex()];
+		}
+		SharedRef<CommandBuffer> GetSecondaryRenderCommandBuffer() override;
+
+		uint32 GetCurrentFrameIndex() const override
+		{
+			return IsHeadless() ? m_HeadlessFrameIndex : m_SwapChain.GetCurrentFrameIndex();
+		}
+
+		bool IsHeadless() const
+		{
+			return m_WindowHandle == nullptr;
 		}
 
 		const VulkanSwapChain& GetSwapChain() const
@@ -52,6 +90,11 @@ namespace Neon
 			return m_SwapChain;
 		}
 
+		void SetFrameUniformBuffer(const ShaderParamHandle& name, const void* data, uint32 size) override
+		{
+			m_FrameDescriptors->SetUniformBuffer(GetCurrentFrameIndex(), name, data, size);
+		}
+
 		void WaitIdle() const override
 		{
 			m_Device->GetHandle().waitIdle();
@@ -59,6 +102,17 @@ namespace Neon
 
 		SharedRef<CommandBuffer> GetCommandBuffer(CommandBufferType type, bool begin) const override;
 		void SubmitCommandBuffer(SharedRef<CommandBuffer>& commandBuffer) const override;
+		SubmissionToken SubmitCommandBufferAsync(SharedRef<CommandBuffer>& commandBuffer) const override;
+		bool IsSubmissionComplete(const SubmissionToken& token) const override;
+		void WaitForSubmission(const SubmissionToken& token) const override;
+
+		std::vector<GpuTiming> GetGpuTimings() const override;
+		GpuMemoryStats GetMemoryStats() const override;
+		void DefragmentMemory() const override;
+
+	private:
+		// Resolves timestamps of finished async submissions and releases their command buffers
+		void ReleaseAsyncSubmissions() const;
 
 	private:
 		GLFWwindow* m_WindowHandle;
@@ -83,6 +137,43 @@ namespace Neon
 
 		std::vector<SharedRef<CommandBuffer>> m_RenderCommandBuffers;
 
+		// Command pools are externally synchronized, so every job thread records secondaries from its own pool
+		struct ThreadCommandBuffers
+		{
+			SharedRef<CommandPool> Pool;
+			std::vector<SharedRef<CommandBuffer>> CommandBuffers;
+			uint32 UsedCount = 0;
+		};
+		// Indexed by frame slot and job thread
+		std::vector<std::vector<ThreadCommandBuffers>> m_SecondaryCommandBuffers;
+
+		UniqueRef<VulkanUniformBufferRing> m_UniformBufferRing;
+		UniqueRef<VulkanUploadManager> m_UploadManager;
+		UniqueRef<VulkanPipelineCache> m_PipelineCache;
+		UniqueRef<VulkanFrameDescriptors> m_FrameDescriptors;
+
+		std::vector<vk::UniqueFence> m_HeadlessFrameFences;
+		uint32 m_HeadlessFrameIndex = 0;
+
+		uint32 m_GraphicsProfilerTrack = 0;
+		uint32 m_ComputeProfilerTrack = 0;
+
+		// One-off command buffers can be submitted from any thread, their timings are added to the next resolved frame
+		mutable std::mutex m_GpuTimingsMutex;
+		mutable std::vector<GpuTiming> m_PendingGpuTimings;
+		std::vector<GpuTiming> m_GpuTimings;
+
+		// Async submissions signal a timeline semaphore of their queue, indexed by graphics and compute command buffer type
+		struct AsyncSubmission
+		{
+			SharedRef<CommandBuffer> CommandBuffer;
+			SubmissionToken Token;
+		};
+		std::array<vk::UniqueSemaphore, 2> m_SubmissionSemaphores;
+		mutable std::array<uint64, 2> m_SubmissionValues = {};
+		mutable std::vector<AsyncSubmission> m_AsyncSubmissions;
+		mutable std::mutex m_AsyncSubmissionsMutex;
+
 		friend class VulkanSwapChain;
 	};
 
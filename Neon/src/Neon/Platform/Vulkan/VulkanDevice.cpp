@@ -1,5 +1,6 @@
 #include "neopch.h"
 
+#include "VulkanAllocator.h"
 #include "VulkanContext.h"
 #include "VulkanDevice.h"
 
@@ -28,6 +29,10 @@ namespace Neon
 
 		m_Properties = m_Handle.getProperties();
 		m_SupportedFeatures = m_Handle.getFeatures();
+		m_TimelineSemaphoreSupported =
+			m_Handle.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceTimelineSemaphoreFeatures>()
+				.get<vk::PhysicalDeviceTimelineSemaphoreFeatures>()
+				.timelineSemaphore;
 		m_MemoryProperties = m_Handle.getMemoryProperties();
 
 		m_SupportedExtensions = m_Handle.enumerateDeviceExtensionProperties();
@@ -168,19 +173,38 @@ namespace Neon
 		return vk::Format::eUndefined;
 	}
 
+	bool VulkanPhysicalDevice::IsExtensionSupported(const char* extensionName) const
+	{
+		return std::any_of(m_SupportedExtensions.begin(), m_SupportedExtensions.end(),
+						   [extensionName](const vk::ExtensionProperties& extension)
+						   { return strcmp(extension.extensionName, extensionName) == 0; });
+	}
+
 	VulkanDevice::VulkanDevice(SharedRef<VulkanPhysicalDevice>& physicalDevice)
 		: m_PhysicalDevice(physicalDevice)
 	{
 		NEO_CORE_ASSERT(physicalDevice, "Vulkan device initialized with non existant physical device");
 
+		std::vector<const char*> extensions = physicalDevice->m_RequiredPhysicalDeviceExtensions;
+		m_DrawIndirectCountSupported = physicalDevice->IsExtensionSupported(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+		if (m_DrawIndirectCountSupported)
+		{
+			extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+		}
+		m_MemoryBudgetSupported = physicalDevice->IsExtensionSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		if (m_MemoryBudgetSupported)
+		{
+			extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		}
+
 #ifdef NEO_DEBUG
 		vk::DeviceCreateInfo deviceCreateInfo{{},
 											  static_cast<uint32>(physicalDevice->m_QueueCreateInfos.size()),
 											  physicalDevice->m_QueueCreateInfos.data(),
 											  static_cast<uint32>(m_ValidationLayers.size()),
 											  m_ValidationLayers.data(),
-											  static_cast<uint32>(physicalDevice->m_RequiredPhysicalDeviceExtensions.size()),
-											  physicalDevice->m_RequiredPhysicalDeviceExtensions.data(),
+											  static_cast<uint32>(extensions.size()),
+											  extensions.data(),
 											  nullptr};
 #else
 		vk::DeviceCreateInfo deviceCreateInfo{{},
@@ -188,13 +212,19 @@ namespace Neon
 											  physicalDevice->m_QueueCreateInfos.data(),
 											  0,
 											  nullptr,
-											  static_cast<uint32>(physicalDevice->m_RequiredPhysicalDeviceExtensions.size()),
-											  physicalDevice->m_RequiredPhysicalDeviceExtensions.data(),
+											  static_cast<uint32>(extensions.size()),
+											  extensions.data(),
 											  nullptr};
 #endif
 
+		// Uploads and async compute batches are tracked with timeline semaphores, there is no fence based fallback
+		NEO_CORE_ASSERT(physicalDevice->IsTimelineSemaphoreSupported(),
+						"Timeline semaphores are required but not supported by the physical device!");
+		vk::PhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures;
+		timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
 		vk::PhysicalDeviceScalarBlockLayoutFeatures scalarLayoutFeatures;
 		scalarLayoutFeatures.scalarBlockLayout = VK_TRUE;
+		scalarLayoutFeatures.pNext = &timelineSemaphoreFeatures;
 		vk::PhysicalDeviceDescriptorIndexingFeatures descriptorFeatures;
 		descriptorFeatures.runtimeDescriptorArray = VK_TRUE;
 		descriptorFeatures.pNext = &scalarLayoutFeatures;
@@ -204,6 +234,7 @@ namespace Neon
 		deviceFeatures.sampleRateShading = VK_TRUE;
 		deviceFeatures.fillModeNonSolid = VK_TRUE;
 		deviceFeatures.wideLines = VK_TRUE;
+		deviceFeatures.multiDrawIndirect = m_PhysicalDevice->GetSupportedFeatures().multiDrawIndirect;
 		vk::PhysicalDeviceFeatures2 deviceFeatures2;
 		deviceFeatures2.pNext = &descriptorFeatures;
 		deviceFeatures2.features = deviceFeatures;
@@ -225,6 +256,13 @@ namespace Neon
 		m_GraphicsQueue = m_Handle.get().getQueue(physicalDevice->m_QueueFamilyIndices.Graphics, 0);
 		m_ComputeQueue = m_Handle.get().getQueue(physicalDevice->m_QueueFamilyIndices.Compute, 0);
 		m_TransferQueue = m_Handle.get().getQueue(physicalDevice->m_QueueFamilyIndices.Transfer, 0);
+
+		VulkanAllocator::Init(VulkanContext::GetInstance(), m_PhysicalDevice, m_Handle.get(), m_MemoryBudgetSupported);
+	}
+
+	VulkanDevice::~VulkanDevice()
+	{
+		VulkanAllocator::Shutdown();
 	}
 
 	SharedRef<VulkanDevice> VulkanDevice::Create(SharedRef<VulkanPhysicalDevice>& physicalDevice)
@@ -4,6 +4,8 @@
 
 #include "Vulkan.h"
 
+#include <mutex>
+
 namespace Neon
 {
 	class VulkanPhysicalDevice : public RefCounted
@@ -47,6 +49,19 @@ namespace Neon
 			return m_SupportedFeatures;
 		}
 
+		bool IsExtensionSupported(const char* extensionName) const;
+		// Core in Vulkan 1.2, but drivers may still leave the feature out
+		bool IsTimelineSemaphoreSupported() const
+		{
+			return m_TimelineSemaphoreSupported;
+		}
+
+		const vk::QueueFamilyProperties& GetQueueFamilyProperties(uint32 queueFamilyIndex) const
+		{
+			NEO_CORE_ASSERT(queueFamilyIndex < m_QueueFamilyProperties.size(), "Queue family index out of range");
+			return m_QueueFamilyProperties[queueFamilyIndex];
+		}
+
 		static SharedRef<VulkanPhysicalDevice> Select();
 
 	private:
@@ -65,6 +80,7 @@ namespace Neon
 		vk::PhysicalDevice m_Handle;
 		vk::PhysicalDeviceProperties m_Properties;
 		vk::PhysicalDeviceFeatures m_SupportedFeatures;
+		bool m_TimelineSemaphoreSupported = false;
 		vk::PhysicalDeviceMemoryProperties m_MemoryProperties;
 
 		vk::Format m_DepthFormat = vk::Format::eUndefined;
@@ -90,7 +106,7 @@ namespace Neon
 	{
 	public:
 		VulkanDevice(SharedRef<VulkanPhysicalDevice>& physicalDevice);
-		~VulkanDevice() = default;
+		~VulkanDevice();
 
 		vk::Device GetHandle() const
 		{
@@ -115,11 +131,28 @@ namespace Neon
 			return m_TransferQueue;
 		}
 
+		// Queues need external synchronization and families may share a queue, so one lock covers every submit and present
+		std::mutex& GetQueueMutex() const
+		{
+			return m_QueueMutex;
+		}
+
 		vk::CommandPool GetGraphicsCommandPool() const
 		{
 			return m_GraphicsCommandPool.get();
 		}
 
+		// Indirect draws can take their draw count from a buffer, see VK_KHR_draw_indirect_count
+		bool IsDrawIndirectCountSupported() const
+		{
+			return m_DrawIndirectCountSupported;
+		}
+		// Heap budgets reported by the driver instead of estimates, see VK_EXT_memory_budget
+		bool IsMemoryBudgetSupported() const
+		{
+			return m_MemoryBudgetSupported;
+		}
+
 		static SharedRef<VulkanDevice> Create(SharedRef<VulkanPhysicalDevice>& physicalDevice);
 
 	private:
@@ -129,10 +162,14 @@ namespace Neon
 		vk::Queue m_GraphicsQueue;
 		vk::Queue m_ComputeQueue;
 		vk::Queue m_TransferQueue;
+		mutable std::mutex m_QueueMutex;
 
 		vk::UniqueCommandPool m_GraphicsCommandPool;
 		vk::UniqueCommandPool m_ComputeCommandPool;
 
+		bool m_DrawIndirectCountSupported = false;
+		bool m_MemoryBudgetSupported = false;
+
 		const std::vector<const char*> m_ValidationLayers = {"VK_LAYER_KHRONOS_validation"};
 	};
 
@@ -0,0 +1,114 @@
+#include "neopch.h"
+
+#include "VulkanFrameDescriptors.h"
+
+namespace Neon
+{
+	VulkanFrameDescriptors::VulkanFrameDescriptors(const SharedRef<VulkanDevice>& device, uint32 framesInFlight)
+		: m_Device(device)
+	{
+		vk::Device deviceHandle = device->GetHandle();
+
+		// Read by any graphics or compute stage, so all pipeline layouts share the very same set layout
+		std::array<vk::DescriptorSetLayoutBinding, c_UniformBuffers.size()> layoutBindings;
+		for (uint32 i = 0; i < c_UniformBuffers.size(); i++)
+		{
+			layoutBindings[i].binding = c_UniformBuffers[i].BindingPoint;
+			layoutBindings[i].descriptorType = vk::DescriptorType::eUniformBuffer;
+			layoutBindings[i].descriptorCount = 1;
+			layoutBindings[i].stageFlags = vk::ShaderStageFlagBits::eAllGraphics | vk::ShaderStageFlagBits::eCompute;
+
+			m_ParamIds[i] = ShaderParamHandle(c_UniformBuffers[i].Name).GetId();
+		}
+
+		vk::DescriptorSetLayoutCreateInfo descriptorLayout = {};
+		descriptorLayout.bindingCount = static_cast<uint32>(layoutBindings.size());
+		descriptorLayout.pBindings = layoutBindings.data();
+		m_DescriptorSetLayout = deviceHandle.createDescriptorSetLayoutUnique(descriptorLayout);
+
+		vk::DescriptorPoolSize poolSize;
+		poolSize.type = vk::DescriptorType::eUniformBuffer;
+		poolSize.descriptorCount = static_cast<uint32>(c_UniformBuffers.size()) * framesInFlight;
+
+		vk::DescriptorPoolCreateInfo descPoolCreateInfo = {};
+		descPoolCreateInfo.poolSizeCount = 1;
+		descPoolCreateInfo.pPoolSizes = &poolSize;
+		descPoolCreateInfo.maxSets = framesInFlight;
+		m_DescriptorPool = deviceHandle.createDescriptorPoolUnique(descPoolCreateInfo);
+
+		// Sets are freed along with the pool
+		std::vector<vk::DescriptorSetLayout> setLayouts(framesInFlight, m_DescriptorSetLayout.get());
+		vk::DescriptorSetAllocateInfo allocInfo(m_DescriptorPool.get(), framesInFlight, setLayouts.data());
+		std::vector<vk::DescriptorSet> descriptorSets = deviceHandle.allocateDescriptorSets(allocInfo);
+
+		VulkanAllocator allocator(device, "FrameDescriptors");
+		m_Frames.resize(framesInFlight);
+		for (uint32 frameIndex = 0; frameIndex < framesInFlight; frameIndex++)
+		{
+			Frame& frame = m_Frames[frameIndex];
+			frame.DescriptorSet = descriptorSets[frameIndex];
+
+			std::array<vk::DescriptorBufferInfo, c_UniformBuffers.size()> bufferInfos;
+			std::array<vk::WriteDescriptorSet, c_UniformBuffers.size()> writes;
+			for (uint32 i = 0; i < c_UniformBuffers.size(); i++)
+			{
+				allocator.AllocateBuffer(frame.Buffers[i], c_UniformBuffers[i].Size, vk::BufferUsageFlagBits::eUniformBuffer,
+										 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+				// Stays mapped until the memory is freed
+				frame.MappedData[i] = static_cast<byte*>(frame.Buffers[i].Memory.Map());
+				memset(frame.MappedData[i], 0, c_UniformBuffers[i].Size);
+
+				bufferInfos[i].buffer = frame.Buffers[i].Handle.get();
+				bufferInfos[i].offset = 0;
+				bufferInfos[i].range = c_UniformBuffers[i].Size;
+
+				writes[i] = {frame.DescriptorSet, c_UniformBuffers[i].BindingPoint, 0, 1, vk::DescriptorType::eUniformBuffer,
+							 nullptr, &bufferInfos[i]};
+			}
+			deviceHandle.updateDescriptorSets(writes, {});
+		}
+	}
+
+	VulkanFrameDescriptors::~VulkanFrameDescriptors()
+	{
+		for (Frame& frame : m_Frames)
+		{
+			for (VulkanBuffer& buffer : frame.Buffers)
+			{
+				buffer.Memory.Unmap();
+			}
+		}
+	}
+
+	void VulkanFrameDescriptors::SetUniformBuffer(uint32 frameIndex, const ShaderParamHandle& name, const void* data,
+												  uint32 size)
+	{
+		for (uint32 i = 0; i < c_UniformBuffers.size(); i++)
+		{
+			if (m_ParamIds[i] == name.GetId())
+			{
+				NEO_CORE_ASSERT(size <= c_UniformBuffers[i].Size, "Buffer out of range!");
+				memcpy(m_Frames[frameIndex].MappedData[i], data, size);
+				return;
+			}
+		}
+		NEO_CORE_ASSERT(false, "Unknown frame resource name!");
+	}
+
+	bool VulkanFrameDescriptors::IsCompatible(const ShaderStageResource& resource)
+	{
+		if (resource.Kind != ShaderResourceKind::UniformBuffer || resource.Count != 1)
+		{
+			return false;
+		}
+		for (const UniformBufferLayout& uniformBuffer : c_UniformBuffers)
+		{
+			if (resource.Name == uniformBuffer.Name)
+			{
+				return resource.BindingPoint == uniformBuffer.BindingPoint && resource.Size <= uniformBuffer.Size;
+			}
+		}
+		return false;
+	}
+} // namespace Neon
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Neon/Renderer/Shader.h"
+#include "Vulkan.h"
+#include "VulkanAllocator.h"
+#include "VulkanShaderLibrary.h"
+
+namespace Neon
+{
+	// Descriptor set shared by all programs for data that changes once per frame, like the camera and the lights. Every
+	// frame slot has its own set and buffers, written by the renderer and bound once per command buffer instead of being
+	// copied into the material set of every shader.
+	class VulkanFrameDescriptors
+	{
+	public:
+		struct UniformBufferLayout
+		{
+			const char* Name;
+			uint32 BindingPoint;
+			// Upper bound of the declared struct size
+			uint32 Size;
+		};
+
+		// Declared as set 0 by the shaders reading them
+		static constexpr std::array<UniformBufferLayout, 2> c_UniformBuffers = {{{"CameraUBO", 0, 256}, {"LightUBO", 1, 8192}}};
+
+	public:
+		VulkanFrameDescriptors(const SharedRef<VulkanDevice>& device, uint32 framesInFlight);
+		~VulkanFrameDescriptors();
+
+		// Replaces the data of the frame slot for all of its draws, the slot must not be in use by the GPU
+		void SetUniformBuffer(uint32 frameIndex, const ShaderParamHandle& name, const void* data, uint32 size);
+
+		vk::DescriptorSetLayout GetDescriptorSetLayout() const
+		{
+			return m_DescriptorSetLayout.get();
+		}
+		vk::DescriptorSet GetDescriptorSet(uint32 frameIndex) const
+		{
+			return m_Frames[frameIndex].DescriptorSet;
+		}
+
+		// Whether a reflected frame set resource matches the layout
+		static bool IsCompatible(const ShaderStageResource& resource);
+
+	private:
+		struct Frame
+		{
+			vk::DescriptorSet DescriptorSet;
+			std::array<VulkanBuffer, c_UniformBuffers.size()> Buffers;
+			std::array<byte*, c_UniformBuffers.size()> MappedData = {};
+		};
+
+		SharedRef<VulkanDevice> m_Device;
+
+		// Handle ids of the uniform buffer names
+		std::array<uint32, c_UniformBuffers.size()> m_ParamIds = {};
+
+		vk::UniqueDescriptorSetLayout m_DescriptorSetLayout;
+		vk::UniqueDescriptorPool m_DescriptorPool;
+		std::vector<Frame> m_Frames;
+	};
+} // namespace Neon
@@ -8,13 +8,19 @@ namespace Neon
 	VulkanIndexBuffer::VulkanIndexBuffer(const void* data, uint32 size)
 		: IndexBuffer(size)
 	{
-		// TODO: Create device local buffer
 		const auto& device = VulkanContext::GetDevice();
 
 		VulkanAllocator allocator(device, "IndexBuffer");
 
-		allocator.AllocateBuffer(m_Buffer, size, vk::BufferUsageFlagBits::eIndexBuffer,
-								 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-		allocator.UpdateBuffer(m_Buffer, data);
+		allocator.AllocateBuffer(m_Buffer, size, vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst,
+								 vk::MemoryPropertyFlagBits::eDeviceLocal);
+		VulkanContext::GetUploadManager().UploadBuffer(m_Buffer.Handle.get(), data, size);
+
+		VulkanAllocator::RegisterBufferOwner(this);
+	}
+
+	VulkanIndexBuffer::~VulkanIndexBuffer()
+	{
+		VulkanAllocator::UnregisterBufferOwner(this);
 	}
 } // namespace Neon
@@ -6,17 +6,26 @@
 
 namespace Neon
 {
-	class VulkanIndexBuffer : public IndexBuffer
+	class VulkanIndexBuffer : public IndexBuffer, public VulkanBufferOwner
 	{
 	public:
 		VulkanIndexBuffer(const void* data, uint32 size);
-		~VulkanIndexBuffer() = default;
+		~VulkanIndexBuffer();
 
 		void* GetHandle() const override
 		{
 			return m_Buffer.Handle.get();
 		}
 
+		void GetMovableBuffers(std::vector<VulkanBuffer*>& outBuffers) override
+		{
+			outBuffers.push_back(&m_Buffer);
+		}
+		// Handle is fetched whenever the buffer is bound, nothing keeps the old one
+		void OnBuffersMoved() override
+		{
+		}
+
 	private:
 		VulkanBuffer m_Buffer;
 	};
@@ -19,17 +19,14 @@ namespace Neon
 		NEO_CORE_ASSERT(m_Specification.Pass, "RenderPass not initialized!");
 		SharedRef<VulkanRenderPass> vulkanRenderPass = SharedRef<VulkanRenderPass>(m_Specification.Pass);
 
-		vk::DescriptorSetLayout descriptorSetLayout = vulkanShader->GetDescriptorSetLayout();
-		// Create the pipeline layout that is used to generate the rendering pipelines that are based on this descriptor set layout
-		// In a more complex scenario you would have different pipeline layouts for different descriptor set layouts that could be reused
+		// Frame set first, then the material set of the shader
+		std::array<vk::DescriptorSetLayout, 2> descriptorSetLayouts = {
+			VulkanContext::GetFrameDescriptors().GetDescriptorSetLayout(), vulkanShader->GetDescriptorSetLayout()};
 		vk::PipelineLayoutCreateInfo pPipelineLayoutCreateInfo = {};
-		if (descriptorSetLayout)
-		{
-			pPipelineLayoutCreateInfo.setLayoutCount = 1;
-			pPipelineLayoutCreateInfo.pSetLayouts = &descriptorSetLayout;
-		}
+		pPipelineLayoutCreateInfo.setLayoutCount = static_cast<uint32>(descriptorSetLayouts.size());
+		pPipelineLayoutCreateInfo.pSetLayouts = descriptorSetLayouts.data();
 		std::vector<vk::PushConstantRange> pushConstantRanges;
-		for (const auto& [name, pushConstant] : vulkanShader->m_PushConstants)
+		for (const VulkanShader::PushConstant& pushConstant : vulkanShader->m_PushConstants)
 		{
 			pushConstantRanges.emplace_back(pushConstant.ShaderStage, 0, pushConstant.Size);
 		}
@@ -114,13 +111,19 @@ namespace Neon
 		// Vertex input descriptor
 		const VertexBufferLayout& layout = shader->GetVertexBufferLayout();
 
-		vk::VertexInputBindingDescription vertexInputBinding = {};
-		vertexInputBinding.binding = 0;
-		vertexInputBinding.stride = layout.GetStride();
-		vertexInputBinding.inputRate = vk::VertexInputRate::eVertex;
+		const VertexBufferLayout& instanceLayout = shader->GetInstanceLayout();
+
+		std::array<vk::VertexInputBindingDescription, 2> vertexInputBindings = {};
+		vertexInputBindings[0].binding = 0;
+		vertexInputBindings[0].stride = layout.GetStride();
+		vertexInputBindings[0].inputRate = vk::VertexInputRate::eVertex;
+		vertexInputBindings[1].binding = 1;
+		vertexInputBindings[1].stride = instanceLayout.GetStride();
+		vertexInputBindings[1].inputRate = vk::VertexInputRate::eInstance;
 
 		// Input attribute bindings describe shader attribute locations and memory layouts
-		std::vector<vk::VertexInputAttributeDescription> vertexInputAttribs(layout.GetElementCount());
+		std::vector<vk::VertexInputAttributeDescription> vertexInputAttribs(layout.GetElementCount() +
+																			instanceLayout.GetElementCount());
 
 		uint32_t location = 0;
 		for (auto element : layout)
@@ -132,13 +135,22 @@ namespace Neon
 
 			location++;
 		}
+		for (auto element : instanceLayout)
+		{
+			vertexInputAttribs[location].binding = 1;
+			vertexInputAttribs[location].location = location;
+			vertexInputAttribs[location].format = ConvertNeonShaderDataTypeToVulkanDataType(element.Type);
+			vertexInputAttribs[location].offset = element.Offset;
+
+			location++;
+		}
 
 		// Vertex input state used for pipeline creation
 		vk::PipelineVertexInputStateCreateInfo vertexInputState = {};
 		if (!vertexInputAttribs.empty())
 		{
-			vertexInputState.vertexBindingDescriptionCount = 1;
-			vertexInputState.pVertexBindingDescriptions = &vertexInputBinding;
+			vertexInputState.vertexBindingDescriptionCount = instanceLayout.GetElementCount() > 0 ? 2 : 1;
+			vertexInputState.pVertexBindingDescriptions = vertexInputBindings.data();
 			vertexInputState.vertexAttributeDescriptionCount = static_cast<uint32>(vertexInputAttribs.size());
 			vertexInputState.pVertexAttributeDescriptions = vertexInputAttribs.data();
 		}
@@ -158,15 +170,35 @@ namespace Neon
 		graphicsPipelineCreateInfo.pDepthStencilState = &depthStencilState;
 		graphicsPipelineCreateInfo.pDynamicState = &dynamicState;
 
-		// TODO: Pipeline cache??
-		/*
-		vk::PipelineCacheCreateInfo pipelineCacheCreateInfo = {};
-		VkPipelineCache pipelineCache;
-		device.createPipelineCache
-		VK_CHECK_RESULT(vkCreatePipelineCache(device, &pipelineCacheCreateInfo, nullptr, &pipelineCache));*/
+		// Everything else is fixed above, so the shader, vertex layout, render pass compatibility and polygon mode identify the
+		// pipeline
+		uint64 key = vulkanShader->GetHash();
+		VulkanPipelineCache::HashCombine(key, PipelineBindPoint::Graphics);
+		VulkanPipelineCache::HashCombine(key, m_Specification.Mode);
+		for (const vk::VertexInputBindingDescription& binding : vertexInputBindings)
+		{
+			VulkanPipelineCache::HashCombine(key, binding.stride);
+		}
+		for (const vk::VertexInputAttributeDescription& attribute : vertexInputAttribs)
+		{
+			VulkanPipelineCache::HashCombine(key, attribute);
+		}
+		// Render passes with matching attachments and subpasses are compatible, their handles don't matter
+		for (const auto& attachment : m_Specification.Pass->GetSpecification().Attachments)
+		{
+			VulkanPipelineCache::HashCombine(key, attachment.Format);
+			VulkanPipelineCache::HashCombine(key, attachment.Samples);
+		}
+		for (const Subpass& subpass : m_Specification.Pass->GetSpecification().Subpasses)
+		{
+			VulkanPipelineCache::HashCombine(key, subpass.EnableDepthStencil);
+			key = VulkanPipelineCache::Hash(subpass.InputAttachments.data(), subpass.InputAttachments.size() * sizeof(uint32), key);
+			key = VulkanPipelineCache::Hash(subpass.ColorAttachments.data(), subpass.ColorAttachments.size() * sizeof(uint32), key);
+			key = VulkanPipelineCache::Hash(subpass.ColorResolveAttachments.data(),
+											subpass.ColorResolveAttachments.size() * sizeof(uint32), key);
+		}
 
-		// Create rendering pipeline using the specified states
-		m_Handle = device.createGraphicsPipelineUnique(nullptr, graphicsPipelineCreateInfo);
+		m_Pipeline = VulkanContext::GetPipelineCache().GetOrCreateGraphicsPipeline(key, graphicsPipelineCreateInfo);
 	}
 
 	VulkanComputePipeline::VulkanComputePipeline(const SharedRef<Shader>& shader, const ComputePipelineSpecification& specification)
@@ -181,16 +213,14 @@ namespace Neon
 
 		SharedRef<VulkanShader> vulkanShader = SharedRef<VulkanShader>(shader);
 
-		vk::DescriptorSetLayout descriptorSetLayout = vulkanShader->GetDescriptorSetLayout();
-
+		// Frame set first, then the material set of the shader
+		std::array<vk::DescriptorSetLayout, 2> descriptorSetLayouts = {
+			VulkanContext::GetFrameDescriptors().GetDescriptorSetLayout(), vulkanShader->GetDescriptorSetLayout()};
 		vk::PipelineLayoutCreateInfo pPipelineLayoutCreateInfo = {};
-		if (descriptorSetLayout)
-		{
-			pPipelineLayoutCreateInfo.setLayoutCount = 1;
-			pPipelineLayoutCreateInfo.pSetLayouts = &descriptorSetLayout;
-		}
+		pPipelineLayoutCreateInfo.setLayoutCount = static_cast<uint32>(descriptorSetLayouts.size());
+		pPipelineLayoutCreateInfo.pSetLayouts = descriptorSetLayouts.data();
 		std::vector<vk::PushConstantRange> pushConstantRanges;
-		for (const auto& [name, pushConstant] : vulkanShader->m_PushConstants)
+		for (const VulkanShader::PushConstant& pushConstant : vulkanShader->m_PushConstants)
 		{
 			pushConstantRanges.emplace_back(pushConstant.ShaderStage, 0, pushConstant.Size);
 		}
@@ -203,7 +233,9 @@ namespace Neon
 		computePipelineCreateInfo.layout = m_PipelineLayout.get();
 		computePipelineCreateInfo.stage = vulkanShader->GetShaderStages()[0];
 
-		m_Handle = device.createComputePipelineUnique(nullptr, computePipelineCreateInfo);
+		uint64 key = vulkanShader->GetHash();
+		VulkanPipelineCache::HashCombine(key, PipelineBindPoint::Compute);
+		m_Pipeline = VulkanContext::GetPipelineCache().GetOrCreateComputePipeline(key, computePipelineCreateInfo);
 	}
 
 } // namespace Neon
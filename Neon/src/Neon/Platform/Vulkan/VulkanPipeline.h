@@ -2,6 +2,7 @@
 
 #include "Renderer/Pipeline.h"
 #include "Vulkan.h"
+#include "VulkanPipelineCache.h"
 
 namespace Neon
 {
@@ -65,12 +66,13 @@ namespace Neon
 
 		void* GetHandle() const override
 		{
-			return m_Handle.get();
+			return m_Pipeline->GetHandle();
 		}
 
 	private:
 		vk::UniquePipelineLayout m_PipelineLayout;
-		vk::UniquePipeline m_Handle;
+		// Shared with pipelines of identical state, bindable with our layout as the descriptor layouts are identical too
+		SharedRef<VulkanSharedPipeline> m_Pipeline;
 	};
 
 	class VulkanComputePipeline : public ComputePipeline
@@ -86,12 +88,13 @@ namespace Neon
 
 		void* GetHandle() const override
 		{
-			return m_Handle.get();
+			return m_Pipeline->GetHandle();
 		}
 
 	private:
 		vk::UniquePipelineLayout m_PipelineLayout;
-		vk::UniquePipeline m_Handle;
+		// Shared with pipelines of identical state, bindable with our layout as the descriptor layouts are identical too
+		SharedRef<VulkanSharedPipeline> m_Pipeline;
 	};
 
 } // namespace Neon
@@ -0,0 +1,185 @@
+#include "neopch.h"
+
+#include "Neon/Core/Profiler.h"
+#include "Neon/Tools/FileTools.h"
+#include "VulkanPipelineCache.h"
+
+#include <chrono>
+#include <filesystem>
+
+namespace Neon
+{
+	static constexpr uint32 c_PipelineCacheMagic = 0x4E504C43; // "NPLC"
+	static constexpr uint32 c_PipelineCacheVersion = 1;
+
+	VulkanPipelineCache::VulkanPipelineCache(const SharedRef<VulkanDevice>& device, const std::string& filePath)
+		: m_Device(device)
+		, m_FilePath(filePath)
+	{
+		NEO_PROFILE_FUNCTION();
+
+		std::vector<uint8> data = Load();
+		m_LoadedFromDisk = !data.empty();
+
+		vk::PipelineCacheCreateInfo createInfo{};
+		createInfo.initialDataSize = data.size();
+		createInfo.pInitialData = data.data();
+		m_Cache = device->GetHandle().createPipelineCacheUnique(createInfo);
+	}
+
+	VulkanPipelineCache::~VulkanPipelineCache()
+	{
+		NEO_CORE_INFO("VulkanPipelineCache: {0} start, created {1} pipelines in {2:.2f} ms, {3} requests shared an existing one",
+					  m_LoadedFromDisk ? "warm" : "cold", m_CreatedCount, m_CreationMilliseconds, m_SharedCount);
+		Save();
+	}
+
+	SharedRef<VulkanSharedPipeline> VulkanPipelineCache::GetOrCreateGraphicsPipeline(uint64 key,
+																					  const vk::GraphicsPipelineCreateInfo& createInfo)
+	{
+		if (SharedRef<VulkanSharedPipeline> pipeline = Find(key))
+		{
+			return pipeline;
+		}
+
+		NEO_PROFILE_SCOPE_CATEGORY("VulkanPipelineCache::CreateGraphicsPipeline", "Pipeline");
+
+		auto start = std::chrono::steady_clock::now();
+		vk::UniquePipeline pipeline = m_Device->GetHandle().createGraphicsPipelineUnique(m_Cache.get(), createInfo);
+		double milliseconds =
+			std::chrono::duration<double, std::chrono::milliseconds::period>(std::chrono::steady_clock::now() - start).count();
+
+		return Register(key, std::move(pipeline), milliseconds);
+	}
+
+	SharedRef<VulkanSharedPipeline> VulkanPipelineCache::GetOrCreateComputePipeline(uint64 key,
+																					 const vk::ComputePipelineCreateInfo& createInfo)
+	{
+		if (SharedRef<VulkanSharedPipeline> pipeline = Find(key))
+		{
+			return pipeline;
+		}
+
+		NEO_PROFILE_SCOPE_CATEGORY("VulkanPipelineCache::CreateComputePipeline", "Pipeline");
+
+		auto start = std::chrono::steady_clock::now();
+		vk::UniquePipeline pipeline = m_Device->GetHandle().createComputePipelineUnique(m_Cache.get(), createInfo);
+		double milliseconds =
+			std::chrono::duration<double, std::chrono::milliseconds::period>(std::chrono::steady_clock::now() - start).count();
+
+		return Register(key, std::move(pipeline), milliseconds);
+	}
+
+	uint64 VulkanPipelineCache::Hash(const void* data, size_t size, uint64 hash /*= c_HashOffset*/)
+	{
+		const uint8* bytes = static_cast<const uint8*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	VulkanPipelineCache::FileHeader VulkanPipelineCache::GetDeviceHeader() const
+	{
+		vk::PhysicalDevice physicalDevice = m_Device->GetPhysicalDevice()->GetHandle();
+		auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>();
+		const vk::PhysicalDeviceProperties& deviceProperties = properties.get<vk::PhysicalDeviceProperties2>().properties;
+		const vk::PhysicalDeviceIDProperties& idProperties = properties.get<vk::PhysicalDeviceIDProperties>();
+
+		FileHeader header;
+		header.Magic = c_PipelineCacheMagic;
+		header.Version = c_PipelineCacheVersion;
+		header.VendorID = deviceProperties.vendorID;
+		header.DeviceID = deviceProperties.deviceID;
+		header.DriverVersion = deviceProperties.driverVersion;
+		memcpy(header.DeviceUUID, idProperties.deviceUUID.data(), VK_UUID_SIZE);
+		memcpy(header.PipelineCacheUUID, deviceProperties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+		return header;
+	}
+
+	std::vector<uint8> VulkanPipelineCache::Load() const
+	{
+		std::vector<uint8> file;
+		if (!File::ReadFromFile(m_FilePath, file, true) || file.size() < sizeof(FileHeader))
+		{
+			return {};
+		}
+
+		FileHeader header;
+		memcpy(&header, file.data(), sizeof(FileHeader));
+		FileHeader deviceHeader = GetDeviceHeader();
+
+		// A driver update or a different GPU invalidates the cache, the driver would reject or even crash on foreign data
+		if (header.Magic != deviceHeader.Magic || header.Version != deviceHeader.Version ||
+			header.VendorID != deviceHeader.VendorID || header.DeviceID != deviceHeader.DeviceID ||
+			header.DriverVersion != deviceHeader.DriverVersion ||
+			memcmp(header.DeviceUUID, deviceHeader.DeviceUUID, VK_UUID_SIZE) != 0 ||
+			memcmp(header.PipelineCacheUUID, deviceHeader.PipelineCacheUUID, VK_UUID_SIZE) != 0)
+		{
+			NEO_CORE_INFO("VulkanPipelineCache: {0} was written by another device or driver, starting cold", m_FilePath);
+			return {};
+		}
+
+		std::vector<uint8> data(file.begin() + sizeof(FileHeader), file.end());
+		if (data.size() != header.DataSize || Hash(data.data(), data.size()) != header.DataHash)
+		{
+			NEO_CORE_WARN("VulkanPipelineCache: {0} is corrupted, starting cold", m_FilePath);
+			return {};
+		}
+		return data;
+	}
+
+	void VulkanPipelineCache::Save() const
+	{
+		std::vector<uint8> data = m_Device->GetHandle().getPipelineCacheData(m_Cache.get());
+
+		FileHeader header = GetDeviceHeader();
+		header.DataSize = data.size();
+		header.DataHash = Hash(data.data(), data.size());
+
+		std::vector<uint8> file(sizeof(FileHeader));
+		memcpy(file.data(), &header, sizeof(FileHeader));
+		file.insert(file.end(), data.begin(), data.end());
+
+		std::filesystem::create_directories(std::filesystem::path(m_FilePath).parent_path());
+		File::WriteToFile(m_FilePath, file, true);
+	}
+
+	SharedRef<VulkanSharedPipeline> VulkanPipelineCache::Find(uint64 key)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto it = m_Pipelines.find(key);
+		if (it == m_Pipelines.end())
+		{
+			return nullptr;
+		}
+
+		SharedRef<VulkanSharedPipeline> pipeline = it->second.Lock();
+		if (pipeline)
+		{
+			m_SharedCount++;
+		}
+		return pipeline;
+	}
+
+	SharedRef<VulkanSharedPipeline> VulkanPipelineCache::Register(uint64 key, vk::UniquePipeline pipeline, double milliseconds)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		m_CreatedCount++;
+		m_CreationMilliseconds += milliseconds;
+
+		// Another thread may have created the same pipeline meanwhile, the first one registered is kept
+		WeakRef<VulkanSharedPipeline>& entry = m_Pipelines[key];
+		if (SharedRef<VulkanSharedPipeline> registered = entry.Lock())
+		{
+			return registered;
+		}
+
+		SharedRef<VulkanSharedPipeline> sharedPipeline = SharedRef<VulkanSharedPipeline>::Create(std::move(pipeline));
+		entry = sharedPipeline;
+		return sharedPipeline;
+	}
+} // namespace Neon
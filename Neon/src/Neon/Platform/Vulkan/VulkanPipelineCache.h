@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Vulkan.h"
+#include "VulkanDevice.h"
+
+#include <mutex>
+
+namespace Neon
+{
+	// Pipeline object shared by all pipelines created from identical state
+	class VulkanSharedPipeline : public RefCounted
+	{
+	public:
+		VulkanSharedPipeline(vk::UniquePipeline handle)
+			: m_Handle(std::move(handle))
+		{
+		}
+
+		vk::Pipeline GetHandle() const
+		{
+			return m_Handle.get();
+		}
+
+	private:
+		vk::UniquePipeline m_Handle;
+	};
+
+	// Registry of the pipelines currently alive, keyed by a hash of the state they were created from. New pipelines are
+	// created through a VkPipelineCache which is loaded from disk on startup and written back on destruction, the file is
+	// only used if it was written by the same device and driver.
+	class VulkanPipelineCache
+	{
+	public:
+		// FNV-1a, stable across runs so keys could be persisted as well
+		static constexpr uint64 c_HashOffset = 14695981039346656037ull;
+
+	public:
+		VulkanPipelineCache(const SharedRef<VulkanDevice>& device, const std::string& filePath);
+		~VulkanPipelineCache();
+
+		SharedRef<VulkanSharedPipeline> GetOrCreateGraphicsPipeline(uint64 key, const vk::GraphicsPipelineCreateInfo& createInfo);
+		SharedRef<VulkanSharedPipeline> GetOrCreateComputePipeline(uint64 key, const vk::ComputePipelineCreateInfo& createInfo);
+
+		static uint64 Hash(const void* data, size_t size, uint64 hash = c_HashOffset);
+		template<typename T>
+		static void HashCombine(uint64& hash, const T& value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be hashed!");
+			hash = Hash(&value, sizeof(T), hash);
+		}
+
+	private:
+		struct FileHeader
+		{
+			uint32 Magic = 0;
+			uint32 Version = 0;
+			uint32 VendorID = 0;
+			uint32 DeviceID = 0;
+			uint32 DriverVersion = 0;
+			uint8 DeviceUUID[VK_UUID_SIZE] = {};
+			uint8 PipelineCacheUUID[VK_UUID_SIZE] = {};
+			uint64 DataSize = 0;
+			uint64 DataHash = 0;
+		};
+
+		FileHeader GetDeviceHeader() const;
+		std::vector<uint8> Load() const;
+		void Save() const;
+
+		SharedRef<VulkanSharedPipeline> Find(uint64 key);
+		SharedRef<VulkanSharedPipeline> Register(uint64 key, vk::UniquePipeline pipeline, double milliseconds);
+
+	private:
+		SharedRef<VulkanDevice> m_Device;
+		std::string m_FilePath;
+
+		vk::UniquePipelineCache m_Cache;
+		bool m_LoadedFromDisk = false;
+
+		std::mutex m_Mutex;
+		std::unordered_map<uint64, WeakRef<VulkanSharedPipeline>> m_Pipelines;
+
+		// Compared between cold and warm starts to see what the disk cache saves
+		uint32 m_CreatedCount = 0;
+		uint32 m_SharedCount = 0;
+		double m_CreationMilliseconds = 0.0;
+	};
+} // namespace Neon
@@ -1,5 +1,6 @@
 #include "neopch.h"
 
+#include "Neon/Core/Profiler.h"
 #include "Neon/Platform/Vulkan/VulkanContext.h"
 #include "Neon/Platform/Vulkan/VulkanTexture.h"
 #include "VulkanRenderPass.h"
@@ -11,6 +12,11 @@ namespace Neon
 	{
 		const auto& device = VulkanContext::GetDevice();
 
+		if (!specification.DebugName.empty())
+		{
+			m_ProfileName = Profiler::InternString(specification.DebugName);
+		}
+
 		std::vector<std::vector<vk::AttachmentReference>> inputAttachmentReferences{specification.Subpasses.size()};
 		std::vector<std::vector<vk::AttachmentReference>> colorAttachmentReferences{specification.Subpasses.size()};
 		std::vector<std::vector<vk::AttachmentReference>> depthStencilAttachmentReferences{specification.Subpasses.size()};
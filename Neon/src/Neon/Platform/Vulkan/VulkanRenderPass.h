@@ -67,7 +67,14 @@ namespace Neon
 			return m_Handle.get();
 		}
 
+		// Interned debug name, labels the GPU timestamps of the pass
+		const char* GetProfileName() const
+		{
+			return m_ProfileName;
+		}
+
 	private:
 		vk::UniqueRenderPass m_Handle;
+		const char* m_ProfileName = "RenderPass";
 	};
 } // namespace Neon
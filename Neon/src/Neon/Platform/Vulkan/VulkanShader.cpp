@@ -1,509 +1,390 @@
 #include "neopch.h"
 
+#include "Neon/Core/FrameAllocator.h"
+#include "Neon/Core/Profiler.h"
 #include "Neon/Platform/Vulkan/VulkanContext.h"
 #include "Neon/Platform/Vulkan/VulkanShader.h"
 #include "Neon/Platform/Vulkan/VulkanTexture.h"
-#include "Neon/Tools/FileTools.h"
-
-#include <spirv_glsl.hpp>
-
-#include <filesystem>
 
 namespace Neon
 {
-	static vk::ShaderStageFlagBits ShaderTypeToVulkanShaderType(ShaderType shaderType)
-	{
-		switch (shaderType)
-		{
-			case ShaderType::Geometry:
-				return vk::ShaderStageFlagBits::eGeometry;
-			case ShaderType::Vertex:
-				return vk::ShaderStageFlagBits::eVertex;
-			case ShaderType::Fragment:
-				return vk::ShaderStageFlagBits::eFragment;
-			case ShaderType::Compute:
-				return vk::ShaderStageFlagBits::eCompute;
-			default:
-				NEO_CORE_ASSERT(false, "Uknown shader type!");
-				return vk::ShaderStageFlagBits();
-		}
-	}
-
 	VulkanShader::VulkanShader(const ShaderSpecification& specification)
 		: Shader(specification)
 	{
 		const auto& device = VulkanContext::GetDevice();
 		m_Allocator = VulkanAllocator(device, "Shader");
+		m_ProfileName = Profiler::InternString(m_Name);
 		Reload();
+
+		VulkanAllocator::RegisterBufferOwner(this);
+	}
+
+	VulkanShader::~VulkanShader()
+	{
+		VulkanAllocator::UnregisterBufferOwner(this);
 	}
 
 	void VulkanShader::Reload()
 	{
-		for (const auto& [shaderType, shaderPath] : m_Specification.ShaderPaths)
+		NEO_PROFILE_SCOPE_CATEGORY("VulkanShader::Reload", "Shader");
+
+		m_Program = VulkanShaderLibrary::GetOrLoad(m_Specification);
+		CreateDescriptors();
+	}
+
+	void VulkanShader::GetMovableBuffers(std::vector<VulkanBuffer*>& outBuffers)
+	{
+		for (UniformBuffer& uniformBuffer : m_UniformBuffers)
 		{
-			std::vector<char> shaderSource;
-			bool fileRead = File::ReadFromFile(shaderPath, shaderSource, true);
-			std::string strShader(shaderSource.begin(), shaderSource.end());
-			NEO_CORE_ASSERT(fileRead, "Shader path does not exist!");
-			m_ShaderSources[shaderType] = std::string(shaderSource.begin(), shaderSource.end());
+			for (VulkanBuffer& buffer : uniformBuffer.Buffers)
+			{
+				outBuffers.push_back(&buffer);
+			}
 		}
 
-		for (const auto& [shaderType, shaderSource] : m_ShaderSources)
+		for (StorageBuffer& storageBuffer : m_StorageBuffers)
 		{
-			std::vector<uint32> shaderBinary;
-			GetVulkanShaderBinary(shaderType, shaderBinary, false);
-			CreateShader(shaderType, shaderBinary);
-			Reflect(shaderType, shaderBinary);
+			outBuffers.push_back(&storageBuffer.BufferData);
 		}
-		CreateDescriptors();
 	}
 
-	void VulkanShader::SetUniformBuffer(const std::string& name, uint32 index, const void* data, uint32 size /*= 0*/)
+	void VulkanShader::OnBuffersMoved()
 	{
-		NEO_CORE_ASSERT(m_UniformBuffers.find(name) != m_UniformBuffers.end(), "Unknown uniform buffer name!");
-		NEO_CORE_ASSERT(index < m_UniformBuffers[name].Count, "Descriptor index out of range!");
-		m_Allocator.UpdateBuffer(m_UniformBuffers[name].Buffers[index], data, size);
+		// Mappings moved along with the memory, only the pointers into it changed
+		for (UniformBuffer& uniformBuffer : m_UniformBuffers)
+		{
+			for (uint32 i = 0; i < uniformBuffer.Buffers.size(); i++)
+			{
+				uniformBuffer.MappedData[i] = static_cast<byte*>(uniformBuffer.Buffers[i].Memory.Map());
+				uniformBuffer.Buffers[i].Memory.Unmap();
+			}
+		}
+
+		// Buffer writes still pending might refer to destroyed handles, they are replaced by the rewrite
+		m_PendingWrites.erase(
+			std::remove_if(m_PendingWrites.begin(), m_PendingWrites.end(),
+						   [](const auto& write) { return static_cast<bool>(std::get<0>(write).buffer); }),
+			m_PendingWrites.end());
+		WriteBufferDescriptors();
 	}
 
-	void VulkanShader::SetStorageBuffer(const std::string& name, const void* data, uint32 size /*= 0*/)
+	void VulkanShader::SetUniformBuffer(const ShaderParamHandle& name, uint32 index, const void* data, uint32 size /*= 0*/)
 	{
-		NEO_CORE_ASSERT(m_StorageBuffers.find(name) != m_StorageBuffers.end(), "Unknown storage buffer name!");
-		m_Allocator.UpdateBuffer(m_StorageBuffers[name].BufferData, data, size);
+		UniformBuffer& uniformBuffer = m_UniformBuffers[GetParamIndex(name, ShaderResourceKind::UniformBuffer)];
+		NEO_CORE_ASSERT(index < uniformBuffer.Count, "Descriptor index out of range!");
+		NEO_CORE_ASSERT(size <= uniformBuffer.Size, "Buffer out of range!");
+		size = size == 0 ? uniformBuffer.Size : size;
+
+		if (uniformBuffer.Dynamic)
+		{
+			// Unchanged data keeps its ring allocation
+			if (memcmp(uniformBuffer.Data.data(), data, size) != 0)
+			{
+				memcpy(uniformBuffer.Data.data(), data, size);
+				uniformBuffer.Dirty = true;
+			}
+		}
+		else
+		{
+			memcpy(uniformBuffer.MappedData[index], data, size);
+		}
+	}
+
+	void VulkanShader::SetStorageBuffer(const ShaderParamHandle& name, const void* data, uint32 size /*= 0*/)
+	{
+		StorageBuffer& storageBuffer = m_StorageBuffers[GetParamIndex(name, ShaderResourceKind::StorageBuffer)];
+		m_Allocator.UpdateBuffer(storageBuffer.BufferData, data, size);
 	}
 
-	void VulkanShader::SetPushConstant(const std::string& name, const void* data, uint32 size /*= 0*/)
+	void VulkanShader::ReadStorageBuffer(const ShaderParamHandle& name, void* outData, uint32 size /*= 0*/) const
 	{
-		NEO_CORE_ASSERT(m_PushConstants.find(name) != m_PushConstants.end(), "Unknown push constant name!");
-		NEO_CORE_ASSERT(size <= m_PushConstants[name].Size);
-		size = size == 0 ? m_PushConstants[name].Size : size;
-		memcpy(m_PushConstants[name].Data.get(), data, size);
+		const StorageBuffer& storageBuffer = m_StorageBuffers[GetParamIndex(name, ShaderResourceKind::StorageBuffer)];
+		m_Allocator.ReadBuffer(storageBuffer.BufferData, outData, size);
 	}
 
-	void VulkanShader::SetTexture2D(const std::string& name, uint32 index, const SharedRef<Texture2D>& texture, uint32 mipLevel)
+	void VulkanShader::SetPushConstant(const ShaderParamHandle& name, const void* data, uint32 size /*= 0*/)
 	{
-		NEO_CORE_ASSERT(index < m_ImageSamplers[name].Count);
+		PushConstant& pushConstant = m_PushConstants[GetParamIndex(name, ShaderResourceKind::PushConstant)];
+		NEO_CORE_ASSERT(size <= pushConstant.Size);
+		size = size == 0 ? pushConstant.Size : size;
+		memcpy(pushConstant.Data.get(), data, size);
+	}
+
+	void VulkanShader::SetTexture2D(const ShaderParamHandle& name, uint32 index, const SharedRef<Texture2D>& texture,
+									uint32 mipLevel)
+	{
+		ImageSampler& imageSampler = m_ImageSamplers[GetParamIndex(name, ShaderResourceKind::ImageSampler)];
+		NEO_CORE_ASSERT(index < imageSampler.Count);
 
 		const auto vulkanTexture = texture.As<VulkanTexture2D>();
 		auto& imageInfo = vulkanTexture->GetTextureDescription(mipLevel);
 
 		vk::WriteDescriptorSet descWrite{
-			m_DescriptorSet.get(), m_NameBindingMap[name], index, 1, vk::DescriptorType::eCombinedImageSampler, &imageInfo};
+			m_DescriptorSet.get(), imageSampler.BindingPoint, index, 1, vk::DescriptorType::eCombinedImageSampler, &imageInfo};
 		m_PendingWrites.emplace_back(nullptr, imageInfo, descWrite);
 
-		RendererContext::Get()->SafeDeleteResource(StaleResourceWrapper::Create(m_ImageSamplers[name].Textures[index]));
-		m_ImageSamplers[name].Textures[index] = texture;
+		RendererContext::Get()->SafeDeleteResource(StaleResourceWrapper::Create(imageSampler.Textures[index]));
+		imageSampler.Textures[index] = texture;
 	}
 
-	void VulkanShader::SetStorageTexture2D(const std::string& name, uint32 index, const SharedRef<Texture2D>& texture,
+	void VulkanShader::SetStorageTexture2D(const ShaderParamHandle& name, uint32 index, const SharedRef<Texture2D>& texture,
 										   uint32 mipLevel)
 	{
-		NEO_CORE_ASSERT(index < m_StorageImages[name].Count);
+		StorageImage& storageImage = m_StorageImages[GetParamIndex(name, ShaderResourceKind::StorageImage)];
+		NEO_CORE_ASSERT(index < storageImage.Count);
 
 		const auto vulkanTexture = texture.As<VulkanTexture2D>();
 		auto& imageInfo = vulkanTexture->GetTextureDescription(mipLevel);
 
 		vk::WriteDescriptorSet descWrite{
-			m_DescriptorSet.get(), m_NameBindingMap[name], index, 1, vk::DescriptorType::eStorageImage, &imageInfo};
+			m_DescriptorSet.get(), storageImage.BindingPoint, index, 1, vk::DescriptorType::eStorageImage, &imageInfo};
 		m_PendingWrites.emplace_back(nullptr, imageInfo, descWrite);
 
-		RendererContext::Get()->SafeDeleteResource(StaleResourceWrapper::Create(m_StorageImages[name].Textures[index]));
-		m_StorageImages[name].Textures[index] = texture;
+		RendererContext::Get()->SafeDeleteResource(StaleResourceWrapper::Create(storageImage.Textures[index]));
+		storageImage.Textures[index] = texture;
 	}
 
-	void VulkanShader::SetTextureCube(const std::string& name, uint32 index, const SharedRef<TextureCube>& texture, uint32 mipLevel)
+	void VulkanShader::SetTextureCube(const ShaderParamHandle& name, uint32 index, const SharedRef<TextureCube>& texture,
+									  uint32 mipLevel)
 	{
-		NEO_CORE_ASSERT(index < m_ImageSamplers[name].Count);
+		ImageSampler& imageSampler = m_ImageSamplers[GetParamIndex(name, ShaderResourceKind::ImageSampler)];
+		NEO_CORE_ASSERT(index < imageSampler.Count);
 
 		const auto vulkanTexture = texture.As<VulkanTextureCube>();
 		auto& imageInfo = vulkanTexture->GetTextureDescription(mipLevel);
 
 		vk::WriteDescriptorSet descWrite{
-			m_DescriptorSet.get(), m_NameBindingMap[name], index, 1, vk::DescriptorType::eCombinedImageSampler, &imageInfo};
+			m_DescriptorSet.get(), imageSampler.BindingPoint, index, 1, vk::DescriptorType::eCombinedImageSampler, &imageInfo};
 		m_PendingWrites.emplace_back(nullptr, imageInfo, descWrite);
 
-		RendererContext::Get()->SafeDeleteResource(StaleResourceWrapper::Create(m_ImageSamplers[name].Textures[index]));
-		m_ImageSamplers[name].Textures[index] = texture;
+		RendererContext::Get()->SafeDeleteResource(StaleResourceWrapper::Create(imageSampler.Textures[index]));
+		imageSampler.Textures[index] = texture;
 	}
 
-	void VulkanShader::SetStorageTextureCube(const std::string& name, uint32 index, const SharedRef<TextureCube>& texture,
+	void VulkanShader::SetStorageTextureCube(const ShaderParamHandle& name, uint32 index, const SharedRef<TextureCube>& texture,
 											 uint32 mipLevel)
 	{
-		NEO_CORE_ASSERT(index < m_StorageImages[name].Count);
+		StorageImage& storageImage = m_StorageImages[GetParamIndex(name, ShaderResourceKind::StorageImage)];
+		NEO_CORE_ASSERT(index < storageImage.Count);
 
 		const auto vulkanTexture = texture.As<VulkanTextureCube>();
 		auto& imageInfo = vulkanTexture->GetTextureDescription(mipLevel);
 
 		vk::WriteDescriptorSet descWrite{
-			m_DescriptorSet.get(), m_NameBindingMap[name], index, 1, vk::DescriptorType::eStorageImage, &imageInfo};
+			m_DescriptorSet.get(), storageImage.BindingPoint, index, 1, vk::DescriptorType::eStorageImage, &imageInfo};
 		m_PendingWrites.emplace_back(nullptr, imageInfo, descWrite);
 
-		RendererContext::Get()->SafeDeleteResource(StaleResourceWrapper::Create(m_StorageImages[name].Textures[index]));
-		m_StorageImages[name].Textures[index] = texture;
+		RendererContext::Get()->SafeDeleteResource(StaleResourceWrapper::Create(storageImage.Textures[index]));
+		storageImage.Textures[index] = texture;
 	}
 
-	SharedRef<Texture2D> VulkanShader::GetTexture2D(const std::string& name, uint32 index) const
+	SharedRef<Texture2D> VulkanShader::GetTexture2D(const ShaderParamHandle& name, uint32 index) const
 	{
-		NEO_CORE_ASSERT(m_ImageSamplers.find(name) != m_ImageSamplers.end());
-		NEO_CORE_ASSERT(index >= 0 && index < m_ImageSamplers.at(name).Textures.size());
-		return m_ImageSamplers.at(name).Textures[index].As<Texture2D>();
+		const ImageSampler& imageSampler = m_ImageSamplers[GetParamIndex(name, ShaderResourceKind::ImageSampler)];
+		NEO_CORE_ASSERT(index < imageSampler.Textures.size());
+		return imageSampler.Textures[index].As<Texture2D>();
 	}
 
-	SharedRef<TextureCube> VulkanShader::GetTextureCube(const std::string& name, uint32 index) const
+	SharedRef<TextureCube> VulkanShader::GetTextureCube(const ShaderParamHandle& name, uint32 index) const
 	{
-		NEO_CORE_ASSERT(m_ImageSamplers.find(name) != m_ImageSamplers.end());
-		NEO_CORE_ASSERT(index >= 0 && index < m_ImageSamplers.at(name).Textures.size());
-		return m_ImageSamplers.at(name).Textures[index].As<TextureCube>();
+		const ImageSampler& imageSampler = m_ImageSamplers[GetParamIndex(name, ShaderResourceKind::ImageSampler)];
+		NEO_CORE_ASSERT(index < imageSampler.Textures.size());
+		return imageSampler.Textures[index].As<TextureCube>();
 	}
 
-	void VulkanShader::PrepareDescriptorSet()
+	bool VulkanShader::PrepareDescriptorSet()
 	{
-		if (!m_PendingWrites.empty())
+		if (m_PendingWrites.empty())
 		{
-			vk::Device device = VulkanContext::GetDevice()->GetHandle();
-
-			std::vector<vk::WriteDescriptorSet> writes;
-
-			for (auto& [bufferInfo, imageInfo, descWrite] : m_PendingWrites)
-			{
-				descWrite.pBufferInfo = &bufferInfo;
-				descWrite.pImageInfo = &imageInfo;
-				writes.push_back(descWrite);
-			}
-
-			device.updateDescriptorSets(writes, {});
-
-			m_PendingWrites.clear();
+			return false;
 		}
-	}
 
-	void VulkanShader::GetVulkanShaderBinary(ShaderType shaderType, std::vector<uint32>& outShaderBinary, bool forceCompile)
-	{
-		std::string shaderPath = m_Specification.ShaderPaths.at(shaderType);
-		std::filesystem::path p = shaderPath;
-
-		std::string folderPath = (p.parent_path() / "cached\\").string();
-		wchar_t wtext[40];
-		mbstowcs(wtext, folderPath.c_str(), folderPath.length());
-		wtext[folderPath.length()] = '\0';
-		CreateDirectory(wtext, nullptr);
-
-		auto cachePath = p.parent_path() / "cached" / (p.filename().string() + ".cached_vulkan");
-		std::string cachedFilePath = cachePath.string();
+		vk::Device device = VulkanContext::GetDevice()->GetHandle();
 
-		File::ReadFromFile(cachedFilePath, outShaderBinary, true);
+		FrameVector<vk::WriteDescriptorSet> writes;
+		writes.reserve(m_PendingWrites.size());
 
-		if (forceCompile || outShaderBinary.empty())
+		for (auto& [bufferInfo, imageInfo, descWrite] : m_PendingWrites)
 		{
-			shaderc::Compiler compiler;
-			shaderc::CompileOptions options;
-			options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
-
-			const bool optimize = false;
-			if (optimize)
-			{
-				options.SetOptimizationLevel(shaderc_optimization_level_performance);
-			}
-
-			auto& shaderSource = m_ShaderSources.at(shaderType);
-			shaderc::SpvCompilationResult module =
-				compiler.CompileGlslToSpv(shaderSource, ShaderTypeToShadercShaderType(shaderType), shaderPath.c_str(), options);
-
-			if (module.GetCompilationStatus() != shaderc_compilation_status_success)
-			{
-				NEO_CORE_ERROR(module.GetErrorMessage());
-				NEO_CORE_ASSERT(false);
-			}
-
-			outShaderBinary = std::vector<uint32>(module.cbegin(), module.cend());
-
-			File::WriteToFile(cachedFilePath, outShaderBinary, true);
+			descWrite.pBufferInfo = &bufferInfo;
+			descWrite.pImageInfo = &imageInfo;
+			writes.push_back(descWrite);
 		}
-	}
 
-	void VulkanShader::CreateShader(ShaderType shaderType, const std::vector<uint32>& shaderBinary)
-	{
-		const vk::Device device = VulkanContext::GetDevice()->GetHandle();
-		vk::ShaderModuleCreateInfo createInfo{{}, shaderBinary.size() * sizeof(uint32), shaderBinary.data()};
-		m_ShaderModules.push_back(device.createShaderModuleUnique(createInfo));
+		device.updateDescriptorSets(writes, {});
 
-		m_ShaderStages.push_back({{}, ShaderTypeToVulkanShaderType(shaderType), m_ShaderModules.back().get(), "main"});
+		m_PendingWrites.clear();
+		return true;
 	}
 
-	void VulkanShader::Reflect(ShaderType shaderType, const std::vector<uint32>& shaderBinary)
+	bool VulkanShader::PrepareDynamicOffsets(std::array<uint32, c_MaxDynamicUniformBuffers>& outOffsets, uint32& outCount)
 	{
-		vk::Device device = VulkanContext::GetDevice()->GetHandle();
-
-		NEO_CORE_TRACE("===========================");
-		NEO_CORE_TRACE(" Vulkan Shader Reflection");
-		NEO_CORE_TRACE(" {0}", m_Specification.ShaderPaths.at(shaderType));
-		NEO_CORE_TRACE("===========================");
-
-		spirv_cross::Compiler compiler(shaderBinary);
-		auto resources = compiler.get_shader_resources();
-
-		NEO_CORE_TRACE("Uniform Buffers:");
-		for (const auto& resource : resources.uniform_buffers)
+		outCount = 0;
+		if (m_DynamicUniformBuffers.empty())
 		{
-			const auto& name = resource.name;
-			auto& bufferType = compiler.get_type(resource.type_id);
-			uint32 bindingPoint = compiler.get_decoration(resource.id, spv::DecorationBinding);
-			uint32 count = std::max(1u, bufferType.array[0]);
-			if (m_Specification.ShaderVariableCounts.find(name) != m_Specification.ShaderVariableCounts.end())
-			{
-				count = m_Specification.ShaderVariableCounts[name];
-			}
-
-			auto size = static_cast<uint32>(compiler.get_declared_struct_size(bufferType));
-			auto memberCount = static_cast<uint32>(bufferType.member_types.size());
-
-			m_NameBindingMap[name] = bindingPoint;
-			UniformBuffer& buffer = m_UniformBuffers[name];
-			buffer.Name = name;
-			buffer.BindingPoint = bindingPoint;
-			buffer.Count = count;
-			buffer.Size = size;
-			buffer.ShaderStage |= ShaderTypeToVulkanShaderType(shaderType);
-
-			NEO_CORE_TRACE("  Name: {0}", name);
-			NEO_CORE_TRACE("  Count: {0}", count);
-			NEO_CORE_TRACE("  Member Count: {0}", memberCount);
-			NEO_CORE_TRACE("  Binding Point: {0}", bindingPoint);
-			NEO_CORE_TRACE("  Size: {0}", size);
-			NEO_CORE_TRACE("-------------------");
+			return true;
 		}
 
-		NEO_CORE_TRACE("Storage Buffers:");
-		for (const auto& resource : resources.storage_buffers)
-		{
-			const auto& name = resource.name;
-			auto& bufferType = compiler.get_type(resource.type_id);
-			uint32 bindingPoint = compiler.get_decoration(resource.id, spv::DecorationBinding);
+		VulkanUniformBufferRing& ring = VulkanContext::GetUniformBufferRing();
 
-			auto size = static_cast<uint32>(compiler.get_declared_struct_size(bufferType));
-			auto memberCount = static_cast<uint32>(bufferType.member_types.size());
-			if (size == 0)
+		for (UniformBuffer* uniformBuffer : m_DynamicUniformBuffers)
+		{
+			// Ring region of an older frame might be reused by now
+			if (uniformBuffer->Dirty || uniformBuffer->RingFrameNumber != ring.GetFrameNumber())
 			{
-				for (uint32 i = 0; i < memberCount; i++)
+				if (!ring.Push(uniformBuffer->Data.data(), uniformBuffer->Size, uniformBuffer->RingOffset))
 				{
-					size += compiler.type_struct_member_array_stride(bufferType, i);
+					return false;
 				}
+				uniformBuffer->RingFrameNumber = ring.GetFrameNumber();
+				uniformBuffer->Dirty = false;
 			}
-
-			m_NameBindingMap[name] = bindingPoint;
-			StorageBuffer& buffer = m_StorageBuffers[name];
-			buffer.Name = name;
-			buffer.BindingPoint = bindingPoint;
-			buffer.Size = size * m_Specification.ShaderVariableCounts[name];
-			buffer.ShaderStage |= ShaderTypeToVulkanShaderType(shaderType);
-
-			NEO_CORE_TRACE("  Name: {0}", name);
-			NEO_CORE_TRACE("  Member Count: {0}", memberCount);
-			NEO_CORE_TRACE("  Binding Point: {0}", bindingPoint);
-			NEO_CORE_TRACE("  Size: {0}", size);
-			NEO_CORE_TRACE("-------------------");
-		}
-
-		NEO_CORE_TRACE("Image Samplers:");
-		for (const auto& resource : resources.sampled_images)
-		{
-			const auto& name = resource.name;
-			auto& imageSamplerType = compiler.get_type(resource.base_type_id);
-			uint32 bindingPoint = compiler.get_decoration(resource.id, spv::DecorationBinding);
-			uint32 count = std::max(1u, imageSamplerType.array[0]);
-			if (m_Specification.ShaderVariableCounts.find(name) != m_Specification.ShaderVariableCounts.end())
-			{
-				count = m_Specification.ShaderVariableCounts[name];
-			}
-			uint32 dimension = imageSamplerType.image.dim;
-
-			m_NameBindingMap[name] = bindingPoint;
-			auto& imageSampler = m_ImageSamplers[name];
-			imageSampler.BindingPoint = bindingPoint;
-			imageSampler.Name = name;
-			imageSampler.Count = count;
-			imageSampler.ShaderStage |= ShaderTypeToVulkanShaderType(shaderType);
-			imageSampler.Textures.resize(count);
-
-			NEO_CORE_TRACE("  Name: {0}", name);
-			NEO_CORE_TRACE("  Count: {0}", count);
-			NEO_CORE_TRACE("  Binding Point: {0}", bindingPoint);
-			NEO_CORE_TRACE("-------------------");
+			outOffsets[outCount++] = uniformBuffer->RingOffset;
 		}
-
-		NEO_CORE_TRACE("Storage Images:");
-		for (const auto& resource : resources.storage_images)
-		{
-			const auto& name = resource.name;
-			auto& storageImageType = compiler.get_type(resource.base_type_id);
-			uint32 bindingPoint = compiler.get_decoration(resource.id, spv::DecorationBinding);
-			uint32 count = std::max(1u, storageImageType.array[0]);
-			if (m_Specification.ShaderVariableCounts.find(name) != m_Specification.ShaderVariableCounts.end())
-			{
-				count = m_Specification.ShaderVariableCounts[name];
-			}
-			uint32 dimension = storageImageType.image.dim;
-
-			m_NameBindingMap[name] = bindingPoint;
-			auto& storageImage = m_StorageImages[name];
-			storageImage.BindingPoint = bindingPoint;
-			storageImage.Name = name;
-			storageImage.Count = count;
-			storageImage.ShaderStage |= ShaderTypeToVulkanShaderType(shaderType);
-			storageImage.Textures.resize(count);
-
-			NEO_CORE_TRACE("  Name: {0}", name);
-			NEO_CORE_TRACE("  Count: {0}", count);
-			NEO_CORE_TRACE("  Binding Point: {0}", bindingPoint);
-			NEO_CORE_TRACE("-------------------");
-		}
-
-		NEO_CORE_TRACE("Push Constants:");
-		for (const auto& resource : resources.push_constant_buffers)
-		{
-			const auto& name = resource.name;
-			auto& pushConstantType = compiler.get_type(resource.base_type_id);
-
-			auto size = static_cast<uint32>(compiler.get_declared_struct_size(pushConstantType));
-			m_PushConstants[name].Name = name;
-			m_PushConstants[name].Size = size;
-			m_PushConstants[name].ShaderStage = ShaderTypeToVulkanShaderType(shaderType);
-			m_PushConstants[name].Data = std::unique_ptr<byte>(new byte[size]);
-
-			NEO_CORE_TRACE("  Name: {0}", name);
-			NEO_CORE_TRACE("  Size: {0}", size);
-			NEO_CORE_TRACE("-------------------");
-		}
-
-		NEO_CORE_TRACE("===========================");
+		return true;
 	}
 
 	void VulkanShader::CreateDescriptors()
 	{
 		vk::Device device = VulkanContext::GetDevice()->GetHandle();
 
-		// We need to tell the API the number of max. requested descriptors per type
-		std::vector<vk::DescriptorPoolSize> poolSizes;
-		if (!m_UniformBuffers.empty())
-		{
-			vk::DescriptorPoolSize& typeCount = poolSizes.emplace_back();
-			typeCount.type = vk::DescriptorType::eUniformBuffer;
-			for (const auto& [binding, uniformBuffer] : m_UniformBuffers)
-			{
-				typeCount.descriptorCount += uniformBuffer.Count;
-			}
-		}
-		if (!m_StorageBuffers.empty())
-		{
-			vk::DescriptorPoolSize& typeCount = poolSizes.emplace_back();
-			typeCount.type = vk::DescriptorType::eStorageBuffer;
-			typeCount.descriptorCount = static_cast<uint32>(m_StorageBuffers.size());
-		}
-		if (!m_ImageSamplers.empty())
-		{
-			vk::DescriptorPoolSize& typeCount = poolSizes.emplace_back();
-			typeCount.type = vk::DescriptorType::eCombinedImageSampler;
-			for (const auto& [binding, imageSampler] : m_ImageSamplers)
-			{
-				typeCount.descriptorCount += imageSampler.Count;
-			}
-		}
-		if (!m_StorageImages.empty())
-		{
-			vk::DescriptorPoolSize& typeCount = poolSizes.emplace_back();
-			typeCount.type = vk::DescriptorType::eStorageImage;
-			for (const auto& [binding, storageImage] : m_StorageImages)
-			{
-				typeCount.descriptorCount += storageImage.Count;
-			}
-		}
+		m_DynamicUniformBuffers.clear();
 
 		// TODO: Move this to the centralized renderer
 		// Create the global descriptor pool
 		// All descriptors used in this example are allocated from this pool
+		const std::vector<vk::DescriptorPoolSize>& poolSizes = m_Program->GetDescriptorPoolSizes();
 		vk::DescriptorPoolCreateInfo descPoolCreateInfo = {};
 		descPoolCreateInfo.flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet;
 		descPoolCreateInfo.poolSizeCount = static_cast<uint32>(poolSizes.size());
 		descPoolCreateInfo.pPoolSizes = poolSizes.data();
 		descPoolCreateInfo.maxSets = 1;
 
+		m_DescriptorSet.reset();
 		m_DescriptorPool = device.createDescriptorPoolUnique(descPoolCreateInfo);
 
-		std::vector<vk::DescriptorSetLayoutBinding> layoutBindings;
-		for (auto& [name, uniformBuffer] : m_UniformBuffers)
+		// Same order as the layouts, parameter handles index both
+		const auto& uniformBufferLayouts = m_Program->GetUniformBuffers();
+		m_UniformBuffers.clear();
+		m_UniformBuffers.resize(uniformBufferLayouts.size());
+		for (size_t i = 0; i < uniformBufferLayouts.size(); i++)
 		{
-			auto& layoutBinding = layoutBindings.emplace_back();
-			layoutBinding.descriptorType = vk::DescriptorType::eUniformBuffer;
-			layoutBinding.descriptorCount = uniformBuffer.Count;
-			layoutBinding.stageFlags = uniformBuffer.ShaderStage;
-			layoutBinding.binding = m_NameBindingMap[name];
+			UniformBuffer& uniformBuffer = m_UniformBuffers[i];
+			static_cast<VulkanShaderProgram::UniformBufferLayout&>(uniformBuffer) = uniformBufferLayouts[i];
+
+			if (uniformBuffer.Dynamic)
+			{
+				m_DynamicUniformBuffers.push_back(&uniformBuffer);
+				uniformBuffer.Data.assign(uniformBuffer.Size, 0);
+				uniformBuffer.Dirty = true;
+				continue;
+			}
 
 			uniformBuffer.Buffers.resize(uniformBuffer.Count);
-			for (uint32 i = 0; i < uniformBuffer.Count; i++)
+			uniformBuffer.MappedData.resize(uniformBuffer.Count);
+			for (uint32 j = 0; j < uniformBuffer.Count; j++)
 			{
-				m_Allocator.AllocateBuffer(uniformBuffer.Buffers[i], uniformBuffer.Size, vk::BufferUsageFlagBits::eUniformBuffer,
+				m_Allocator.AllocateBuffer(uniformBuffer.Buffers[j], uniformBuffer.Size, vk::BufferUsageFlagBits::eUniformBuffer,
 										   vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+				// Stays mapped until the memory is freed
+				uniformBuffer.MappedData[j] = static_cast<byte*>(uniformBuffer.Buffers[j].Memory.Map());
 			}
 		}
-		for (auto& [name, storageBuffer] : m_StorageBuffers)
+		std::sort(m_DynamicUniformBuffers.begin(), m_DynamicUniformBuffers.end(),
+				  [](const UniformBuffer* a, const UniformBuffer* b) { return a->BindingPoint < b->BindingPoint; });
+
+		const auto& storageBufferLayouts = m_Program->GetStorageBuffers();
+		m_StorageBuffers.clear();
+		m_StorageBuffers.resize(storageBufferLayouts.size());
+		for (size_t i = 0; i < storageBufferLayouts.size(); i++)
 		{
-			auto& layoutBinding = layoutBindings.emplace_back();
-			layoutBinding.descriptorType = vk::DescriptorType::eStorageBuffer;
-			layoutBinding.descriptorCount = 1;
-			layoutBinding.stageFlags = storageBuffer.ShaderStage;
-			layoutBinding.binding = m_NameBindingMap[name];
+			StorageBuffer& storageBuffer = m_StorageBuffers[i];
+			static_cast<VulkanShaderProgram::StorageBufferLayout&>(storageBuffer) = storageBufferLayouts[i];
 
-			m_Allocator.AllocateBuffer(storageBuffer.BufferData, storageBuffer.Size, vk::BufferUsageFlagBits::eStorageBuffer,
+			m_Allocator.AllocateBuffer(storageBuffer.BufferData, storageBuffer.Size,
+									   vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eVertexBuffer |
+										   vk::BufferUsageFlagBits::eIndirectBuffer,
 									   vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
 		}
-		for (auto& [name, imageSampler] : m_ImageSamplers)
+
+		const auto& imageSamplerLayouts = m_Program->GetImageSamplers();
+		m_ImageSamplers.clear();
+		m_ImageSamplers.resize(imageSamplerLayouts.size());
+		for (size_t i = 0; i < imageSamplerLayouts.size(); i++)
 		{
-			auto& layoutBinding = layoutBindings.emplace_back();
-			layoutBinding.descriptorType = vk::DescriptorType::eCombinedImageSampler;
-			layoutBinding.descriptorCount = imageSampler.Count;
-			layoutBinding.stageFlags = imageSampler.ShaderStage;
-			layoutBinding.binding = m_NameBindingMap[name];
+			ImageSampler& imageSampler = m_ImageSamplers[i];
+			static_cast<VulkanShaderProgram::ImageLayout&>(imageSampler) = imageSamplerLayouts[i];
+			imageSampler.Textures.resize(imageSampler.Count);
 		}
-		for (auto& [name, storageImage] : m_StorageImages)
+
+		const auto& storageImageLayouts = m_Program->GetStorageImages();
+		m_StorageImages.clear();
+		m_StorageImages.resize(storageImageLayouts.size());
+		for (size_t i = 0; i < storageImageLayouts.size(); i++)
 		{
-			auto& layoutBinding = layoutBindings.emplace_back();
-			layoutBinding.descriptorType = vk::DescriptorType::eStorageImage;
-			layoutBinding.descriptorCount = storageImage.Count;
-			layoutBinding.stageFlags = storageImage.ShaderStage;
-			layoutBinding.binding = m_NameBindingMap[name];
+			StorageImage& storageImage = m_StorageImages[i];
+			static_cast<VulkanShaderProgram::ImageLayout&>(storageImage) = storageImageLayouts[i];
+			storageImage.Textures.resize(storageImage.Count);
 		}
 
-		vk::DescriptorSetLayoutCreateInfo descriptorLayout = {};
-		descriptorLayout.bindingCount = static_cast<uint32>(layoutBindings.size());
-		descriptorLayout.pBindings = layoutBindings.data();
-		m_DescriptorSetLayout = device.createDescriptorSetLayoutUnique(descriptorLayout);
+		const auto& pushConstantLayouts = m_Program->GetPushConstants();
+		m_PushConstants.clear();
+		m_PushConstants.resize(pushConstantLayouts.size());
+		for (size_t i = 0; i < pushConstantLayouts.size(); i++)
+		{
+			PushConstant& pushConstant = m_PushConstants[i];
+			static_cast<VulkanShaderProgram::PushConstantLayout&>(pushConstant) = pushConstantLayouts[i];
+			pushConstant.Data = std::unique_ptr<byte>(new byte[pushConstant.Size]);
+		}
 
-		vk::DescriptorSetAllocateInfo allocInfo(m_DescriptorPool.get(), 1, &m_DescriptorSetLayout.get());
+		vk::DescriptorSetLayout descriptorSetLayout = m_Program->GetDescriptorSetLayout();
+		vk::DescriptorSetAllocateInfo allocInfo(m_DescriptorPool.get(), 1, &descriptorSetLayout);
 		m_DescriptorSet = std::move(device.allocateDescriptorSetsUnique(allocInfo)[0]);
 
-		for (const auto& [name, uniformBuffer] : m_UniformBuffers)
+		WriteBufferDescriptors();
+	}
+
+	void VulkanShader::WriteBufferDescriptors()
+	{
+		for (const UniformBuffer& uniformBuffer : m_UniformBuffers)
 		{
+			if (uniformBuffer.Dynamic)
+			{
+				// Offset into the ring is supplied when binding
+				vk::DescriptorBufferInfo bufferInfo;
+				bufferInfo.buffer = VulkanContext::GetUniformBufferRing().GetBuffer();
+				bufferInfo.offset = 0;
+				bufferInfo.range = uniformBuffer.Size;
+
+				vk::WriteDescriptorSet descWrite = {m_DescriptorSet.get(), uniformBuffer.BindingPoint, 0, 1,
+													vk::DescriptorType::eUniformBufferDynamic, nullptr, &bufferInfo};
+				m_PendingWrites.emplace_back(bufferInfo, nullptr, descWrite);
+				continue;
+			}
+
 			for (uint32 i = 0; i < uniformBuffer.Count; i++)
 			{
 				vk::DescriptorBufferInfo bufferInfo;
-				bufferInfo.buffer = m_UniformBuffers[name].Buffers[i].Handle.get();
+				bufferInfo.buffer = uniformBuffer.Buffers[i].Handle.get();
 				bufferInfo.offset = 0;
-				bufferInfo.range = m_UniformBuffers[name].Buffers[i].Size;
+				bufferInfo.range = uniformBuffer.Buffers[i].Size;
 
 				vk::WriteDescriptorSet descWrite = {
-					m_DescriptorSet.get(), m_NameBindingMap[name], i, 1, vk::DescriptorType::eUniformBuffer, nullptr, &bufferInfo};
+					m_DescriptorSet.get(), uniformBuffer.BindingPoint, i, 1, vk::DescriptorType::eUniformBuffer, nullptr, &bufferInfo};
 				m_PendingWrites.emplace_back(bufferInfo, nullptr, descWrite);
 			}
 		}
 
-		for (const auto& [name, storageBuffer] : m_StorageBuffers)
+		for (const StorageBuffer& storageBuffer : m_StorageBuffers)
 		{
 			vk::DescriptorBufferInfo bufferInfo;
-			bufferInfo.buffer = m_StorageBuffers[name].BufferData.Handle.get();
+			bufferInfo.buffer = storageBuffer.BufferData.Handle.get();
 			bufferInfo.offset = 0;
-			bufferInfo.range = m_StorageBuffers[name].BufferData.Size;
+			bufferInfo.range = storageBuffer.BufferData.Size;
 
 			vk::WriteDescriptorSet descWrite = {
-				m_DescriptorSet.get(), m_NameBindingMap[name], 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &bufferInfo};
+				m_DescriptorSet.get(), storageBuffer.BindingPoint, 0, 1, vk::DescriptorType::eStorageBuffer, nullptr, &bufferInfo};
 			m_PendingWrites.emplace_back(bufferInfo, nullptr, descWrite);
 		}
 	}
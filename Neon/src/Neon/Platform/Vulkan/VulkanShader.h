@@ -3,116 +3,147 @@
 #include "Neon/Renderer/Shader.h"
 #include "Vulkan.h"
 #include "VulkanAllocator.h"
+#include "VulkanShaderLibrary.h"
 
 namespace Neon
 {
-	class VulkanShader : public Shader
+	// Material descriptor set of a shared program, holding the buffers and textures bound to it. Per frame data like
+	// CameraUBO and LightUBO is read from the frame set of the context instead, see VulkanFrameDescriptors.
+	class VulkanShader : public Shader, public VulkanBufferOwner
 	{
 	public:
-		struct UniformBuffer
+		static constexpr uint32 c_MaxDynamicUniformBuffers = VulkanShaderProgram::c_MaxDynamicUniformBuffers;
+
+		struct UniformBuffer : VulkanShaderProgram::UniformBufferLayout
 		{
-			std::string Name;
-			uint32 BindingPoint = 0;
-			uint32 Count = 0;
-			uint32 Size = 0;
 			std::vector<VulkanBuffer> Buffers;
-			vk::ShaderStageFlags ShaderStage;
+			std::vector<byte*> MappedData;
+
+			// Latest data of a dynamic buffer, pushed to the ring again once it changed or a new frame started
+			std::vector<byte> Data;
+			uint32 RingOffset = 0;
+			uint64 RingFrameNumber = 0;
+			bool Dirty = true;
 		};
 
-		struct StorageBuffer
+		struct StorageBuffer : VulkanShaderProgram::StorageBufferLayout
 		{
-			std::string Name;
-			uint32 BindingPoint = 0;
-			uint32 Size = 0;
 			VulkanBuffer BufferData;
-			vk::ShaderStageFlags ShaderStage;
 		};
 
-		struct ImageSampler
+		struct ImageSampler : VulkanShaderProgram::ImageLayout
 		{
-			std::string Name;
-			uint32 BindingPoint = 0;
-			uint32 Count = 0;
-			vk::ShaderStageFlags ShaderStage;
 			std::vector<SharedRef<Texture>> Textures;
 		};
 
-		struct StorageImage
+		struct StorageImage : VulkanShaderProgram::ImageLayout
 		{
-			std::string Name;
-			uint32 BindingPoint = 0;
-			uint32 Count = 0;
-			vk::ShaderStageFlags ShaderStage;
 			std::vector<SharedRef<Texture>> Textures;
 		};
 
-		struct PushConstant
+		struct PushConstant : VulkanShaderProgram::PushConstantLayout
 		{
-			std::string Name;
-			uint32 Size;
-			vk::ShaderStageFlags ShaderStage;
 			UniqueRef<byte> Data;
 		};
 
 		VulkanShader(const ShaderSpecification& shaderSpecification);
-		~VulkanShader() = default;
+		~VulkanShader();
 
 		void Reload() override;
 
-		void SetUniformBuffer(const std::string& name, uint32 index, const void* data, uint32 size = 0) override;
-		void SetStorageBuffer(const std::string& name, const void* data, uint32 size = 0) override;
-		void SetPushConstant(const std::string& name, const void* data, uint32 size = 0) override;
-		void SetTexture2D(const std::string& name, uint32 index, const SharedRef<Texture2D>& texture, uint32 mipLevel) override;
-		void SetStorageTexture2D(const std::string& name, uint32 index, const SharedRef<Texture2D>& texture,
-								   uint32 mipLevel) override;
-		void SetTextureCube(const std::string& name, uint32 index, const SharedRef<TextureCube>& texture, uint32 mipLevel) override;
-		void SetStorageTextureCube(const std::string& name, uint32 index, const SharedRef<TextureCube>& texture,
+		void GetMovableBuffers(std::vector<VulkanBuffer*>& outBuffers) override;
+		void OnBuffersMoved() override;
+
+		void SetUniformBuffer(const ShaderParamHandle& name, uint32 index, const void* data, uint32 size = 0) override;
+		void SetStorageBuffer(const ShaderParamHandle& name, const void* data, uint32 size = 0) override;
+		void ReadStorageBuffer(const ShaderParamHandle& name, void* outData, uint32 size = 0) const override;
+		void SetPushConstant(const ShaderParamHandle& name, const void* data, uint32 size = 0) override;
+		void SetTexture2D(const ShaderParamHandle& name, uint32 index, const SharedRef<Texture2D>& texture,
+						  uint32 mipLevel) override;
+		void SetStorageTexture2D(const ShaderParamHandle& name, uint32 index, const SharedRef<Texture2D>& texture,
+								 uint32 mipLevel) override;
+		void SetTextureCube(const ShaderParamHandle& name, uint32 index, const SharedRef<TextureCube>& texture,
+							uint32 mipLevel) override;
+		void SetStorageTextureCube(const ShaderParamHandle& name, uint32 index, const SharedRef<TextureCube>& texture,
 								   uint32 mipLevel) override;
 
-		SharedRef<Texture2D> GetTexture2D(const std::string& name, uint32 index) const override;
-		SharedRef<TextureCube> GetTextureCube(const std::string& name, uint32 index) const override;
+		SharedRef<Texture2D> GetTexture2D(const ShaderParamHandle& name, uint32 index) const override;
+		SharedRef<TextureCube> GetTextureCube(const ShaderParamHandle& name, uint32 index) const override;
 
 		vk::DescriptorSet GetDescriptorSet() const
 		{
 			return m_DescriptorSet.get();
 		}
 
+		// Interned name, labels the GPU timestamps of dispatches
+		const char* GetProfileName() const
+		{
+			return m_ProfileName;
+		}
+
+		// Storage buffers can also be bound as vertex or indirect buffers, e.g. for draw data generated by compute shaders
+		vk::Buffer GetStorageBufferHandle(const ShaderParamHandle& name) const
+		{
+			return m_StorageBuffers[GetParamIndex(name, ShaderResourceKind::StorageBuffer)].BufferData.Handle.get();
+		}
+
 		vk::DescriptorSetLayout GetDescriptorSetLayout() const
 		{
-			return m_DescriptorSetLayout.get();
+			return m_Program->GetDescriptorSetLayout();
+		}
+		bool UsesFrameData() const
+		{
+			return m_Program->UsesFrameData();
 		}
 		const std::vector<vk::PipelineShaderStageCreateInfo>& GetShaderStages() const
 		{
-			return m_ShaderStages;
+			return m_Program->GetShaderStages();
+		}
+		// Equal for shaders with identical stages and descriptor layout, their pipelines are interchangeable
+		uint64 GetHash() const
+		{
+			return m_Program->GetHash();
 		}
 
-		void PrepareDescriptorSet();
+		// Descriptor set must not be in use by recorded or executing command buffers while writes are flushed
+		bool HasPendingWrites() const
+		{
+			return !m_PendingWrites.empty();
+		}
+		// Returns true if pending writes were flushed into the descriptor set
+		bool PrepareDescriptorSet();
+		// Pushes dynamic uniform buffers to the ring where needed and returns their offsets in binding order. Fails when the
+		// ring is full.
+		bool PrepareDynamicOffsets(std::array<uint32, c_MaxDynamicUniformBuffers>& outOffsets, uint32& outCount);
 
 	private:
-		void GetVulkanShaderBinary(ShaderType shaderType, std::vector<uint32>& outShaderBinary, bool forceCompile);
-		void CreateShader(ShaderType shaderType, const std::vector<uint32>& shaderBinary);
-		void Reflect(ShaderType shaderType, const std::vector<uint32>& shaderBinary);
-
 		void CreateDescriptors();
+		void WriteBufferDescriptors();
+
+		// Index into the resources of the given kind, which mirror the layouts of the program
+		uint32 GetParamIndex(const ShaderParamHandle& name, ShaderResourceKind kind) const
+		{
+			const VulkanShaderProgram::ParamSlot* slot = m_Program->FindParam(name);
+			NEO_CORE_ASSERT(slot && slot->Kind == kind, "Unknown shader resource name!");
+			return slot->Index;
+		}
 
 	private:
-		std::vector<vk::UniqueShaderModule> m_ShaderModules;
-		std::vector<vk::PipelineShaderStageCreateInfo> m_ShaderStages;
-		std::unordered_map<ShaderType, std::string> m_ShaderSources;
+		SharedRef<VulkanShaderProgram> m_Program;
+		const char* m_ProfileName = nullptr;
 
 		VulkanAllocator m_Allocator;
 
 		vk::UniqueDescriptorPool m_DescriptorPool;
-		vk::UniqueDescriptorSetLayout m_DescriptorSetLayout;
 		vk::UniqueDescriptorSet m_DescriptorSet;
 
-		std::unordered_map<std::string, UniformBuffer> m_UniformBuffers;
-		std::unordered_map<std::string, StorageBuffer> m_StorageBuffers;
-		std::unordered_map<std::string, ImageSampler> m_ImageSamplers;
-		std::unordered_map<std::string, StorageImage> m_StorageImages;
-		std::unordered_map<std::string, PushConstant> m_PushConstants;
-
-		std::unordered_map<std::string, uint32> m_NameBindingMap;
+		std::vector<UniformBuffer> m_UniformBuffers;
+		// Sorted by binding point, the order dynamic offsets are expected in
+		std::vector<UniformBuffer*> m_DynamicUniformBuffers;
+		std::vector<StorageBuffer> m_StorageBuffers;
+		std::vector<ImageSampler> m_ImageSamplers;
+		std::vector<StorageImage> m_StorageImages;
+		std::vector<PushConstant> m_PushConstants;
 
 		std::vector<std::tuple<vk::DescriptorBufferInfo, vk::DescriptorImageInfo, vk::WriteDescriptorSet>> m_PendingWrites;
 
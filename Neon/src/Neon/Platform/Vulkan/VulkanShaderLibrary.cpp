@@ -0,0 +1,722 @@
+#include "neopch.h"
+
+#include "Neon/Core/JobSystem.h"
+#include "Neon/Core/Profiler.h"
+#include "Neon/Platform/Vulkan/VulkanContext.h"
+#include "Neon/Platform/Vulkan/VulkanShaderLibrary.h"
+#include "Neon/Tools/FileTools.h"
+
+#include <spirv_glsl.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <map>
+
+namespace Neon
+{
+	static constexpr shaderc_env_version c_ShaderEnvVersion = shaderc_env_version_vulkan_1_2;
+	// Part of every binary's cache key, bumped when the way binaries are produced changes
+	static constexpr uint32 c_ShaderCacheVersion = 1;
+
+	// Release builds run the spirv-opt performance passes over every stage, debug builds keep the SPIR-V close to the
+	// source for graphics debuggers. Reflection needs the unoptimized binary, so a cold start of a release build compiles
+	// every stage twice and its compile times cover both binaries.
+#ifdef NEO_RELEASE
+	static constexpr bool c_OptimizeShaders = true;
+#else
+	static constexpr bool c_OptimizeShaders = false;
+#endif
+
+	static const std::array<std::pair<std::string, ShaderType>, 4> c_ShaderFileSuffixes = {{{"_Geom", ShaderType::Geometry},
+																							{"_Vert", ShaderType::Vertex},
+																							{"_Frag", ShaderType::Fragment},
+																							{"_Compute", ShaderType::Compute}}};
+
+	static vk::ShaderStageFlagBits ShaderTypeToVulkanShaderType(ShaderType shaderType)
+	{
+		switch (shaderType)
+		{
+			case ShaderType::Geometry:
+				return vk::ShaderStageFlagBits::eGeometry;
+			case ShaderType::Vertex:
+				return vk::ShaderStageFlagBits::eVertex;
+			case ShaderType::Fragment:
+				return vk::ShaderStageFlagBits::eFragment;
+			case ShaderType::Compute:
+				return vk::ShaderStageFlagBits::eCompute;
+			default:
+				NEO_CORE_ASSERT(false, "Uknown shader type!");
+				return vk::ShaderStageFlagBits();
+		}
+	}
+
+	// First word of every SPIR-V module, cached binaries without it are compiled again
+	static constexpr uint32 c_SpirvMagic = 0x07230203;
+
+	static constexpr uint32 c_ReflectionMagic = 0x4E535246; // "NSRF"
+	static constexpr uint32 c_ReflectionVersion = 2;
+
+	struct ReflectionHeader
+	{
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		uint32 ResourceCount = 0;
+	};
+
+	// Followed by NameLength characters of the name
+	struct ReflectionEntry
+	{
+		ShaderResourceKind Kind = ShaderResourceKind::UniformBuffer;
+		uint32 Set = 0;
+		uint32 BindingPoint = 0;
+		uint32 Count = 0;
+		uint32 Size = 0;
+		uint32 NameLength = 0;
+	};
+
+	static std::vector<ShaderStageResource> ReflectShaderResources(const std::vector<uint32>& shaderBinary)
+	{
+		NEO_PROFILE_SCOPE_CATEGORY("ReflectShaderResources", "Shader");
+
+		spirv_cross::Compiler compiler(shaderBinary);
+		auto resources = compiler.get_shader_resources();
+
+		std::vector<ShaderStageResource> stageResources;
+		for (const auto& resource : resources.uniform_buffers)
+		{
+			auto& bufferType = compiler.get_type(resource.type_id);
+
+			ShaderStageResource& uniformBuffer = stageResources.emplace_back();
+			uniformBuffer.Kind = ShaderResourceKind::UniformBuffer;
+			uniformBuffer.Name = resource.name;
+			uniformBuffer.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+			uniformBuffer.BindingPoint = compiler.get_decoration(resource.id, spv::DecorationBinding);
+			uniformBuffer.Count = bufferType.array.empty() ? 1 : std::max(1u, bufferType.array[0]);
+			uniformBuffer.Size = static_cast<uint32>(compiler.get_declared_struct_size(bufferType));
+		}
+		for (const auto& resource : resources.storage_buffers)
+		{
+			auto& bufferType = compiler.get_type(resource.type_id);
+
+			// Runtime arrays have no declared size, a single element of them is counted instead
+			auto size = static_cast<uint32>(compiler.get_declared_struct_size(bufferType));
+			if (size == 0)
+			{
+				for (uint32 i = 0; i < static_cast<uint32>(bufferType.member_types.size()); i++)
+				{
+					size += compiler.type_struct_member_array_stride(bufferType, i);
+				}
+			}
+
+			ShaderStageResource& storageBuffer = stageResources.emplace_back();
+			storageBuffer.Kind = ShaderResourceKind::StorageBuffer;
+			storageBuffer.Name = resource.name;
+			storageBuffer.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+			storageBuffer.BindingPoint = compiler.get_decoration(resource.id, spv::DecorationBinding);
+			storageBuffer.Size = size;
+		}
+		for (const auto& resource : resources.sampled_images)
+		{
+			auto& imageSamplerType = compiler.get_type(resource.base_type_id);
+
+			ShaderStageResource& imageSampler = stageResources.emplace_back();
+			imageSampler.Kind = ShaderResourceKind::ImageSampler;
+			imageSampler.Name = resource.name;
+			imageSampler.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+			imageSampler.BindingPoint = compiler.get_decoration(resource.id, spv::DecorationBinding);
+			imageSampler.Count = imageSamplerType.array.empty() ? 1 : std::max(1u, imageSamplerType.array[0]);
+		}
+		for (const auto& resource : resources.storage_images)
+		{
+			auto& storageImageType = compiler.get_type(resource.base_type_id);
+
+			ShaderStageResource& storageImage = stageResources.emplace_back();
+			storageImage.Kind = ShaderResourceKind::StorageImage;
+			storageImage.Name = resource.name;
+			storageImage.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+			storageImage.BindingPoint = compiler.get_decoration(resource.id, spv::DecorationBinding);
+			storageImage.Count = storageImageType.array.empty() ? 1 : std::max(1u, storageImageType.array[0]);
+		}
+		for (const auto& resource : resources.push_constant_buffers)
+		{
+			auto& pushConstantType = compiler.get_type(resource.base_type_id);
+
+			ShaderStageResource& pushConstant = stageResources.emplace_back();
+			pushConstant.Kind = ShaderResourceKind::PushConstant;
+			pushConstant.Name = resource.name;
+			pushConstant.Size = static_cast<uint32>(compiler.get_declared_struct_size(pushConstantType));
+		}
+		return stageResources;
+	}
+
+	static std::vector<uint8> SerializeShaderResources(const std::vector<ShaderStageResource>& resources)
+	{
+		ReflectionHeader header;
+		header.Magic = c_ReflectionMagic;
+		header.Version = c_ReflectionVersion;
+		header.ResourceCount = static_cast<uint32>(resources.size());
+
+		std::vector<uint8> data(sizeof(ReflectionHeader));
+		memcpy(data.data(), &header, sizeof(ReflectionHeader));
+		for (const ShaderStageResource& resource : resources)
+		{
+			ReflectionEntry entry;
+			entry.Kind = resource.Kind;
+			entry.Set = resource.Set;
+			entry.BindingPoint = resource.BindingPoint;
+			entry.Count = resource.Count;
+			entry.Size = resource.Size;
+			entry.NameLength = static_cast<uint32>(resource.Name.size());
+
+			size_t offset = data.size();
+			data.resize(offset + sizeof(ReflectionEntry) + entry.NameLength);
+			memcpy(data.data() + offset, &entry, sizeof(ReflectionEntry));
+			memcpy(data.data() + offset + sizeof(ReflectionEntry), resource.Name.data(), entry.NameLength);
+		}
+		return data;
+	}
+
+	// Fails on files of another version or truncated ones, they are reflected again and overwritten
+	static bool DeserializeShaderResources(const std::vector<uint8>& data, std::vector<ShaderStageResource>& outResources)
+	{
+		ReflectionHeader header;
+		if (data.size() < sizeof(ReflectionHeader))
+		{
+			return false;
+		}
+		memcpy(&header, data.data(), sizeof(ReflectionHeader));
+		if (header.Magic != c_ReflectionMagic || header.Version != c_ReflectionVersion)
+		{
+			return false;
+		}
+
+		size_t offset = sizeof(ReflectionHeader);
+		outResources.resize(header.ResourceCount);
+		for (ShaderStageResource& resource : outResources)
+		{
+			ReflectionEntry entry;
+			if (data.size() - offset < sizeof(ReflectionEntry))
+			{
+				return false;
+			}
+			memcpy(&entry, data.data() + offset, sizeof(ReflectionEntry));
+			offset += sizeof(ReflectionEntry);
+			if (data.size() - offset < entry.NameLength)
+			{
+				return false;
+			}
+
+			resource.Kind = entry.Kind;
+			resource.Name.assign(reinterpret_cast<const char*>(data.data() + offset), entry.NameLength);
+			resource.Set = entry.Set;
+			resource.BindingPoint = entry.BindingPoint;
+			resource.Count = entry.Count;
+			resource.Size = entry.Size;
+			offset += entry.NameLength;
+		}
+		return offset == data.size();
+	}
+
+	VulkanShaderProgram::VulkanShaderProgram(const ShaderSpecification& specification)
+		: m_Specification(specification)
+	{
+		NEO_PROFILE_SCOPE_CATEGORY("VulkanShaderProgram::VulkanShaderProgram", "Shader");
+
+		m_Hash = VulkanPipelineCache::c_HashOffset;
+
+		for (const auto& [shaderType, shaderPath] : m_Specification.ShaderPaths)
+		{
+			ShaderStageSource source = VulkanShaderLibrary::PreprocessShader(shaderType, shaderPath);
+			AddStageResources(shaderType, VulkanShaderLibrary::GetShaderResources(source));
+			CreateShader(shaderType, VulkanShaderLibrary::GetShaderBinary(source, c_OptimizeShaders));
+		}
+		ResolveParams();
+		CreateDescriptorSetLayout();
+	}
+
+	void VulkanShaderProgram::CreateShader(ShaderType shaderType, const std::vector<uint32>& shaderBinary)
+	{
+		const vk::Device device = VulkanContext::GetDevice()->GetHandle();
+		vk::ShaderModuleCreateInfo createInfo{{}, shaderBinary.size() * sizeof(uint32), shaderBinary.data()};
+		m_ShaderModules.push_back(device.createShaderModuleUnique(createInfo));
+
+		m_ShaderStages.push_back({{}, ShaderTypeToVulkanShaderType(shaderType), m_ShaderModules.back().get(), "main"});
+
+		VulkanPipelineCache::HashCombine(m_Hash, shaderType);
+		m_Hash = VulkanPipelineCache::Hash(shaderBinary.data(), shaderBinary.size() * sizeof(uint32), m_Hash);
+	}
+
+	template<typename T>
+	static T& FindOrAddLayout(std::vector<T>& layouts, const std::string& name)
+	{
+		auto it = std::find_if(layouts.begin(), layouts.end(), [&name](const T& layout) { return layout.Name == name; });
+		if (it != layouts.end())
+		{
+			return *it;
+		}
+
+		T& layout = layouts.emplace_back();
+		layout.Name = name;
+		return layout;
+	}
+
+	void VulkanShaderProgram::AddStageResources(ShaderType shaderType, const std::vector<ShaderStageResource>& resources)
+	{
+		const vk::ShaderStageFlagBits shaderStage = ShaderTypeToVulkanShaderType(shaderType);
+		for (const ShaderStageResource& resource : resources)
+		{
+			// Frame set resources are owned by the context, they only have to match its layout
+			if (resource.Kind != ShaderResourceKind::PushConstant && resource.Set == c_FrameDescriptorSet)
+			{
+				NEO_CORE_ASSERT(VulkanFrameDescriptors::IsCompatible(resource), "Resource does not match the frame set layout!");
+				m_UsesFrameData = true;
+				continue;
+			}
+			NEO_CORE_ASSERT(resource.Kind == ShaderResourceKind::PushConstant || resource.Set == c_MaterialDescriptorSet,
+							"Shader resources have to be in the frame or material set!");
+
+			auto variableCount = m_Specification.ShaderVariableCounts.find(resource.Name);
+			const bool hasVariableCount = variableCount != m_Specification.ShaderVariableCounts.end();
+
+			switch (resource.Kind)
+			{
+				case ShaderResourceKind::UniformBuffer:
+				{
+					UniformBufferLayout& buffer = FindOrAddLayout(m_UniformBuffers, resource.Name);
+					buffer.BindingPoint = resource.BindingPoint;
+					buffer.Count = hasVariableCount ? variableCount->second : resource.Count;
+					buffer.Size = resource.Size;
+					buffer.ShaderStage |= shaderStage;
+					break;
+				}
+				case ShaderResourceKind::StorageBuffer:
+				{
+					// Sized by the element count of the specification only
+					StorageBufferLayout& buffer = FindOrAddLayout(m_StorageBuffers, resource.Name);
+					buffer.BindingPoint = resource.BindingPoint;
+					buffer.Size = resource.Size * (hasVariableCount ? variableCount->second : 0);
+					buffer.ShaderStage |= shaderStage;
+					break;
+				}
+				case ShaderResourceKind::ImageSampler:
+				case ShaderResourceKind::StorageImage:
+				{
+					ImageLayout& image = FindOrAddLayout(
+						resource.Kind == ShaderResourceKind::ImageSampler ? m_ImageSamplers : m_StorageImages, resource.Name);
+					image.BindingPoint = resource.BindingPoint;
+					image.Count = hasVariableCount ? variableCount->second : resource.Count;
+					image.ShaderStage |= shaderStage;
+					break;
+				}
+				case ShaderResourceKind::PushConstant:
+				{
+					PushConstantLayout& pushConstant = FindOrAddLayout(m_PushConstants, resource.Name);
+					pushConstant.Size = resource.Size;
+					pushConstant.ShaderStage = shaderStage;
+					break;
+				}
+			}
+		}
+	}
+
+	void VulkanShaderProgram::ResolveParams()
+	{
+		auto addSlots = [this](const auto& layouts, ShaderResourceKind kind) {
+			for (uint32 i = 0; i < static_cast<uint32>(layouts.size()); i++)
+			{
+				const uint32 id = ShaderParamHandle(layouts[i].Name).GetId();
+				if (id >= m_ParamSlots.size())
+				{
+					m_ParamSlots.resize(id + 1);
+				}
+				m_ParamSlots[id] = {kind, i};
+			}
+		};
+		addSlots(m_UniformBuffers, ShaderResourceKind::UniformBuffer);
+		addSlots(m_StorageBuffers, ShaderResourceKind::StorageBuffer);
+		addSlots(m_ImageSamplers, ShaderResourceKind::ImageSampler);
+		addSlots(m_StorageImages, ShaderResourceKind::StorageImage);
+		addSlots(m_PushConstants, ShaderResourceKind::PushConstant);
+	}
+
+	void VulkanShaderProgram::CreateDescriptorSetLayout()
+	{
+		vk::Device device = VulkanContext::GetDevice()->GetHandle();
+
+		// Single uniform buffers become dynamic up to the guaranteed limit, lowest binding points first
+		const uint32 maxDynamicUniformBuffers = std::min(
+			c_MaxDynamicUniformBuffers,
+			VulkanContext::GetDevice()->GetPhysicalDevice()->GetProperties().limits.maxDescriptorSetUniformBuffersDynamic);
+		std::vector<UniformBufferLayout*> dynamicUniformBuffers;
+		for (UniformBufferLayout& uniformBuffer : m_UniformBuffers)
+		{
+			uniformBuffer.Dynamic = false;
+			if (uniformBuffer.Count == 1)
+			{
+				dynamicUniformBuffers.push_back(&uniformBuffer);
+			}
+		}
+		std::sort(dynamicUniformBuffers.begin(), dynamicUniformBuffers.end(),
+				  [](const UniformBufferLayout* a, const UniformBufferLayout* b) { return a->BindingPoint < b->BindingPoint; });
+		if (dynamicUniformBuffers.size() > maxDynamicUniformBuffers)
+		{
+			dynamicUniformBuffers.resize(maxDynamicUniformBuffers);
+		}
+		for (UniformBufferLayout* uniformBuffer : dynamicUniformBuffers)
+		{
+			uniformBuffer->Dynamic = true;
+		}
+
+		// We need to tell the API the number of max. requested descriptors per type
+		if (!dynamicUniformBuffers.empty())
+		{
+			vk::DescriptorPoolSize& typeCount = m_DescriptorPoolSizes.emplace_back();
+			typeCount.type = vk::DescriptorType::eUniformBufferDynamic;
+			typeCount.descriptorCount = static_cast<uint32>(dynamicUniformBuffers.size());
+		}
+		if (m_UniformBuffers.size() > dynamicUniformBuffers.size())
+		{
+			vk::DescriptorPoolSize& typeCount = m_DescriptorPoolSizes.emplace_back();
+			typeCount.type = vk::DescriptorType::eUniformBuffer;
+			for (const UniformBufferLayout& uniformBuffer : m_UniformBuffers)
+			{
+				typeCount.descriptorCount += uniformBuffer.Dynamic ? 0 : uniformBuffer.Count;
+			}
+		}
+		if (!m_StorageBuffers.empty())
+		{
+			vk::DescriptorPoolSize& typeCount = m_DescriptorPoolSizes.emplace_back();
+			typeCount.type = vk::DescriptorType::eStorageBuffer;
+			typeCount.descriptorCount = static_cast<uint32>(m_StorageBuffers.size());
+		}
+		if (!m_ImageSamplers.empty())
+		{
+			vk::DescriptorPoolSize& typeCount = m_DescriptorPoolSizes.emplace_back();
+			typeCount.type = vk::DescriptorType::eCombinedImageSampler;
+			for (const ImageLayout& imageSampler : m_ImageSamplers)
+			{
+				typeCount.descriptorCount += imageSampler.Count;
+			}
+		}
+		if (!m_StorageImages.empty())
+		{
+			vk::DescriptorPoolSize& typeCount = m_DescriptorPoolSizes.emplace_back();
+			typeCount.type = vk::DescriptorType::eStorageImage;
+			for (const ImageLayout& storageImage : m_StorageImages)
+			{
+				typeCount.descriptorCount += storageImage.Count;
+			}
+		}
+
+		std::vector<vk::DescriptorSetLayoutBinding> layoutBindings;
+		for (const UniformBufferLayout& uniformBuffer : m_UniformBuffers)
+		{
+			auto& layoutBinding = layoutBindings.emplace_back();
+			layoutBinding.descriptorType =
+				uniformBuffer.Dynamic ? vk::DescriptorType::eUniformBufferDynamic : vk::DescriptorType::eUniformBuffer;
+			layoutBinding.descriptorCount = uniformBuffer.Count;
+			layoutBinding.stageFlags = uniformBuffer.ShaderStage;
+			layoutBinding.binding = uniformBuffer.BindingPoint;
+		}
+		for (const StorageBufferLayout& storageBuffer : m_StorageBuffers)
+		{
+			auto& layoutBinding = layoutBindings.emplace_back();
+			layoutBinding.descriptorType = vk::DescriptorType::eStorageBuffer;
+			layoutBinding.descriptorCount = 1;
+			layoutBinding.stageFlags = storageBuffer.ShaderStage;
+			layoutBinding.binding = storageBuffer.BindingPoint;
+		}
+		for (const ImageLayout& imageSampler : m_ImageSamplers)
+		{
+			auto& layoutBinding = layoutBindings.emplace_back();
+			layoutBinding.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+			layoutBinding.descriptorCount = imageSampler.Count;
+			layoutBinding.stageFlags = imageSampler.ShaderStage;
+			layoutBinding.binding = imageSampler.BindingPoint;
+		}
+		for (const ImageLayout& storageImage : m_StorageImages)
+		{
+			auto& layoutBinding = layoutBindings.emplace_back();
+			layoutBinding.descriptorType = vk::DescriptorType::eStorageImage;
+			layoutBinding.descriptorCount = storageImage.Count;
+			layoutBinding.stageFlags = storageImage.ShaderStage;
+			layoutBinding.binding = storageImage.BindingPoint;
+		}
+
+		vk::DescriptorSetLayoutCreateInfo descriptorLayout = {};
+		descriptorLayout.bindingCount = static_cast<uint32>(layoutBindings.size());
+		descriptorLayout.pBindings = layoutBindings.data();
+		m_DescriptorSetLayout = device.createDescriptorSetLayoutUnique(descriptorLayout);
+
+		// Variable counts change the layout of otherwise identical programs
+		std::sort(layoutBindings.begin(), layoutBindings.end(),
+				  [](const auto& a, const auto& b) { return a.binding < b.binding; });
+		for (const vk::DescriptorSetLayoutBinding& layoutBinding : layoutBindings)
+		{
+			VulkanPipelineCache::HashCombine(m_Hash, layoutBinding.binding);
+			VulkanPipelineCache::HashCombine(m_Hash, layoutBinding.descriptorType);
+			VulkanPipelineCache::HashCombine(m_Hash, layoutBinding.descriptorCount);
+			VulkanPipelineCache::HashCombine(m_Hash, static_cast<VkShaderStageFlags>(layoutBinding.stageFlags));
+		}
+	}
+
+	SharedRef<VulkanShaderProgram> VulkanShaderLibrary::GetOrLoad(const ShaderSpecification& specification)
+	{
+		std::string key = GetKey(specification);
+
+		std::promise<SharedRef<VulkanShaderProgram>> loadPromise;
+		std::shared_future<SharedRef<VulkanShaderProgram>> loading;
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			ProgramEntry& entry = s_Programs[key];
+			SharedRef<VulkanShaderProgram> program = entry.Program.Lock();
+			if (program)
+			{
+				s_SharedCount++;
+				return program;
+			}
+
+			if (entry.Loading.valid())
+			{
+				s_SharedCount++;
+				loading = entry.Loading;
+			}
+			else
+			{
+				// Reserves the key, threads asking for it meanwhile wait for this thread to finish the program
+				entry.Loading = loadPromise.get_future().share();
+			}
+		}
+
+		if (loading.valid())
+		{
+			return loading.get();
+		}
+
+		// Built without holding the lock, so programs of different specifications compile in parallel
+		auto start = std::chrono::steady_clock::now();
+		SharedRef<VulkanShaderProgram> program = SharedRef<VulkanShaderProgram>::Create(specification);
+		double milliseconds =
+			std::chrono::duration<double, std::chrono::milliseconds::period>(std::chrono::steady_clock::now() - start).count();
+
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			ProgramEntry& entry = s_Programs[key];
+			entry.Program = program;
+			entry.Loading = {};
+
+			s_LoadedCount++;
+			s_LoadMilliseconds += milliseconds;
+			NEO_CORE_INFO("VulkanShaderLibrary: loaded {0} in {1:.2f} ms, {2} programs loaded in {3:.2f} ms, {4} shaders shared one",
+						  key, milliseconds, s_LoadedCount, s_LoadMilliseconds, s_SharedCount);
+		}
+		loadPromise.set_value(program);
+		return program;
+	}
+
+	void VulkanShaderLibrary::CompileDirectory(const std::string& directory)
+	{
+		NEO_PROFILE_FUNCTION();
+
+		if (!std::filesystem::is_directory(directory))
+		{
+			NEO_CORE_WARN("VulkanShaderLibrary: shader directory {0} does not exist", directory);
+			return;
+		}
+
+		struct StageFile
+		{
+			ShaderType Type;
+			std::string Path;
+		};
+		std::vector<StageFile> stageFiles;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(directory))
+		{
+			if (!entry.is_regular_file() || entry.path().extension() != ".glsl")
+			{
+				continue;
+			}
+
+			std::string stem = entry.path().stem().string();
+			for (const auto& [suffix, shaderType] : c_ShaderFileSuffixes)
+			{
+				if (stem.size() > suffix.size() && stem.compare(stem.size() - suffix.size(), suffix.size(), suffix) == 0)
+				{
+					stageFiles.push_back({shaderType, entry.path().string()});
+				}
+			}
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		JobSystem::ParallelForEach(
+			stageFiles,
+			[](const StageFile& stageFile) {
+				ShaderStageSource source = PreprocessShader(stageFile.Type, stageFile.Path);
+				GetShaderResources(source);
+				GetShaderBinary(source, c_OptimizeShaders);
+			},
+			1);
+		double milliseconds =
+			std::chrono::duration<double, std::chrono::milliseconds::period>(std::chrono::steady_clock::now() - start).count();
+
+		std::lock_guard<std::mutex> lock(s_StatsMutex);
+		NEO_CORE_INFO("VulkanShaderLibrary: {0} stages ready in {1:.2f} ms on {2} threads, compiled {3} binaries in {4:.2f} ms, "
+					  "read {5} from the cache in {6:.2f} ms, reflected {7} in {8:.2f} ms",
+					  stageFiles.size(), milliseconds, JobSystem::GetThreadCount(), s_CompiledCount, s_CompileMilliseconds,
+					  s_CachedCount, s_CacheMilliseconds, s_ReflectedCount, s_ReflectMilliseconds);
+	}
+
+	ShaderStageSource VulkanShaderLibrary::PreprocessShader(ShaderType shaderType, const std::string& shaderPath)
+	{
+		NEO_PROFILE_SCOPE_CATEGORY("VulkanShaderLibrary::PreprocessShader", "Shader");
+
+		std::vector<char> fileSource;
+		bool fileRead = File::ReadFromFile(shaderPath, fileSource, true);
+		NEO_CORE_ASSERT(fileRead, "Shader path does not exist!");
+
+		shaderc::Compiler compiler;
+		shaderc::CompileOptions options;
+		options.SetTargetEnvironment(shaderc_target_env_vulkan, c_ShaderEnvVersion);
+		const shaderc_shader_kind shaderKind = ShaderTypeToShadercShaderType(shaderType);
+
+		// Cheap next to compiling and resolves includes and defines, so the hash covers all of them
+		shaderc::PreprocessedSourceCompilationResult result = compiler.PreprocessGlsl(
+			std::string(fileSource.begin(), fileSource.end()), shaderKind, shaderPath.c_str(), options);
+		if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+		{
+			NEO_CORE_ERROR(result.GetErrorMessage());
+			NEO_CORE_ASSERT(false);
+		}
+
+		ShaderStageSource source;
+		source.Type = shaderType;
+		source.Path = shaderPath;
+		source.PreprocessedSource = std::string(result.cbegin(), result.cend());
+		source.Hash = VulkanPipelineCache::Hash(source.PreprocessedSource.data(), source.PreprocessedSource.size());
+		VulkanPipelineCache::HashCombine(source.Hash, c_ShaderCacheVersion);
+		VulkanPipelineCache::HashCombine(source.Hash, shaderKind);
+		VulkanPipelineCache::HashCombine(source.Hash, c_ShaderEnvVersion);
+		return source;
+	}
+
+	std::vector<uint32> VulkanShaderLibrary::GetShaderBinary(const ShaderStageSource& source, bool optimize)
+	{
+		NEO_PROFILE_SCOPE_CATEGORY("VulkanShaderLibrary::GetShaderBinary", "Shader");
+
+		auto start = std::chrono::steady_clock::now();
+
+		std::string cachePath = GetCachePath(source, optimize, "cached_vulkan");
+		std::vector<uint32> shaderBinary;
+		if (File::ReadFromFile(cachePath, shaderBinary, true) && (shaderBinary.empty() || shaderBinary[0] != c_SpirvMagic))
+		{
+			NEO_CORE_WARN("VulkanShaderLibrary: ignoring invalid cached binary {0}", cachePath);
+			shaderBinary.clear();
+		}
+
+		const bool cached = !shaderBinary.empty();
+		if (!cached)
+		{
+			shaderc::Compiler compiler;
+			shaderc::CompileOptions options;
+			options.SetTargetEnvironment(shaderc_target_env_vulkan, c_ShaderEnvVersion);
+			options.SetOptimizationLevel(optimize ? shaderc_optimization_level_performance : shaderc_optimization_level_zero);
+
+			shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(
+				source.PreprocessedSource, ShaderTypeToShadercShaderType(source.Type), source.Path.c_str(), options);
+			if (module.GetCompilationStatus() != shaderc_compilation_status_success)
+			{
+				NEO_CORE_ERROR(module.GetErrorMessage());
+				NEO_CORE_ASSERT(false);
+				return {};
+			}
+
+			shaderBinary = std::vector<uint32>(module.cbegin(), module.cend());
+
+			std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path());
+			if (!File::WriteToFileAtomic(cachePath, shaderBinary, true))
+			{
+				NEO_CORE_WARN("VulkanShaderLibrary: could not write cached binary {0}", cachePath);
+			}
+		}
+
+		double milliseconds =
+			std::chrono::duration<double, std::chrono::milliseconds::period>(std::chrono::steady_clock::now() - start).count();
+
+		std::lock_guard<std::mutex> lock(s_StatsMutex);
+		if (cached)
+		{
+			s_CachedCount++;
+			s_CacheMilliseconds += milliseconds;
+		}
+		else
+		{
+			s_CompiledCount++;
+			s_CompileMilliseconds += milliseconds;
+		}
+		return shaderBinary;
+	}
+
+	std::vector<ShaderStageResource> VulkanShaderLibrary::GetShaderResources(const ShaderStageSource& source)
+	{
+		NEO_PROFILE_SCOPE_CATEGORY("VulkanShaderLibrary::GetShaderResources", "Shader");
+
+		// The optimizer drops resources a stage never reads, materials still set them
+		std::string cachePath = GetCachePath(source, false, "cached_reflection");
+		std::vector<uint8> data;
+		std::vector<ShaderStageResource> resources;
+		if (File::ReadFromFile(cachePath, data, true) && DeserializeShaderResources(data, resources))
+		{
+			return resources;
+		}
+
+		std::vector<uint32> shaderBinary = GetShaderBinary(source, false);
+
+		auto start = std::chrono::steady_clock::now();
+		resources = ReflectShaderResources(shaderBinary);
+		if (!File::WriteToFileAtomic(cachePath, SerializeShaderResources(resources), true))
+		{
+			NEO_CORE_WARN("VulkanShaderLibrary: could not write cached reflection {0}", cachePath);
+		}
+		double milliseconds =
+			std::chrono::duration<double, std::chrono::milliseconds::period>(std::chrono::steady_clock::now() - start).count();
+
+		NEO_CORE_TRACE("VulkanShaderLibrary: reflected {0} resources of {1}", resources.size(), source.Path);
+
+		std::lock_guard<std::mutex> lock(s_StatsMutex);
+		s_ReflectedCount++;
+		s_ReflectMilliseconds += milliseconds;
+		return resources;
+	}
+
+	std::string VulkanShaderLibrary::GetKey(const ShaderSpecification& specification)
+	{
+		// Unordered maps of equal specifications don't have to iterate in the same order
+		std::map<ShaderType, std::string> shaderPaths(specification.ShaderPaths.begin(), specification.ShaderPaths.end());
+		std::map<std::string, uint32> variableCounts(specification.ShaderVariableCounts.begin(),
+													 specification.ShaderVariableCounts.end());
+
+		std::string key;
+		for (const auto& [shaderType, shaderPath] : shaderPaths)
+		{
+			key += std::to_string(static_cast<int>(shaderType)) + ":" + shaderPath + ";";
+		}
+		for (const auto& [name, count] : variableCounts)
+		{
+			key += name + "=" + std::to_string(count) + ";";
+		}
+		return key;
+	}
+
+	std::string VulkanShaderLibrary::GetCachePath(const ShaderStageSource& source, bool optimize, const char* extension)
+	{
+		uint64 hash = source.Hash;
+		VulkanPipelineCache::HashCombine(hash, optimize);
+
+		std::filesystem::path path = source.Path;
+		std::stringstream fileName;
+		fileName << path.filename().string() << "." << std::hex << std::setw(16) << std::setfill('0') << hash << "."
+				 << extension;
+		return (path.parent_path() / "cached" / fileName.str()).string();
+	}
+} // namespace Neon
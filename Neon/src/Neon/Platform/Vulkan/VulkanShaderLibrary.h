@@ -0,0 +1,237 @@
+#pragma once
+
+#include "Neon/Renderer/Shader.h"
+#include "Vulkan.h"
+
+#include <future>
+#include <mutex>
+
+namespace Neon
+{
+	enum class ShaderResourceKind : uint32
+	{
+		UniformBuffer,
+		StorageBuffer,
+		ImageSampler,
+		StorageImage,
+		PushConstant
+	};
+
+	// Resource of a single stage as declared in its source, before the variable counts of a specification are applied
+	struct ShaderStageResource
+	{
+		ShaderResourceKind Kind = ShaderResourceKind::UniformBuffer;
+		std::string Name;
+		// Descriptor set index, unused by push constants
+		uint32 Set = 0;
+		uint32 BindingPoint = 0;
+		// Declared array size, 1 for single resources
+		uint32 Count = 1;
+		// Struct size of buffers, a single element for runtime arrays
+		uint32 Size = 0;
+	};
+
+	// Stage file after includes and defines are resolved, everything cached for it is keyed by its hash
+	struct ShaderStageSource
+	{
+		ShaderType Type = ShaderType::Vertex;
+		std::string Path;
+		std::string PreprocessedSource;
+		uint64 Hash = 0;
+	};
+
+	// Compiled stages and reflected resource layout of a shader specification. Shared by all shaders created from it, each of
+	// them only owns the material descriptor set and the resources bound to it. Per frame data lives in the frame set of the
+	// context, see VulkanFrameDescriptors.
+	class VulkanShaderProgram : public RefCounted
+	{
+	public:
+		static constexpr uint32 c_MaxDynamicUniformBuffers = 8;
+
+		// Every pipeline layout starts with the shared frame set, so it stays bound while pipelines and materials change
+		static constexpr uint32 c_FrameDescriptorSet = 0;
+		static constexpr uint32 c_MaterialDescriptorSet = 1;
+
+		struct UniformBufferLayout
+		{
+			std::string Name;
+			uint32 BindingPoint = 0;
+			uint32 Count = 0;
+			uint32 Size = 0;
+			vk::ShaderStageFlags ShaderStage;
+
+			// Single buffers live in the uniform ring and are bound with a dynamic offset, arrays get a mapped buffer
+			// per element
+			bool Dynamic = false;
+		};
+
+		struct StorageBufferLayout
+		{
+			std::string Name;
+			uint32 BindingPoint = 0;
+			uint32 Size = 0;
+			vk::ShaderStageFlags ShaderStage;
+		};
+
+		struct ImageLayout
+		{
+			std::string Name;
+			uint32 BindingPoint = 0;
+			uint32 Count = 0;
+			vk::ShaderStageFlags ShaderStage;
+		};
+
+		struct PushConstantLayout
+		{
+			std::string Name;
+			uint32 Size = 0;
+			vk::ShaderStageFlags ShaderStage;
+		};
+
+		static constexpr uint32 c_InvalidParamIndex = UINT32_MAX;
+
+		struct ParamSlot
+		{
+			ShaderResourceKind Kind = ShaderResourceKind::UniformBuffer;
+			// Into the layouts of that kind, which shaders mirror with their resources
+			uint32 Index = c_InvalidParamIndex;
+		};
+
+		VulkanShaderProgram(const ShaderSpecification& specification);
+		~VulkanShaderProgram() = default;
+
+		const std::vector<vk::PipelineShaderStageCreateInfo>& GetShaderStages() const
+		{
+			return m_ShaderStages;
+		}
+		// Layout of the material set
+		vk::DescriptorSetLayout GetDescriptorSetLayout() const
+		{
+			return m_DescriptorSetLayout.get();
+		}
+		// True if any stage reads the frame set
+		bool UsesFrameData() const
+		{
+			return m_UsesFrameData;
+		}
+		// Enough for exactly one material set
+		const std::vector<vk::DescriptorPoolSize>& GetDescriptorPoolSizes() const
+		{
+			return m_DescriptorPoolSizes;
+		}
+
+		const std::vector<UniformBufferLayout>& GetUniformBuffers() const
+		{
+			return m_UniformBuffers;
+		}
+		const std::vector<StorageBufferLayout>& GetStorageBuffers() const
+		{
+			return m_StorageBuffers;
+		}
+		const std::vector<ImageLayout>& GetImageSamplers() const
+		{
+			return m_ImageSamplers;
+		}
+		const std::vector<ImageLayout>& GetStorageImages() const
+		{
+			return m_StorageImages;
+		}
+		const std::vector<PushConstantLayout>& GetPushConstants() const
+		{
+			return m_PushConstants;
+		}
+
+		// Returns nullptr if the program has no resource of that name
+		const ParamSlot* FindParam(const ShaderParamHandle& param) const
+		{
+			if (param.GetId() >= m_ParamSlots.size() || m_ParamSlots[param.GetId()].Index == c_InvalidParamIndex)
+			{
+				return nullptr;
+			}
+			return &m_ParamSlots[param.GetId()];
+		}
+
+		// Equal for programs with identical stages and descriptor layout, their pipelines are interchangeable
+		uint64 GetHash() const
+		{
+			return m_Hash;
+		}
+
+	private:
+		void CreateShader(ShaderType shaderType, const std::vector<uint32>& shaderBinary);
+		void AddStageResources(ShaderType shaderType, const std::vector<ShaderStageResource>& resources);
+
+		void ResolveParams();
+		void CreateDescriptorSetLayout();
+
+	private:
+		ShaderSpecification m_Specification;
+
+		std::vector<vk::UniqueShaderModule> m_ShaderModules;
+		std::vector<vk::PipelineShaderStageCreateInfo> m_ShaderStages;
+
+		vk::UniqueDescriptorSetLayout m_DescriptorSetLayout;
+		std::vector<vk::DescriptorPoolSize> m_DescriptorPoolSizes;
+
+		std::vector<UniformBufferLayout> m_UniformBuffers;
+		std::vector<StorageBufferLayout> m_StorageBuffers;
+		std::vector<ImageLayout> m_ImageSamplers;
+		std::vector<ImageLayout> m_StorageImages;
+		std::vector<PushConstantLayout> m_PushConstants;
+		bool m_UsesFrameData = false;
+
+		// Indexed by ShaderParamHandle id, resolved once after reflection
+		std::vector<ParamSlot> m_ParamSlots;
+
+		uint64 m_Hash = 0;
+	};
+
+	// Programs of the shaders currently alive, keyed by their stage paths and variable counts. Vertex layouts only matter to
+	// pipelines, so they are not part of the key.
+	class VulkanShaderLibrary
+	{
+	public:
+		// Compiles and reflects the specification only if no living shader was created from it. Different specifications
+		// load in parallel, concurrent requests for the same one wait for the first.
+		static SharedRef<VulkanShaderProgram> GetOrLoad(const ShaderSpecification& specification);
+
+		// Compiles every stage file below the directory as parallel jobs, programs created afterwards only read the cache.
+		// Stage types are taken from the file name suffix, e.g. "_Vert.glsl".
+		static void CompileDirectory(const std::string& directory);
+
+		static ShaderStageSource PreprocessShader(ShaderType shaderType, const std::string& shaderPath);
+		// SPIR-V of a stage. Cached next to its file under the source hash and the compile options, so edited includes or
+		// defines never reuse a stale binary.
+		static std::vector<uint32> GetShaderBinary(const ShaderStageSource& source, bool optimize);
+		// Reflected from the unoptimized binary with spirv-cross only if no reflection is cached next to it
+		static std::vector<ShaderStageResource> GetShaderResources(const ShaderStageSource& source);
+
+	private:
+		static std::string GetKey(const ShaderSpecification& specification);
+		static std::string GetCachePath(const ShaderStageSource& source, bool optimize, const char* extension);
+
+	private:
+		struct ProgramEntry
+		{
+			WeakRef<VulkanShaderProgram> Program;
+			// Valid while a thread builds the program
+			std::shared_future<SharedRef<VulkanShaderProgram>> Loading;
+		};
+
+		inline static std::mutex s_Mutex;
+		inline static std::unordered_map<std::string, ProgramEntry> s_Programs;
+
+		inline static uint32 s_LoadedCount = 0;
+		inline static uint32 s_SharedCount = 0;
+		inline static double s_LoadMilliseconds = 0.0;
+
+		// Summed over all threads, compared between cold and warm starts to see what the cache saves
+		inline static std::mutex s_StatsMutex;
+		inline static uint32 s_CompiledCount = 0;
+		inline static uint32 s_CachedCount = 0;
+		inline static double s_CompileMilliseconds = 0.0;
+		inline static double s_CacheMilliseconds = 0.0;
+		inline static uint32 s_ReflectedCount = 0;
+		inline static double s_ReflectMilliseconds = 0.0;
+	};
+} // namespace Neon
@@ -10,6 +10,12 @@ namespace Neon
 {
 	VulkanSwapChain::~VulkanSwapChain()
 	{
+		// Never initialized when the context runs headless
+		if (!m_Device)
+		{
+			return;
+		}
+
 		m_Device->GetHandle().waitIdle();
 		m_Device->GetHandle().destroySwapchainKHR(m_Handle);
 	}
@@ -329,12 +335,11 @@ namespace Neon
 	void VulkanSwapChain::Present()
 	{
 		auto& vulkanGraphicsCommandBuffer = RendererContext::Get()->GetPrimaryRenderCommandBuffer().As<VulkanCommandBuffer>();
-		// Pipeline stage at which the queue submission will wait (via pWaitSemaphores)
-		vulkanGraphicsCommandBuffer->SetWaitStage(vk::PipelineStageFlagBits::eColorAttachmentOutput);
 		vulkanGraphicsCommandBuffer->AddSignalSemaphore(
 			m_Semaphores[m_ImageIndexToSemaphoreIndex[m_CurrentFrameIndex]].RenderComplete.get());
-		vulkanGraphicsCommandBuffer->AddWaitSemaphore(
-			m_Semaphores[m_ImageIndexToSemaphoreIndex[m_CurrentFrameIndex]].ImageAcquired.get());
+		// Pipeline stage at which the queue submission will wait (via pWaitSemaphores)
+		vulkanGraphicsCommandBuffer->AddWaitSemaphore(m_Semaphores[m_ImageIndexToSemaphoreIndex[m_CurrentFrameIndex]].ImageAcquired.get(),
+													  vk::PipelineStageFlagBits::eColorAttachmentOutput);
 		vulkanGraphicsCommandBuffer->SetFence(m_WaitFences[m_CurrentFrameIndex].get());
 
 		vulkanGraphicsCommandBuffer->Submit();
@@ -382,6 +387,7 @@ namespace Neon
 			presentInfo.waitSemaphoreCount = 1;
 			presentInfo.pWaitSemaphores = &waitSemaphore;
 		}
+		std::lock_guard<std::mutex> lock(m_Device->GetQueueMutex());
 		return queue.presentKHR(presentInfo);
 	}
 
@@ -427,10 +433,7 @@ namespace Neon
 
 		vk::Device device = m_Device->GetHandle();
 		m_DepthStencil.Image = device.createImageUnique(imageCreateInfo);
-		vk::MemoryRequirements memReqs = device.getImageMemoryRequirements(m_DepthStencil.Image.get());
-
-		m_Allocator.Allocate(memReqs, m_DepthStencil.DeviceMemory);
-		device.bindImageMemory(m_DepthStencil.Image.get(), m_DepthStencil.DeviceMemory.get(), 0);
+		m_Allocator.AllocateImage(m_DepthStencil.Image.get(), m_DepthStencil.Memory);
 
 		vk::ImageViewCreateInfo imageViewCI{};
 		imageViewCI.viewType = vk::ImageViewType::e2D;
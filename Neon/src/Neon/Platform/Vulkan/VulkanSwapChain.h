@@ -109,7 +109,7 @@ namespace Neon
 		struct
 		{
 			vk::UniqueImage Image;
-			vk::UniqueDeviceMemory DeviceMemory;
+			VulkanAllocation Memory;
 			vk::UniqueImageView ImageView;
 		} m_DepthStencil;
 
@@ -1,25 +1,24 @@
 #include "neopch.h"
 
-#include "Neon/Core/ThreadPool.h"
+#include "Neon/Core/Profiler.h"
+#include "Neon/Math/HalfFloat.h"
 #include "Neon/Platform/Vulkan/VulkanContext.h"
 #include "Neon/Platform/Vulkan/VulkanRenderPass.h"
 #include "VulkanTexture.h"
 
-#include <softfloat/softfloat.h>
-
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 namespace Neon
 {
-	static void GenerateMipMaps(vk::CommandBuffer vulkanCommandBuffer, const VulkanImage& image,
+	static void GenerateMipMaps(vk::CommandBuffer vulkanCommandBuffer, vk::Image image, uint32 width, uint32 height,
 								vk::ImageMemoryBarrier& imageMemoryBarrier, vk::ImageLayout layout)
 	{
 		uint32 mipCount = imageMemoryBarrier.subresourceRange.levelCount;
 		imageMemoryBarrier.subresourceRange.levelCount = 1;
 
-		uint32 mipWidth = image.Width;
-		uint32 mipHeight = image.Height;
+		uint32 mipWidth = width;
+		uint32 mipHeight = height;
 		for (uint32 i = 1; i < mipCount; i++)
 		{
 			imageMemoryBarrier.subresourceRange.baseMipLevel = i - 1;
@@ -46,8 +45,8 @@ namespace Neon
 			blit.dstSubresource.baseArrayLayer = 0;
 			blit.dstSubresource.layerCount = imageMemoryBarrier.subresourceRange.layerCount;
 
-			vulkanCommandBuffer.blitImage(image.Handle.get(), vk::ImageLayout::eTransferSrcOptimal, image.Handle.get(),
-										  vk::ImageLayout::eTransferDstOptimal, 1, &blit, vk::Filter::eLinear);
+			vulkanCommandBuffer.blitImage(image, vk::ImageLayout::eTransferSrcOptimal, image, vk::ImageLayout::eTransferDstOptimal, 1,
+										  &blit, vk::Filter::eLinear);
 
 			imageMemoryBarrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
 			imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
@@ -88,6 +87,8 @@ namespace Neon
 	VulkanTexture2D::VulkanTexture2D(const std::string& path, const TextureSpecification& specification)
 		: Texture2D(path, specification)
 	{
+		NEO_PROFILE_SCOPE_CATEGORY("VulkanTexture2D::Load", "Loading");
+
 		m_Specification.Update = true;
 
 		int width, height, channels;
@@ -100,30 +101,8 @@ namespace Neon
 
 			if (data)
 			{
-				auto* newData = new uint16[width * (size_t)height * (size_t)GetBytesPerPixel(m_Specification.Format)];
-				{
-					ThreadPool pool;
-
-					auto task = [data, newData, width](uint32 low, uint32 high) {
-						for (uint32 y = low; y < high; y++)
-						{
-							float* src = data + 3 * (size_t)width * y;
-							uint16* dest = newData + 4 * (size_t)width * y;
-							for (uint32 x = 0; x < static_cast<uint32>(width); x++)
-							{
-								dest[4 * x] = float_to_sf16(src[3 * x], SF_NEARESTEVEN);
-								dest[4 * x + 1] = float_to_sf16(src[3 * x + 1], SF_NEARESTEVEN);
-								dest[4 * x + 2] = float_to_sf16(src[3 * x + 2], SF_NEARESTEVEN);
-							}
-						}
-					};
-
-					uint32 step = height / pool.GetThreadCount();
-					for (uint32 i = 0; i < static_cast<uint32>(height); i += step)
-					{
-						pool.QueueTask(task, i, std::min((uint32)height - 1, i + step));
-					}
-				}
+				auto* newData = new uint16[4 * width * (size_t)height];
+				ConvertRGB32FToRGBA16FParallel(data, newData, static_cast<uint32>(width), static_cast<uint32>(height));
 
 				stbi_image_free(data);
 
@@ -145,14 +124,14 @@ namespace Neon
 		}
 		else
 		{
-			m_Image.Width = width;
-			m_Image.Height = height;
+			m_Image->Width = width;
+			m_Image->Height = height;
 
 			uint32 bytesPerPixel = GetBytesPerPixel(m_Specification.Format);
 
 			m_Data.Size = width * height * bytesPerPixel;
 
-			m_MipLevelCount = CalculateMaxMipMapCount(m_Image.Width, m_Image.Height);
+			m_MipLevelCount = CalculateMaxMipMapCount(m_Image->Width, m_Image->Height);
 
 			Invalidate();
 			Update();
@@ -195,7 +174,7 @@ namespace Neon
 		vk::ImageMemoryBarrier imageMemoryBarrier{};
 		imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 		imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		imageMemoryBarrier.image = m_Image.Handle.get();
+		imageMemoryBarrier.image = m_Image->Handle.get();
 		imageMemoryBarrier.subresourceRange = subresourceRange;
 		imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
 		imageMemoryBarrier.oldLayout = vk::ImageLayout::eUndefined;
@@ -204,7 +183,7 @@ namespace Neon
 		vulkanCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eHost, vk::PipelineStageFlagBits::eTransfer,
 											vk::DependencyFlags(), 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
 
-		GenerateMipMaps(vulkanCommandBuffer, m_Image, imageMemoryBarrier, m_Layout);
+		GenerateMipMaps(vulkanCommandBuffer, m_Image->Handle.get(), m_Image->Width, m_Image->Height, imageMemoryBarrier, m_Layout);
 
 		VulkanContext::Get()->SubmitCommandBuffer(commandBuffer);
 	}
@@ -213,7 +192,7 @@ namespace Neon
 	{
 		m_Allocator = VulkanAllocator(VulkanContext::GetDevice(), "Texture2D");
 
-		m_MipLevelCount = m_Specification.UseMipmap ? CalculateMaxMipMapCount(m_Image.Width, m_Image.Height) : 1;
+		m_MipLevelCount = m_Specification.UseMipmap ? CalculateMaxMipMapCount(m_Image->Width, m_Image->Height) : 1;
 
 		auto device = VulkanContext::GetDevice();
 		auto deviceHandle = device->GetHandle();
@@ -229,7 +208,7 @@ namespace Neon
 		imageCreateInfo.sharingMode = vk::SharingMode::eExclusive;
 		// Set initial layout of the image to undefined
 		imageCreateInfo.initialLayout = vk::ImageLayout::eUndefined;
-		imageCreateInfo.extent = {m_Image.Width, m_Image.Height, 1};
+		imageCreateInfo.extent = {m_Image->Width, m_Image->Height, 1};
 		if (m_Specification.UsageFlags & TextureUsageFlagBits::DepthAttachment)
 		{
 			m_Layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
@@ -268,11 +247,9 @@ namespace Neon
 			imageCreateInfo.usage |= vk::ImageUsageFlagBits::eStorage;
 		}
 
-		m_Image.Handle = deviceHandle.createImageUnique(imageCreateInfo);
+		m_Image->Handle = deviceHandle.createImageUnique(imageCreateInfo);
 
-		vk::MemoryRequirements memoryRequirements = deviceHandle.getImageMemoryRequirements(m_Image.Handle.get());
-		m_Allocator.Allocate(memoryRequirements, m_Image.DeviceMemory, vk::MemoryPropertyFlagBits::eDeviceLocal);
-		deviceHandle.bindImageMemory(m_Image.Handle.get(), m_Image.DeviceMemory.get(), 0);
+		m_Allocator.AllocateImage(m_Image->Handle.get(), m_Image->Memory, vk::MemoryPropertyFlagBits::eDeviceLocal);
 
 		// Create a texture sampler
 		// In Vulkan textures are accessed by samplers
@@ -324,7 +301,7 @@ namespace Neon
 		imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
 		imageViewCreateInfo.subresourceRange.layerCount = 1;
 		// The view will be based on the texture's image
-		imageViewCreateInfo.image = m_Image.Handle.get();
+		imageViewCreateInfo.image = m_Image->Handle.get();
 
 		// Linear tiling usually won't support mip maps
 		// Only set mip map count if optimal tiling is used
@@ -343,82 +320,28 @@ namespace Neon
 		// Don't update depth attachments
 		NEO_CORE_ASSERT(m_Specification.Format != TextureFormat::Depth);
 
-		m_Allocator = VulkanAllocator(VulkanContext::GetDevice(), "Texture2D");
-
-		auto device = VulkanContext::GetDevice();
-		auto deviceHandle = device->GetHandle();
-
-		uint32 size = m_Data.Size;
-
-		uint32 bytesPerPixel = GetBytesPerPixel(m_Specification.Format);
-
-		// Copy data to an optimal tiled image
-
-		// Create a host-visible staging buffer that contains the raw image data
-		// This buffer will be the data source for copying texture data to the optimal tiled image on the device
-		VulkanBuffer stagingBuffer;
-		m_Allocator.AllocateBuffer(stagingBuffer, size, vk::BufferUsageFlagBits::eTransferSrc,
-								   vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-
-		// Copy texture data into host local staging buffer
-		m_Allocator.UpdateBuffer(stagingBuffer, m_Data.Data);
-
-		vk::BufferImageCopy bufferCopyRegion = {};
-		bufferCopyRegion.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-		bufferCopyRegion.imageSubresource.mipLevel = 0;
-		bufferCopyRegion.imageSubresource.baseArrayLayer = 0;
-		bufferCopyRegion.imageSubresource.layerCount = 1;
-		bufferCopyRegion.imageExtent.width = m_Image.Width;
-		bufferCopyRegion.imageExtent.height = m_Image.Height;
-		bufferCopyRegion.imageExtent.depth = 1;
-		bufferCopyRegion.bufferOffset = 0;
-
-		auto& commandBuffer = VulkanContext::Get()->GetCommandBuffer(CommandBufferType::Graphics, true);
-		vk::CommandBuffer copyCmd = (VkCommandBuffer)commandBuffer->GetHandle();
-
-		// Image memory barriers for the texture image
-
-		// The sub resource range describes the regions of the image that will be transitioned using the memory barriers below
-		vk::ImageSubresourceRange subresourceRange = {};
-		// Image only contains color data
-		subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-		// Start at first mip level
-		subresourceRange.baseMipLevel = 0;
-		// We will transition on all mip levels
-		subresourceRange.levelCount = m_MipLevelCount;
-		// The 2D texture only has one layer
-		subresourceRange.baseArrayLayer = 0;
-		subresourceRange.layerCount = 1;
-
-		// Transition the texture image layout to transfer target, so we can safely copy our buffer data to it.
-		vk::ImageMemoryBarrier imageMemoryBarrier{};
-		imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		imageMemoryBarrier.image = m_Image.Handle.get();
-		imageMemoryBarrier.subresourceRange = subresourceRange;
-		imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
-		imageMemoryBarrier.oldLayout = vk::ImageLayout::eUndefined;
-		imageMemoryBarrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
-
-		// Insert a memory dependency at the proper pipeline stages that will execute the image layout transition
-		// Source pipeline stage is host write/read execution (VK_PIPELINE_STAGE_HOST_BIT)
-		// Destination pipeline stage is copy command execution (VK_PIPELINE_STAGE_TRANSFER_BIT)
-		copyCmd.pipelineBarrier(vk::PipelineStageFlagBits::eHost, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), 0,
-								nullptr, 0, nullptr, 1, &imageMemoryBarrier);
-
-		// Copy mip levels from staging buffer
-		copyCmd.copyBufferToImage(stagingBuffer.Handle.get(), m_Image.Handle.get(), vk::ImageLayout::eTransferDstOptimal, 1,
-								  &bufferCopyRegion);
-
-		GenerateMipMaps(copyCmd, m_Image, imageMemoryBarrier, m_Layout);
-
-		VulkanContext::Get()->SubmitCommandBuffer(commandBuffer);
+		// Copy data to an optimal tiled image on the transfer queue, mips are generated once the graphics queue owns it
+		vk::Image image = m_Image->Handle.get();
+		uint32 width = m_Image->Width;
+		uint32 height = m_Image->Height;
+		uint32 mipLevelCount = m_MipLevelCount;
+		vk::ImageLayout layout = m_Layout;
+		VulkanContext::GetUploadManager().UploadImage(
+			m_Image, width, height, 1, mipLevelCount, m_Data.Data, m_Data.Size, [=](vk::CommandBuffer commandBuffer) {
+				vk::ImageMemoryBarrier imageMemoryBarrier{};
+				imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				imageMemoryBarrier.image = image;
+				imageMemoryBarrier.subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, mipLevelCount, 0, 1};
+
+				GenerateMipMaps(commandBuffer, image, width, height, imageMemoryBarrier, layout);
+			});
 	}
 
 	void VulkanTexture2D::CreateDefault()
 	{
-		m_Image.Width = m_Specification.Width;
-		m_Image.Height = m_Specification.Height;
+		m_Image->Width = m_Specification.Width;
+		m_Image->Height = m_Specification.Height;
 
 		m_Specification.UsageFlags |= TextureUsageFlagBits::ShaderRead;
 
@@ -426,7 +349,7 @@ namespace Neon
 
 		if (m_Specification.Update)
 		{
-			m_Data.Size = m_Image.Width * m_Image.Height * GetBytesPerPixel(m_Specification.Format);
+			m_Data.Size = m_Image->Width * m_Image->Height * GetBytesPerPixel(m_Specification.Format);
 			m_Data.Data = new byte[m_Data.Size];
 			memset(m_Data.Data, 255, m_Data.Size);
 			Update();
@@ -489,6 +412,8 @@ namespace Neon
 	VulkanTextureCube::VulkanTextureCube(const std::string& path, const TextureSpecification& specification)
 		: TextureCube(path, specification)
 	{
+		NEO_PROFILE_SCOPE_CATEGORY("VulkanTextureCube::Load", "Loading");
+
 		int width, height, channels;
 		stbi_set_flip_vertically_on_load(false);
 
@@ -633,7 +558,7 @@ namespace Neon
 		vk::ImageMemoryBarrier imageMemoryBarrier{};
 		imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 		imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		imageMemoryBarrier.image = m_Image.Handle.get();
+		imageMemoryBarrier.image = m_Image->Handle.get();
 		imageMemoryBarrier.subresourceRange = subresourceRange;
 		imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
 		imageMemoryBarrier.oldLayout = vk::ImageLayout::eUndefined;
@@ -642,7 +567,7 @@ namespace Neon
 		vulkanCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eHost, vk::PipelineStageFlagBits::eTransfer,
 											vk::DependencyFlags(), 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
 
-		GenerateMipMaps(vulkanCommandBuffer, m_Image, imageMemoryBarrier, m_Layout);
+		GenerateMipMaps(vulkanCommandBuffer, m_Image->Handle.get(), m_Image->Width, m_Image->Height, imageMemoryBarrier, m_Layout);
 
 		VulkanContext::Get()->SubmitCommandBuffer(commandBuffer);
 	}
@@ -660,15 +585,13 @@ namespace Neon
 
 		m_Allocator = VulkanAllocator(VulkanContext::GetDevice(), "TextureCube");
 
-		m_Image.Width = m_Image.Height = m_FaceSize;
+		m_Image->Width = m_Image->Height = m_FaceSize;
 
-		m_MipLevelCount = m_Specification.UseMipmap ? CalculateMaxMipMapCount(m_Image.Width, m_Image.Height) : 1;
+		m_MipLevelCount = m_Specification.UseMipmap ? CalculateMaxMipMapCount(m_Image->Width, m_Image->Height) : 1;
 
 		auto device = VulkanContext::GetDevice();
 		auto deviceHandle = device->GetHandle();
 
-		uint32 bytesPerPixel = GetBytesPerPixel(m_Specification.Format);
-
 		// Create optimal tiled target image on the device
 		vk::ImageCreateInfo imageCreateInfo{};
 		imageCreateInfo.flags = vk::ImageCreateFlagBits::eCubeCompatible;
@@ -685,73 +608,25 @@ namespace Neon
 		// TODO: Check which usages are necessary
 		imageCreateInfo.usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc |
 								vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage;
-		m_Image.Handle = deviceHandle.createImageUnique(imageCreateInfo);
-
-		VulkanBuffer stagingBuffer;
-		uint32 size = m_Data.Size;
-
-		m_Allocator.AllocateBuffer(stagingBuffer, size, vk::BufferUsageFlagBits::eTransferSrc,
-								   vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-
-		m_Allocator.UpdateBuffer(stagingBuffer, m_Data.Data);
-
-		vk::MemoryRequirements memoryRequirements = deviceHandle.getImageMemoryRequirements(m_Image.Handle.get());
-		m_Allocator.Allocate(memoryRequirements, m_Image.DeviceMemory, vk::MemoryPropertyFlagBits::eDeviceLocal);
-		deviceHandle.bindImageMemory(m_Image.Handle.get(), m_Image.DeviceMemory.get(), 0);
-
-		auto& commandBuffer = VulkanContext::Get()->GetCommandBuffer(CommandBufferType::Graphics, true);
-		vk::CommandBuffer copyCmd = (VkCommandBuffer)commandBuffer->GetHandle();
-
-		// Image memory barriers for the texture image
-
-		// The sub resource range describes the regions of the image that will be transitioned using the memory barriers below
-		vk::ImageSubresourceRange subresourceRange = {};
-		// Image only contains color data
-		subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-		// Start at first mip level
-		subresourceRange.baseMipLevel = 0;
-		// We will transition on all mip levels
-		subresourceRange.levelCount = m_MipLevelCount;
-		// The 2D texture only has one layer
-		subresourceRange.baseArrayLayer = 0;
-		subresourceRange.layerCount = 6;
-
-		// Transition the texture image layout to transfer target, so we can safely copy our buffer data to it.
-		vk::ImageMemoryBarrier imageMemoryBarrier{};
-		imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		imageMemoryBarrier.image = m_Image.Handle.get();
-		imageMemoryBarrier.subresourceRange = subresourceRange;
-		imageMemoryBarrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
-		imageMemoryBarrier.oldLayout = vk::ImageLayout::eUndefined;
-		imageMemoryBarrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
-
-		// Insert a memory dependency at the proper pipeline stages that will execute the image layout transition
-		// Source pipeline stage is host write/read execution (VK_PIPELINE_STAGE_HOST_BIT)
-		// Destination pipeline stage is copy command execution (VK_PIPELINE_STAGE_TRANSFER_BIT)
-		copyCmd.pipelineBarrier(vk::PipelineStageFlagBits::eHost, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), 0,
-								nullptr, 0, nullptr, 1, &imageMemoryBarrier);
-
-		vk::BufferImageCopy bufferCopyRegions[6];
-		for (uint32 i = 0; i < 6; i++)
-		{
-			bufferCopyRegions[i].imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-			bufferCopyRegions[i].imageSubresource.mipLevel = 0;
-			bufferCopyRegions[i].imageSubresource.baseArrayLayer = i;
-			bufferCopyRegions[i].imageSubresource.layerCount = 1;
-			bufferCopyRegions[i].imageExtent.width = m_FaceSize;
-			bufferCopyRegions[i].imageExtent.height = m_FaceSize;
-			bufferCopyRegions[i].imageExtent.depth = 1;
-			bufferCopyRegions[i].bufferOffset = static_cast<size_t>(i) * bytesPerPixel * m_FaceSize * m_FaceSize;
-		}
-
-		// Copy mip levels from staging buffer
-		copyCmd.copyBufferToImage(stagingBuffer.Handle.get(), m_Image.Handle.get(), vk::ImageLayout::eTransferDstOptimal, 6,
-								  bufferCopyRegions);
-
-		GenerateMipMaps(copyCmd, m_Image, imageMemoryBarrier, m_Layout);
-
-		VulkanContext::Get()->SubmitCommandBuffer(commandBuffer);
+		m_Image->Handle = deviceHandle.createImageUnique(imageCreateInfo);
+
+		m_Allocator.AllocateImage(m_Image->Handle.get(), m_Image->Memory, vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+		// Faces are copied on the transfer queue, mips are generated once the graphics queue owns the image
+		vk::Image image = m_Image->Handle.get();
+		uint32 faceSize = m_FaceSize;
+		uint32 mipLevelCount = m_MipLevelCount;
+		vk::ImageLayout layout = m_Layout;
+		VulkanContext::GetUploadManager().UploadImage(
+			m_Image, faceSize, faceSize, 6, mipLevelCount, m_Data.Data, m_Data.Size, [=](vk::CommandBuffer commandBuffer) {
+				vk::ImageMemoryBarrier imageMemoryBarrier{};
+				imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				imageMemoryBarrier.image = image;
+				imageMemoryBarrier.subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, mipLevelCount, 0, 6};
+
+				GenerateMipMaps(commandBuffer, image, faceSize, faceSize, imageMemoryBarrier, layout);
+			});
 
 		// Create a texture sampler
 		// In Vulkan textures are accessed by samplers
@@ -800,7 +675,7 @@ namespace Neon
 		imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
 		imageViewCreateInfo.subresourceRange.layerCount = 6;
 		// The view will be based on the texture's image
-		imageViewCreateInfo.image = m_Image.Handle.get();
+		imageViewCreateInfo.image = m_Image->Handle.get();
 
 		// Linear tiling usually won't support mip maps
 		// Only set mip map count if optimal tiling is used
@@ -816,8 +691,8 @@ namespace Neon
 	{
 		m_FaceSize = m_Specification.Width;
 
-		m_Image.Width = m_FaceSize;
-		m_Image.Height = m_FaceSize;
+		m_Image->Width = m_FaceSize;
+		m_Image->Height = m_FaceSize;
 
 		m_Data.Size = 6 * m_FaceSize * m_FaceSize * GetBytesPerPixel(m_Specification.Format);
 		m_Data.Data = new byte[m_Data.Size];
@@ -70,11 +70,11 @@ namespace Neon
 
 		uint32 GetWidth() const override
 		{
-			return m_Image.Width;
+			return m_Image->Width;
 		}
 		uint32 GetHeight() const override
 		{
-			return m_Image.Height;
+			return m_Image->Height;
 		}
 
 		Buffer GetTextureData() override
@@ -106,7 +106,7 @@ namespace Neon
 
 	private:
 		Buffer m_Data{};
-		VulkanImage m_Image{};
+		SharedRef<VulkanImage> m_Image = SharedRef<VulkanImage>::Create();
 
 		vk::ImageLayout m_Layout{};
 		vk::UniqueSampler m_Sampler{};
@@ -161,7 +161,7 @@ namespace Neon
 
 	private:
 		Buffer m_Data{};
-		VulkanImage m_Image{};
+		SharedRef<VulkanImage> m_Image = SharedRef<VulkanImage>::Create();
 
 		uint32 m_FaceSize;
 
@@ -0,0 +1,55 @@
+#include "neopch.h"
+
+#include "VulkanUniformBufferRing.h"
+
+namespace Neon
+{
+	VulkanUniformBufferRing::VulkanUniformBufferRing(const SharedRef<VulkanDevice>& device, uint32 framesInFlight,
+													 uint32 frameRegionSize)
+		: m_Device(device)
+	{
+		m_Alignment = static_cast<uint32>(device->GetPhysicalDevice()->GetProperties().limits.minUniformBufferOffsetAlignment);
+		m_FrameRegionSize = (frameRegionSize + m_Alignment - 1) & ~(m_Alignment - 1);
+
+		VulkanAllocator allocator(device, "UniformBufferRing");
+		allocator.AllocateBuffer(m_Buffer, m_FrameRegionSize * framesInFlight,
+								 vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eVertexBuffer |
+									 vk::BufferUsageFlagBits::eIndirectBuffer,
+								 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+		m_MappedData = static_cast<byte*>(m_Buffer.Memory.Map());
+	}
+
+	VulkanUniformBufferRing::~VulkanUniformBufferRing()
+	{
+		m_Buffer.Memory.Unmap();
+	}
+
+	void VulkanUniformBufferRing::BeginFrame(uint32 frameIndex)
+	{
+		m_RegionStart = frameIndex * m_FrameRegionSize;
+		m_RegionOffset = 0;
+		m_FrameNumber++;
+	}
+
+	bool VulkanUniformBufferRing::Push(const void* data, uint32 size, uint32& outOffset)
+	{
+		const uint32 alignedSize = (size + m_Alignment - 1) & ~(m_Alignment - 1);
+		const uint32 offset = m_RegionOffset.fetch_add(alignedSize, std::memory_order_relaxed);
+		if (static_cast<uint64>(offset) + alignedSize > m_FrameRegionSize)
+		{
+			// Earlier draws of this frame and regions of frames in flight keep their data, the draws missing theirs are
+			// dropped and counted in the command buffer stats
+			if (!m_OverflowReported.exchange(true, std::memory_order_relaxed))
+			{
+				NEO_CORE_ERROR("Uniform buffer ring overflow, frame region of {0} bytes is too small. Draws are dropped.",
+							   m_FrameRegionSize);
+			}
+			return false;
+		}
+
+		memcpy(m_MappedData + m_RegionStart + offset, data, size);
+		outOffset = m_RegionStart + offset;
+		return true;
+	}
+} // namespace Neon
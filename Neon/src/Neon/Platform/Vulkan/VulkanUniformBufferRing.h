@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Vulkan.h"
+#include "VulkanAllocator.h"
+
+#include <atomic>
+
+namespace Neon
+{
+	// Persistently mapped uniform buffer split into one region per frame in flight. Per draw uniform data is appended
+	// to the current region and bound through dynamic descriptor offsets, a region is reused once its frame finished.
+	// Per instance vertex data and indirect draw commands go through the same regions.
+	class VulkanUniformBufferRing
+	{
+	public:
+		VulkanUniformBufferRing(const SharedRef<VulkanDevice>& device, uint32 framesInFlight, uint32 frameRegionSize);
+		~VulkanUniformBufferRing();
+
+		// Has to be called after the fence of the frame slot was waited on
+		void BeginFrame(uint32 frameIndex);
+
+		// Copies data into the current frame region and returns its offset into the buffer. Returns false without writing
+		// anything when the data does not fit into what is left of the region, the work using it has to be dropped.
+		bool Push(const void* data, uint32 size, uint32& outOffset);
+
+		vk::Buffer GetBuffer() const
+		{
+			return m_Buffer.Handle.get();
+		}
+		uint64 GetFrameNumber() const
+		{
+			return m_FrameNumber;
+		}
+
+	private:
+		SharedRef<VulkanDevice> m_Device;
+		VulkanBuffer m_Buffer;
+		byte* m_MappedData = nullptr;
+
+		uint32 m_FrameRegionSize = 0;
+		uint32 m_Alignment = 0;
+
+		uint32 m_RegionStart = 0;
+		std::atomic<uint32> m_RegionOffset = 0;
+		uint64 m_FrameNumber = 0;
+		std::atomic<bool> m_OverflowReported = false;
+	};
+} // namespace Neon
@@ -0,0 +1,290 @@
+#include "neopch.h"
+
+#include "Neon/Core/Profiler.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanContext.h"
+#include "VulkanUploadManager.h"
+
+namespace Neon
+{
+	VulkanUploadManager::VulkanUploadManager(const SharedRef<VulkanDevice>& device, uint32 stagingSize)
+		: m_Device(device)
+		, m_Allocator(device, "UploadStaging")
+	{
+		m_TransferQueueFamily = device->GetPhysicalDevice()->GetTransferQueueIndex();
+		m_GraphicsQueueFamily = device->GetPhysicalDevice()->GetGraphicsQueueIndex();
+
+		m_TransferCommandPool = CommandPool::Create(CommandBufferType::Transfer);
+		m_GraphicsCommandPool = CommandPool::Create(CommandBufferType::Graphics);
+
+		vk::SemaphoreTypeCreateInfo semaphoreTypeInfo{vk::SemaphoreType::eTimeline, 0};
+		vk::SemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.pNext = &semaphoreTypeInfo;
+		m_Semaphore = device->GetHandle().createSemaphoreUnique(semaphoreInfo);
+
+		// Buffer to image copies need offsets aligned to the texel size, 16 covers every format we upload
+		m_Alignment = std::max<uint64>(16, device->GetPhysicalDevice()->GetProperties().limits.optimalBufferCopyOffsetAlignment);
+		m_RingSize = stagingSize;
+		m_Allocator.AllocateBuffer(m_Ring, stagingSize, vk::BufferUsageFlagBits::eTransferSrc,
+								   vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+		m_RingData = static_cast<byte*>(m_Ring.Memory.Map());
+	}
+
+	VulkanUploadManager::~VulkanUploadManager()
+	{
+		Flush();
+
+		vk::Semaphore semaphore = m_Semaphore.get();
+		vk::SemaphoreWaitInfo waitInfo{{}, 1, &semaphore, &m_SemaphoreValue};
+		VK_CHECK_RESULT(m_Device->GetHandle().waitSemaphores(waitInfo, UINT64_MAX));
+
+		m_Ring.Memory.Unmap();
+	}
+
+	void VulkanUploadManager::UploadBuffer(vk::Buffer buffer, const void* data, uint32 size, uint32 offset /*= 0*/)
+	{
+		NEO_CORE_ASSERT(size > 0, "Uploading buffer size of 0!");
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto [stagingBuffer, stagingOffset] = Stage(data, size);
+
+		vk::BufferCopy copyRegion{stagingOffset, offset, size};
+		GetTransferCommandBuffer().copyBuffer(stagingBuffer, buffer, 1, &copyRegion);
+
+		if (m_TransferQueueFamily != m_GraphicsQueueFamily)
+		{
+			vk::BufferMemoryBarrier& barrier = m_PendingBatch.BufferBarriers.emplace_back();
+			barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+			barrier.srcQueueFamilyIndex = m_TransferQueueFamily;
+			barrier.dstQueueFamilyIndex = m_GraphicsQueueFamily;
+			barrier.buffer = buffer;
+			barrier.offset = offset;
+			barrier.size = size;
+		}
+	}
+
+	void VulkanUploadManager::UploadImage(const SharedRef<VulkanImage>& image, uint32 width, uint32 height, uint32 layerCount, uint32 mipLevelCount,
+										  const void* data, uint32 size, std::function<void(vk::CommandBuffer)> finish)
+	{
+		NEO_CORE_ASSERT(size > 0 && size % layerCount == 0, "Image data has to be tightly packed layers!");
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto [stagingBuffer, stagingOffset] = Stage(data, size);
+		vk::CommandBuffer commandBuffer = GetTransferCommandBuffer();
+
+		vk::ImageMemoryBarrier barrier{};
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image->Handle.get();
+		barrier.subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, mipLevelCount, 0, layerCount};
+		barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+		barrier.oldLayout = vk::ImageLayout::eUndefined;
+		barrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
+		commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
+									  vk::DependencyFlags(), 0, nullptr, 0, nullptr, 1, &barrier);
+
+		std::vector<vk::BufferImageCopy> copyRegions(layerCount);
+		for (uint32 i = 0; i < layerCount; i++)
+		{
+			copyRegions[i].bufferOffset = stagingOffset + static_cast<uint64>(i) * (size / layerCount);
+			copyRegions[i].imageSubresource = {vk::ImageAspectFlagBits::eColor, 0, i, 1};
+			copyRegions[i].imageExtent = vk::Extent3D{width, height, 1};
+		}
+		commandBuffer.copyBufferToImage(stagingBuffer, image->Handle.get(), vk::ImageLayout::eTransferDstOptimal, layerCount,
+										copyRegions.data());
+
+		if (m_TransferQueueFamily != m_GraphicsQueueFamily)
+		{
+			barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+			barrier.dstAccessMask = {};
+			barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+			barrier.srcQueueFamilyIndex = m_TransferQueueFamily;
+			barrier.dstQueueFamilyIndex = m_GraphicsQueueFamily;
+			m_PendingBatch.ImageBarriers.push_back(barrier);
+		}
+		m_PendingBatch.FinishCallbacks.push_back(std::move(finish));
+		m_PendingBatch.Images.push_back(image);
+	}
+
+	void VulkanUploadManager::Flush()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		FlushPending();
+	}
+
+	std::pair<vk::Buffer, uint64> VulkanUploadManager::Stage(const void* data, uint32 size)
+	{
+		if (size > m_RingSize)
+		{
+			VulkanBuffer& stagingBuffer = m_PendingBatch.StagingBuffers.emplace_back();
+			m_Allocator.AllocateBuffer(stagingBuffer, size, vk::BufferUsageFlagBits::eTransferSrc,
+									   vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+			m_Allocator.UpdateBuffer(stagingBuffer, data, size);
+			return {stagingBuffer.Handle.get(), 0};
+		}
+
+		uint64 offset = (m_RingHead + m_Alignment - 1) & ~(m_Alignment - 1);
+		// Copies never wrap around the end of the ring
+		if (offset % m_RingSize + size > m_RingSize)
+		{
+			offset = (offset / m_RingSize + 1) * m_RingSize;
+		}
+
+		ReclaimBatches();
+		while (offset + size - m_RingTail > m_RingSize)
+		{
+			// Nothing staged is left in the ring, so the lap containing the offset is free
+			if (m_RingTail == m_RingHead)
+			{
+				m_RingTail = offset - offset % m_RingSize;
+				break;
+			}
+			WaitForOldestBatch();
+		}
+
+		m_RingHead = offset + size;
+		memcpy(m_RingData + offset % m_RingSize, data, size);
+		return {m_Ring.Handle.get(), offset % m_RingSize};
+	}
+
+	vk::CommandBuffer VulkanUploadManager::GetTransferCommandBuffer()
+	{
+		if (!m_PendingBatch.TransferCommandBuffer)
+		{
+			if (m_FreeTransferCommandBuffers.empty())
+			{
+				m_PendingBatch.TransferCommandBuffer = CommandBuffer::Create(m_TransferCommandPool);
+			}
+			else
+			{
+				m_PendingBatch.TransferCommandBuffer = std::move(m_FreeTransferCommandBuffers.back());
+				m_FreeTransferCommandBuffers.pop_back();
+			}
+			m_PendingBatch.TransferCommandBuffer->Begin();
+		}
+		return (VkCommandBuffer)m_PendingBatch.TransferCommandBuffer->GetHandle();
+	}
+
+	void VulkanUploadManager::FlushPending()
+	{
+		ReclaimBatches();
+		if (!m_PendingBatch.TransferCommandBuffer)
+		{
+			return;
+		}
+
+		NEO_PROFILE_FUNCTION();
+
+		Batch& batch = m_PendingBatch;
+		batch.TransferValue = ++m_SemaphoreValue;
+		batch.ReadyValue = ++m_SemaphoreValue;
+		batch.RingEnd = m_RingHead;
+
+		const uint32 bufferBarrierCount = static_cast<uint32>(batch.BufferBarriers.size());
+		const uint32 imageBarrierCount = static_cast<uint32>(batch.ImageBarriers.size());
+
+		// Release the resources to the graphics queue family
+		vk::CommandBuffer transferCommandBuffer = (VkCommandBuffer)batch.TransferCommandBuffer->GetHandle();
+		if (bufferBarrierCount > 0 || imageBarrierCount > 0)
+		{
+			transferCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe,
+												  vk::DependencyFlags(), 0, nullptr, bufferBarrierCount,
+												  batch.BufferBarriers.data(), imageBarrierCount, batch.ImageBarriers.data());
+		}
+
+		auto vulkanTransferCommandBuffer = batch.TransferCommandBuffer.As<VulkanCommandBuffer>();
+		vulkanTransferCommandBuffer->End();
+		vulkanTransferCommandBuffer->AddSignalSemaphore(m_Semaphore.get(), batch.TransferValue);
+		vulkanTransferCommandBuffer->Submit();
+
+		if (m_FreeGraphicsCommandBuffers.empty())
+		{
+			batch.GraphicsCommandBuffer = CommandBuffer::Create(m_GraphicsCommandPool);
+		}
+		else
+		{
+			batch.GraphicsCommandBuffer = std::move(m_FreeGraphicsCommandBuffers.back());
+			m_FreeGraphicsCommandBuffers.pop_back();
+		}
+		batch.GraphicsCommandBuffer->Begin();
+		vk::CommandBuffer graphicsCommandBuffer = (VkCommandBuffer)batch.GraphicsCommandBuffer->GetHandle();
+
+		// Acquire barriers have to match the release ones, only the destination access differs
+		const vk::AccessFlags readAccess = vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead |
+										   vk::AccessFlagBits::eUniformRead | vk::AccessFlagBits::eShaderRead |
+										   vk::AccessFlagBits::eTransferRead;
+		for (vk::BufferMemoryBarrier& barrier : batch.BufferBarriers)
+		{
+			barrier.srcAccessMask = {};
+			barrier.dstAccessMask = readAccess;
+		}
+		for (vk::ImageMemoryBarrier& barrier : batch.ImageBarriers)
+		{
+			barrier.srcAccessMask = {};
+			barrier.dstAccessMask = readAccess | vk::AccessFlagBits::eTransferWrite;
+		}
+
+		// Without an ownership transfer the memory barrier alone makes the copies visible to later graphics work
+		vk::MemoryBarrier memoryBarrier{vk::AccessFlagBits::eTransferWrite, readAccess | vk::AccessFlagBits::eTransferWrite};
+		graphicsCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eAllCommands,
+											  vk::DependencyFlags(), 1, &memoryBarrier, bufferBarrierCount,
+											  batch.BufferBarriers.data(), imageBarrierCount, batch.ImageBarriers.data());
+
+		for (const auto& finish : batch.FinishCallbacks)
+		{
+			finish(graphicsCommandBuffer);
+		}
+
+		auto vulkanGraphicsCommandBuffer = batch.GraphicsCommandBuffer.As<VulkanCommandBuffer>();
+		vulkanGraphicsCommandBuffer->End();
+		vulkanGraphicsCommandBuffer->AddWaitSemaphore(m_Semaphore.get(), vk::PipelineStageFlagBits::eAllCommands,
+													  batch.TransferValue);
+		vulkanGraphicsCommandBuffer->AddSignalSemaphore(m_Semaphore.get(), batch.ReadyValue);
+		vulkanGraphicsCommandBuffer->Submit();
+
+		m_FlushedValue.store(batch.ReadyValue, std::memory_order_release);
+
+		batch.BufferBarriers.clear();
+		batch.ImageBarriers.clear();
+		batch.FinishCallbacks.clear();
+		m_InFlightBatches.push_back(std::move(batch));
+		m_PendingBatch = Batch();
+	}
+
+	void VulkanUploadManager::WaitForOldestBatch()
+	{
+		// Everything in the ring belongs to the pending batch, it has to be submitted before it can finish
+		if (m_InFlightBatches.empty())
+		{
+			FlushPending();
+		}
+
+		NEO_PROFILE_SCOPE_CATEGORY("VulkanUploadManager::WaitForStagingSpace", "Wait");
+
+		vk::Semaphore semaphore = m_Semaphore.get();
+		vk::SemaphoreWaitInfo waitInfo{{}, 1, &semaphore, &m_InFlightBatches.front().ReadyValue};
+		VK_CHECK_RESULT(m_Device->GetHandle().waitSemaphores(waitInfo, UINT64_MAX));
+
+		ReclaimBatches();
+	}
+
+	void VulkanUploadManager::ReclaimBatches()
+	{
+		if (m_InFlightBatches.empty())
+		{
+			return;
+		}
+
+		const uint64 completedValue = m_Device->GetHandle().getSemaphoreCounterValue(m_Semaphore.get());
+		while (!m_InFlightBatches.empty() && m_InFlightBatches.front().ReadyValue <= completedValue)
+		{
+			Batch& batch = m_InFlightBatches.front();
+			m_RingTail = batch.RingEnd;
+			m_FreeTransferCommandBuffers.push_back(std::move(batch.TransferCommandBuffer));
+			m_FreeGraphicsCommandBuffers.push_back(std::move(batch.GraphicsCommandBuffer));
+			m_InFlightBatches.pop_front();
+		}
+	}
+} // namespace Neon
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Neon/Renderer/CommandBuffer.h"
+#include "Vulkan.h"
+#include "VulkanAllocator.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+namespace Neon
+{
+	// Streams resource data into device local memory on the transfer queue. Data is staged in a persistently mapped ring
+	// buffer and the copies are batched until the next flush, which hands the resources over to the graphics queue.
+	// Batches are tracked with a timeline semaphore, the CPU only waits on the GPU when the ring runs full.
+	class VulkanUploadManager
+	{
+	public:
+		VulkanUploadManager(const SharedRef<VulkanDevice>& device, uint32 stagingSize);
+		~VulkanUploadManager();
+
+		void UploadBuffer(vk::Buffer buffer, const void* data, uint32 size, uint32 offset = 0);
+		// Copies tightly packed layers into the first mip level, every level is left in transfer destination layout. Once the
+		// graphics queue owns the image, finish is recorded there to transition it to its final layout, e.g. by generating mips.
+		// The image is kept alive until the graphics queue is done with it.
+		void UploadImage(const SharedRef<VulkanImage>& image, uint32 width, uint32 height, uint32 layerCount, uint32 mipLevelCount, const void* data,
+						 uint32 size, std::function<void(vk::CommandBuffer)> finish);
+
+		// Submits the pending uploads, graphics work submitted afterwards sees their results. Safe to call from any thread.
+		void Flush();
+
+		// Work on other queues has to wait for the flushed value before using uploaded resources
+		vk::Semaphore GetSemaphore() const
+		{
+			return m_Semaphore.get();
+		}
+		uint64 GetFlushedValue() const
+		{
+			return m_FlushedValue.load(std::memory_order_acquire);
+		}
+
+	private:
+		struct Batch
+		{
+			SharedRef<CommandBuffer> TransferCommandBuffer;
+			SharedRef<CommandBuffer> GraphicsCommandBuffer;
+
+			// Queue family ownership transfers, recorded as release on the transfer and as acquire on the graphics queue
+			std::vector<vk::BufferMemoryBarrier> BufferBarriers;
+			std::vector<vk::ImageMemoryBarrier> ImageBarriers;
+			std::vector<std::function<void(vk::CommandBuffer)>> FinishCallbacks;
+			std::vector<SharedRef<VulkanImage>> Images;
+
+			// Uploads larger than the ring get their own staging buffer
+			std::vector<VulkanBuffer> StagingBuffers;
+
+			uint64 RingEnd = 0;
+			// Signaled once the copies finished and once the graphics queue took the resources over
+			uint64 TransferValue = 0;
+			uint64 ReadyValue = 0;
+		};
+
+		std::pair<vk::Buffer, uint64> Stage(const void* data, uint32 size);
+		vk::CommandBuffer GetTransferCommandBuffer();
+
+		void FlushPending();
+		void WaitForOldestBatch();
+		void ReclaimBatches();
+
+	private:
+		SharedRef<VulkanDevice> m_Device;
+		VulkanAllocator m_Allocator;
+
+		uint32 m_TransferQueueFamily = 0;
+		uint32 m_GraphicsQueueFamily = 0;
+
+		SharedRef<CommandPool> m_TransferCommandPool;
+		SharedRef<CommandPool> m_GraphicsCommandPool;
+		std::vector<SharedRef<CommandBuffer>> m_FreeTransferCommandBuffers;
+		std::vector<SharedRef<CommandBuffer>> m_FreeGraphicsCommandBuffers;
+
+		vk::UniqueSemaphore m_Semaphore;
+		uint64 m_SemaphoreValue = 0;
+		std::atomic<uint64> m_FlushedValue = 0;
+
+		// Ring offsets grow monotonically and wrap when indexing into the buffer
+		VulkanBuffer m_Ring;
+		byte* m_RingData = nullptr;
+		uint64 m_RingSize = 0;
+		uint64 m_RingHead = 0;
+		uint64 m_RingTail = 0;
+		uint64 m_Alignment = 0;
+
+		std::mutex m_Mutex;
+		Batch m_PendingBatch;
+		std::deque<Batch> m_InFlightBatches;
+	};
+} // namespace Neon
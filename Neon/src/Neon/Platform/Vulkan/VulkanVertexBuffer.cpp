@@ -8,13 +8,19 @@ namespace Neon
 	VulkanVertexBuffer::VulkanVertexBuffer(const void* data, uint32 size, const VertexBufferLayout& layout)
 		: VertexBuffer(size, layout)
 	{
-		// TODO: Create device local buffer
 		const auto& device = VulkanContext::GetDevice();
 
 		VulkanAllocator allocator(device, "VertexBuffer");
 
-		allocator.AllocateBuffer(m_Buffer, size, vk::BufferUsageFlagBits::eVertexBuffer,
-								 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-		allocator.UpdateBuffer(m_Buffer, data);
+		allocator.AllocateBuffer(m_Buffer, size, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst,
+								 vk::MemoryPropertyFlagBits::eDeviceLocal);
+		VulkanContext::GetUploadManager().UploadBuffer(m_Buffer.Handle.get(), data, size);
+
+		VulkanAllocator::RegisterBufferOwner(this);
+	}
+
+	VulkanVertexBuffer::~VulkanVertexBuffer()
+	{
+		VulkanAllocator::UnregisterBufferOwner(this);
 	}
 } // namespace Neon
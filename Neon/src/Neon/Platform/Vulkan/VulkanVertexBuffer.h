@@ -6,17 +6,26 @@
 
 namespace Neon
 {
-	class VulkanVertexBuffer : public VertexBuffer
+	class VulkanVertexBuffer : public VertexBuffer, public VulkanBufferOwner
 	{
 	public:
 		VulkanVertexBuffer(const void* data, uint32 size, const VertexBufferLayout& layout);
-		~VulkanVertexBuffer() = default;
+		~VulkanVertexBuffer();
 
 		void* GetHandle() const override
 		{
 			return m_Buffer.Handle.get();
 		}
 
+		void GetMovableBuffers(std::vector<VulkanBuffer*>& outBuffers) override
+		{
+			outBuffers.push_back(&m_Buffer);
+		}
+		// Handle is fetched whenever the buffer is bound, nothing keeps the old one
+		void OnBuffersMoved() override
+		{
+		}
+
 	private:
 		VulkanBuffer m_Buffer;
 	};
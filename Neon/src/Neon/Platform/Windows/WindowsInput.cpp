@@ -11,6 +11,10 @@ namespace Neon
 	bool Input::IsKeyPressed(int key)
 	{
 		auto window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetHandle());
+		if (!window)
+		{
+			return false;
+		}
 		auto state = glfwGetKey(window, static_cast<int32_t>(key));
 		return state == GLFW_PRESS || state == GLFW_REPEAT;
 	}
@@ -18,6 +22,10 @@ namespace Neon
 	bool Input::IsMouseButtonPressed(int button)
 	{
 		auto window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetHandle());
+		if (!window)
+		{
+			return false;
+		}
 		auto state = glfwGetMouseButton(window, static_cast<int32_t>(button));
 		return state == GLFW_PRESS;
 	}
@@ -25,6 +33,10 @@ namespace Neon
 	glm::vec2 Input::GetMousePosition()
 	{
 		auto window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetHandle());
+		if (!window)
+		{
+			return {0.f, 0.f};
+		}
 		double xpos, ypos;
 		glfwGetCursorPos(window, &xpos, &ypos);
 		return {(float)xpos, (float)ypos};
@@ -43,13 +55,19 @@ namespace Neon
 	void Input::EnableCursor()
 	{
 		auto window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetHandle());
-		glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+		if (window)
+		{
+			glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+		}
 	}
 
 	void Input::DisableCursor()
 	{
 		auto window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetHandle());
-		glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+		if (window)
+		{
+			glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+		}
 	}
 } // namespace Neon
 #endif
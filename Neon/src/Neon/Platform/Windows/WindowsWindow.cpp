@@ -2,6 +2,7 @@
 
 #include "Neon/Core/Event/KeyEvent.h"
 #include "Neon/Core/Event/MouseEvent.h"
+#include "Neon/Platform/Headless/HeadlessWindow.h"
 #include "Neon/Renderer/RendererAPI.h"
 #include "WindowsWindow.h"
 
@@ -18,6 +19,10 @@ namespace Neon
 
 	Window* Window::Create(const WindowProps& props)
 	{
+		if (props.Headless)
+		{
+			return new HeadlessWindow(props);
+		}
 		return new WindowsWindow(props);
 	}
 
@@ -7,21 +7,22 @@
 namespace Neon
 {
 
-	SharedRef<CommandBuffer> CommandBuffer::Create(const SharedRef<CommandPool>& commandPool)
+	SharedRef<CommandBuffer> CommandBuffer::Create(const SharedRef<CommandPool>& commandPool, bool secondary /*= false*/)
 	{
 		switch (RendererAPI::Current())
 		{
 			case RendererAPI::API::None:
 				return nullptr;
 			case RendererAPI::API::Vulkan:
-				return SharedRef<VulkanCommandBuffer>::Create(commandPool);
+				return SharedRef<VulkanCommandBuffer>::Create(commandPool, secondary);
 		}
 		NEO_CORE_ASSERT(false, "Unknown RendererAPI!");
 		return nullptr;
 	}
 
-	CommandBuffer::CommandBuffer(const SharedRef<CommandPool>& commandPool)
+	CommandBuffer::CommandBuffer(const SharedRef<CommandPool>& commandPool, bool secondary)
 		: m_Pool(commandPool)
+		, m_Secondary(secondary)
 	{
 	}
 
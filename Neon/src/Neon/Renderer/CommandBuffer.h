@@ -71,35 +71,106 @@ namespace Neon
 		SharedRef<StaleResourceBase> m_StaleResource;
 	};
 
+	// Same layout as VkDrawIndexedIndirectCommand
+	struct DrawIndexedIndirectCommand
+	{
+		uint32 IndexCount = 0;
+		uint32 InstanceCount = 1;
+		uint32 FirstIndex = 0;
+		int32 VertexOffset = 0;
+		uint32 FirstInstance = 0;
+	};
+
+	// Recorded since the last Begin, skipped binds were redundant with the state already bound
+	struct CommandBufferStats
+	{
+		uint32 DrawCalls = 0;
+		uint32 Instances = 0;
+		uint32 PipelineBinds = 0;
+		uint32 DescriptorSetBinds = 0;
+		uint32 VertexBufferBinds = 0;
+		uint32 IndexBufferBinds = 0;
+		uint32 SkippedBinds = 0;
+		// Draws and dispatches whose data did not fit into the per frame budget, see RendererContext::c_MaxDrawsPerFrame
+		uint32 DroppedDraws = 0;
+
+		void Add(const CommandBufferStats& other)
+		{
+			DrawCalls += other.DrawCalls;
+			Instances += other.Instances;
+			PipelineBinds += other.PipelineBinds;
+			DescriptorSetBinds += other.DescriptorSetBinds;
+			VertexBufferBinds += other.VertexBufferBinds;
+			IndexBufferBinds += other.IndexBufferBinds;
+			SkippedBinds += other.SkippedBinds;
+			DroppedDraws += other.DroppedDraws;
+		}
+	};
+
 	class CommandBuffer : public RefCounted
 	{
 	public:
-		static SharedRef<CommandBuffer> Create(const SharedRef<CommandPool>& commandPool);
+		static SharedRef<CommandBuffer> Create(const SharedRef<CommandPool>& commandPool, bool secondary = false);
 
 	public:
-		CommandBuffer(const SharedRef<CommandPool>& commandPool);
+		CommandBuffer(const SharedRef<CommandPool>& commandPool, bool secondary);
 		virtual ~CommandBuffer() = default;
 
 		virtual void Begin() const = 0;
+		// Secondary command buffers are recorded inside a render pass which a primary one began
+		virtual void BeginSecondary(const SharedRef<RenderPass>& renderPass) const = 0;
 		virtual void End() const = 0;
 		virtual void Submit() = 0;
 
-		virtual void BeginRenderPass(const SharedRef<RenderPass>& renderPass) const = 0;
+		// Render passes with secondary contents only take ExecuteCommands until they end
+		virtual void BeginRenderPass(const SharedRef<RenderPass>& renderPass, bool secondaryContents = false) const = 0;
 		virtual void EndRenderPass() const = 0;
+		// Runs recorded secondary command buffers, their stats are added to the ones of this command buffer
+		virtual void ExecuteCommands(const SharedRef<CommandBuffer>* commandBuffers, uint32 count) const = 0;
 		virtual void BindVertexBuffer(const SharedRef<VertexBuffer>& vertexBuffer) const = 0;
 		virtual void BindIndexBuffer(const SharedRef<IndexBuffer>& indexBuffer) const = 0;
+		// Copies per instance vertex data into transient frame memory and binds it for the following draws
+		virtual void BindInstanceData(const void* data, uint32 size) const = 0;
 		virtual void BindPipeline(const SharedRef<Pipeline>& pipeline) const = 0;
 		virtual void DrawIndexed(uint32 indexCount, uint32 instanceCount, uint32 firstIndex, int32 vertexOffset,
 								 uint32 firstInstance) const = 0;
+		// Copies the commands into transient frame memory for the following indirect draws. They are kept referenced for
+		// stats and have to stay alive until the last indirect draw was recorded.
+		virtual void SetIndirectCommands(const DrawIndexedIndirectCommand* commands, uint32 count) const = 0;
+		// Draws drawCount commands starting at firstCommand, with a single multi draw where the device supports it
+		virtual void DrawIndexedIndirect(uint32 firstCommand, uint32 drawCount) const = 0;
+		// Binds per instance vertex data from a storage buffer of the given shader, e.g. one filled by a compute pass
+		virtual void BindInstanceBuffer(const SharedRef<Shader>& shader, const ShaderParamHandle& storageBuffer,
+										uint32 offset) const = 0;
+		// Draws commands from a storage buffer with the draw count read from another one on the GPU. Devices without
+		// support draw all maxDrawCount commands, the unused ones are expected to have no instances.
+		virtual void DrawIndexedIndirectCount(const SharedRef<Shader>& shader, const ShaderParamHandle& commandsBuffer,
+											  uint32 commandsOffset, const ShaderParamHandle& countBuffer, uint32 countOffset,
+											  uint32 maxDrawCount) const = 0;
 		virtual void Dispatch(uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ) const = 0;
+		// Makes compute shader writes visible to indirect draws, vertex input and host reads recorded afterwards
+		virtual void ComputeToDrawBarrier() const = 0;
+		// Orders shader work submitted or recorded before against shader and transfer work afterwards, making compute
+		// shader writes visible to it
+		virtual void ComputeBarrier() const = 0;
 
 		CommandBufferType GetType() const
 		{
 			return m_Pool->GetType();
 		}
 
+		bool IsSecondary() const
+		{
+			return m_Secondary;
+		}
+
 		virtual void* GetHandle() const = 0;
 
+		const CommandBufferStats& GetStats() const
+		{
+			return m_Stats;
+		}
+
 		void SafeDestroyResource(const StaleResourceWrapper& staleResourceWrapper)
 		{
 			m_ReleaseQueue.push_back(staleResourceWrapper);
@@ -112,7 +183,10 @@ namespace Neon
 
 	protected:
 		SharedRef<CommandPool> m_Pool;
+		bool m_Secondary;
 
 		std::vector<StaleResourceWrapper> m_ReleaseQueue;
+
+		mutable CommandBufferStats m_Stats;
 	};
 } // namespace Neon
@@ -0,0 +1,26 @@
+#include "neopch.h"
+
+#include "ComputeBatch.h"
+#include "Neon/Platform/Vulkan/VulkanComputeBatch.h"
+#include "Neon/Renderer/RendererAPI.h"
+
+namespace Neon
+{
+	SharedRef<ComputeBatch> ComputeBatch::Create(bool asyncCompute /*= false*/)
+	{
+		switch (RendererAPI::Current())
+		{
+			case RendererAPI::API::None:
+				return nullptr;
+			case RendererAPI::API::Vulkan:
+				return SharedRef<VulkanComputeBatch>::Create(asyncCompute);
+		}
+		NEO_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+	ComputeBatch::ComputeBatch(bool asyncCompute)
+		: m_AsyncCompute(asyncCompute)
+	{
+	}
+} // namespace Neon
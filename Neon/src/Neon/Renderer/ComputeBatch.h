@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Neon/Renderer/Pipeline.h"
+#include "Neon/Renderer/RendererContext.h"
+
+namespace Neon
+{
+	// Records compute dispatches into one command buffer with barriers between them and submits it at once, without waiting
+	// on the GPU. Async batches run on the compute queue alongside graphics work, others are ordered with the graphics
+	// work submitted around them. A batch is recorded and submitted by one thread at a time.
+	class ComputeBatch : public RefCounted
+	{
+	public:
+		static SharedRef<ComputeBatch> Create(bool asyncCompute = false);
+
+	public:
+		ComputeBatch(bool asyncCompute);
+		virtual ~ComputeBatch() = default;
+
+		// Dispatches see the writes of the ones before them. Descriptors of a shader can not change while the batch uses
+		// it, so changing them splits the batch and waits for the part using the shader.
+		virtual void Dispatch(const SharedRef<ComputePipeline>& computePipeline, uint32 groupCountX, uint32 groupCountY,
+							  uint32 groupCountZ) = 0;
+		// Submits the dispatches recorded so far, the batch can be recorded again right away
+		virtual SubmissionToken Submit() = 0;
+
+		bool IsAsync() const
+		{
+			return m_AsyncCompute;
+		}
+
+	protected:
+		bool m_AsyncCompute;
+	};
+} // namespace Neon
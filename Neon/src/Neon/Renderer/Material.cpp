@@ -4,6 +4,8 @@
 
 namespace Neon
 {
+	static const ShaderParamHandle s_MaterialUBOParam("MaterialUBO");
+
 	Material::Material(uint32 materialIndex, const SharedRef<Shader>& shader)
 		: m_MaterialIndex(materialIndex), m_Shader(shader)
 	{
@@ -12,7 +14,7 @@ namespace Neon
 	void Material::SetProperties(const MaterialProperties& properties)
 	{
 		m_Properties = properties;
-		m_Shader->SetUniformBuffer("MaterialUBO", m_MaterialIndex, &properties);
+		m_Shader->SetUniformBuffer(s_MaterialUBOParam, m_MaterialIndex, &properties);
 	}
 
 	MaterialProperties& Material::GetProperties()
@@ -20,12 +22,17 @@ namespace Neon
 		return m_Properties;
 	}
 
-	void Material::SetTexture2D(const std::string& name, const SharedRef<Texture2D>& texture2D, uint32 mipLevel)
+	const MaterialProperties& Material::GetProperties() const
+	{
+		return m_Properties;
+	}
+
+	void Material::SetTexture2D(const ShaderParamHandle& name, const SharedRef<Texture2D>& texture2D, uint32 mipLevel)
 	{
 		m_Shader->SetTexture2D(name, m_MaterialIndex, texture2D, mipLevel);
 	}
 
-	void Material::SetTextureCube(const std::string& name, const SharedRef<TextureCube>& textureCube, uint32 mipLevel)
+	void Material::SetTextureCube(const ShaderParamHandle& name, const SharedRef<TextureCube>& textureCube, uint32 mipLevel)
 	{
 		m_Shader->SetTextureCube(name, m_MaterialIndex, textureCube, mipLevel);
 	}
@@ -61,12 +68,12 @@ namespace Neon
 		SetTextureCube(name, textureCube, mipLevel);
 	}
 
-	SharedRef<Texture2D> Material::GetTexture2D(const std::string& name) const
+	SharedRef<Texture2D> Material::GetTexture2D(const ShaderParamHandle& name) const
 	{
 		return m_Shader->GetTexture2D(name, m_MaterialIndex);
 	}
 
-	SharedRef<TextureCube> Material::GetTextureCube(const std::string& name) const
+	SharedRef<TextureCube> Material::GetTextureCube(const ShaderParamHandle& name) const
 	{
 		return m_Shader->GetTextureCube(name, m_MaterialIndex);
 	}
@@ -33,9 +33,10 @@ namespace Neon
 
 		void SetProperties(const MaterialProperties& properties);
 		MaterialProperties& GetProperties();
+		const MaterialProperties& GetProperties() const;
 
-		void SetTexture2D(const std::string& name, const SharedRef<Texture2D>& texture2D, uint32 mipLevel);
-		void SetTextureCube(const std::string& name, const SharedRef<TextureCube>& textureCube, uint32 mipLevel);
+		void SetTexture2D(const ShaderParamHandle& name, const SharedRef<Texture2D>& texture2D, uint32 mipLevel);
+		void SetTextureCube(const ShaderParamHandle& name, const SharedRef<TextureCube>& textureCube, uint32 mipLevel);
 		void LoadTexture2D(const std::string& name, const std::string& path, const TextureSpecification& textureSpecification,
 						   uint32 mipLevel);
 		void LoadDefaultTexture2D(const std::string& name, uint32 mipLevel);
@@ -44,8 +45,8 @@ namespace Neon
 		void LoadTextureCube(const std::string& name, const std::array<std::string, 6>& paths,
 							 const TextureSpecification& textureSpecification, uint32 mipLevel);
 
-		SharedRef<Texture2D> GetTexture2D(const std::string& name) const;
-		SharedRef<TextureCube> GetTextureCube(const std::string& name) const;
+		SharedRef<Texture2D> GetTexture2D(const ShaderParamHandle& name) const;
+		SharedRef<TextureCube> GetTextureCube(const ShaderParamHandle& name) const;
 
 	private:
 		uint32 m_MaterialIndex{};
@@ -1,5 +1,6 @@
 #include "neopch.h"
 
+#include "Neon/Core/Profiler.h"
 #include "Mesh.h"
 #include "Neon/Renderer/Renderer.h"
 #include "Neon/Renderer/SceneRenderer.h"
@@ -83,11 +84,15 @@ namespace Neon
 		submesh.MaterialIndex = 0;
 		submesh.IndexCount = static_cast<uint32>(indices.size()) * 3;
 		submesh.MeshName = name;
+
+		BuildDrawCommands();
 	}
 
 	Mesh::Mesh(const std::string& filename)
 		: m_FilePath(filename)
 	{
+		NEO_PROFILE_SCOPE_CATEGORY("Mesh::Load", "Loading");
+
 		LogStream::Initialize();
 
 		NEO_CORE_INFO("Loading mesh: {0}", filename.c_str());
@@ -123,6 +128,23 @@ namespace Neon
 			vertexCount += mesh->mNumVertices;
 			indexCount += submesh.IndexCount;
 
+			// Bounds
+			for (uint32 i = 0; i < mesh->mNumVertices; i++)
+			{
+				submesh.Bounds.Expand({mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z});
+			}
+			if (submesh.Bounds.IsValid())
+			{
+				glm::vec3 center = submesh.Bounds.GetCenter();
+				float radiusSquared = 0.f;
+				for (uint32 i = 0; i < mesh->mNumVertices; i++)
+				{
+					glm::vec3 offset = glm::vec3{mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z} - center;
+					radiusSquared = glm::max(radiusSquared, glm::dot(offset, offset));
+				}
+				submesh.BoundingSphere = glm::vec4(center, glm::sqrt(radiusSquared));
+			}
+
 			// Indices
 			for (uint32 i = 0; i < mesh->mNumFaces; i++)
 			{
@@ -133,6 +155,8 @@ namespace Neon
 		}
 
 		TraverseNodes(m_Scene->mRootNode);
+		BuildDrawCommands();
+		UpdateBounds();
 
 		m_IndexBuffer = IndexBuffer::Create(m_Indices.data(), static_cast<uint32>(m_Indices.size()) * sizeof(Index));
 	}
@@ -147,6 +171,74 @@ namespace Neon
 		m_WireframeMeshGraphicsPipeline = GraphicsPipeline::Create(m_WireframeMeshShader, pipelineSpec);
 	}
 
+	Mesh::Mesh(const SharedRef<Mesh>& source)
+		: m_Submeshes(source->m_Submeshes)
+		, m_DrawCommands(source->m_DrawCommands)
+		, m_BoundingSphere(source->m_BoundingSphere)
+		, m_BoundingBox(source->m_BoundingBox)
+		, m_InverseTransform(source->m_InverseTransform)
+		, m_VertexBuffer(source->m_VertexBuffer)
+		, m_IndexBuffer(source->m_IndexBuffer)
+		, m_MeshShader(source->m_MeshShader)
+		, m_WireframeMeshShader(source->m_WireframeMeshShader)
+		, m_MeshGraphicsPipeline(source->m_MeshGraphicsPipeline)
+		, m_WireframeMeshGraphicsPipeline(source->m_WireframeMeshGraphicsPipeline)
+		, m_Materials(source->m_Materials)
+		, m_SharedMaterials(true)
+		, m_FilePath(source->m_FilePath)
+	{
+	}
+
+	void Mesh::BuildDrawCommands()
+	{
+		m_DrawCommands.clear();
+		m_DrawCommands.reserve(m_Submeshes.size());
+		for (const Submesh& submesh : m_Submeshes)
+		{
+			DrawIndexedIndirectCommand& command = m_DrawCommands.emplace_back();
+			command.IndexCount = submesh.IndexCount;
+			command.FirstIndex = submesh.BaseIndex;
+			command.VertexOffset = static_cast<int32>(submesh.BaseVertex);
+		}
+	}
+
+	void Mesh::UpdateBounds()
+	{
+		m_BoundingBox = BoundingBox();
+		for (const Submesh& submesh : m_Submeshes)
+		{
+			m_BoundingBox.Expand(submesh.Bounds);
+		}
+
+		if (!m_BoundingBox.IsValid())
+		{
+			m_BoundingSphere = glm::vec4(0.f);
+			return;
+		}
+
+		glm::vec3 center = m_BoundingBox.GetCenter();
+		float radius = 0.f;
+		for (const Submesh& submesh : m_Submeshes)
+		{
+			if (!submesh.Bounds.IsValid())
+			{
+				continue;
+			}
+			radius = glm::max(radius, glm::distance(center, glm::vec3(submesh.BoundingSphere)) + submesh.BoundingSphere.w);
+		}
+		m_BoundingSphere = glm::vec4(center, radius);
+	}
+
+	void Mesh::TransformBounds(const glm::mat4& transform)
+	{
+		for (Submesh& submesh : m_Submeshes)
+		{
+			submesh.Bounds = submesh.Bounds.Transform(transform);
+			submesh.BoundingSphere = TransformBoundingSphere(submesh.BoundingSphere, transform);
+		}
+		UpdateBounds();
+	}
+
 	void Mesh::TraverseNodes(aiNode* node, const glm::mat4& parentTransform /*= glm::mat4(1.0f)*/, uint32 level /*= 0*/)
 	{
 		glm::mat4 transform = parentTransform * Mat4FromAssimpMat4(node->mTransformation);
@@ -164,6 +256,30 @@ namespace Neon
 		}
 	}
 
+	void Mesh::DetachMaterials()
+	{
+		static const std::array<ShaderParamHandle, 4> s_MaterialTextureParams = {
+			ShaderParamHandle("u_AlbedoTextures"), ShaderParamHandle("u_NormalTextures"), ShaderParamHandle("u_RoughnessTextures"),
+			ShaderParamHandle("u_MetalnessTextures")};
+
+		// Materials live in the descriptor set of the mesh shader, so owning them takes a shader and pipeline of our own
+		m_MeshShader = Shader::Create(m_MeshShader->GetShaderSpecification());
+		m_MeshGraphicsPipeline = GraphicsPipeline::Create(m_MeshShader, m_MeshGraphicsPipeline->GetSpecification());
+
+		for (uint32 i = 0; i < m_Materials.size(); i++)
+		{
+			Material material(i, m_MeshShader);
+			for (const ShaderParamHandle& textureParam : s_MaterialTextureParams)
+			{
+				material.SetTexture2D(textureParam, m_Materials[i].GetTexture2D(textureParam), 0);
+			}
+			material.SetProperties(m_Materials[i].GetProperties());
+			m_Materials[i] = material;
+		}
+
+		m_SharedMaterials = false;
+	}
+
 	void Mesh::CreateShaderAndGraphicsPipeline(ShaderSpecification& shaderSpecification, ShaderSpecification& wireframeShaderSpecification)
 	{
 		m_MeshShader = Shader::Create(shaderSpecification);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Neon/Math/Bounds.h"
+#include "Neon/Renderer/CommandBuffer.h"
 #include "Neon/Renderer/IndexBuffer.h"
 #include "Neon/Renderer/Material.h"
 #include "Neon/Renderer/Pipeline.h"
@@ -43,6 +45,10 @@ namespace Neon
 
 		glm::mat4 Transform;
 
+		// Object space, filled in at import
+		BoundingBox Bounds;
+		glm::vec4 BoundingSphere = glm::vec4(0.f);
+
 		std::string NodeName;
 		std::string MeshName;
 	};
@@ -53,6 +59,8 @@ namespace Neon
 		Mesh(const std::string& name, const std::vector<Index>& indices);
 		Mesh(const std::string& filename);
 		Mesh(ShaderSpecification& shaderSpec, GraphicsPipelineSpecification& pipelineSpec);
+		// Shares the geometry, shaders and materials of source until the materials are first modified
+		Mesh(const SharedRef<Mesh>& source);
 		virtual ~Mesh() = default;
 
 		const SharedRef<GraphicsPipeline>& GetGraphicsPipeline() const
@@ -73,6 +81,12 @@ namespace Neon
 			return m_WireframeMeshShader;
 		}
 
+		// Instanced shaders take the model matrix as a per instance attribute instead of from the ModelPC push constant
+		bool SupportsInstancing() const
+		{
+			return m_MeshShader && m_MeshShader->GetInstanceLayout().GetElementCount() > 0;
+		}
+
 		const SharedRef<VertexBuffer>& GetVertexBuffer() const
 		{
 			return m_VertexBuffer;
@@ -86,9 +100,33 @@ namespace Neon
 		{
 			return m_Submeshes;
 		}
+		// One single instance command per submesh
+		const std::vector<DrawIndexedIndirectCommand>& GetDrawCommands() const
+		{
+			return m_DrawCommands;
+		}
+
+		// Object space, center in xyz and radius in w. Meshes without bounds have a radius of 0 and are never culled.
+		const glm::vec4& GetBoundingSphere() const
+		{
+			return m_BoundingSphere;
+		}
+		const BoundingBox& GetBoundingBox() const
+		{
+			return m_BoundingBox;
+		}
+		bool HasBounds() const
+		{
+			return m_BoundingSphere.w > 0.f;
+		}
 
+		// Meshes sharing their materials get their own copy before it is handed out for modification
 		std::vector<Material>& GetMaterials()
 		{
+			if (m_SharedMaterials)
+			{
+				DetachMaterials();
+			}
 			return m_Materials;
 		}
 		const std::vector<Material>& GetMaterials() const
@@ -102,13 +140,21 @@ namespace Neon
 		}
 
 	protected:
+		void BuildDrawCommands();
+		// Mesh bounds enclose the bounds of every submesh
+		void UpdateBounds();
+		void TransformBounds(const glm::mat4& transform);
 		void TraverseNodes(aiNode* node, const glm::mat4& parentTransform = glm::mat4(1.0f), uint32 level = 0);
 		void CreateShaderAndGraphicsPipeline(ShaderSpecification& shaderSpecification,
 											 ShaderSpecification& wireframeShaderSpecification);
+		void DetachMaterials();
 
 	protected:
 		const aiScene* m_Scene = nullptr;
 		std::vector<Submesh> m_Submeshes;
+		std::vector<DrawIndexedIndirectCommand> m_DrawCommands;
+		glm::vec4 m_BoundingSphere = glm::vec4(0.f);
+		BoundingBox m_BoundingBox;
 
 		UniqueRef<Assimp::Importer> m_Importer;
 
@@ -125,6 +171,7 @@ namespace Neon
 		SharedRef<GraphicsPipeline> m_WireframeMeshGraphicsPipeline;
 
 		std::vector<Material> m_Materials;
+		bool m_SharedMaterials = false;
 
 		std::string m_FilePath = std::string();
 
@@ -56,6 +56,7 @@ namespace Neon
 
 		Submesh& submesh = mesh->m_Submeshes.emplace_back();
 		submesh.IndexCount = static_cast<uint32>(indices.size());
+		mesh->BuildDrawCommands();
 
 		return mesh;
 	}
@@ -37,6 +37,7 @@ namespace Neon
 
 	struct RenderPassSpecification
 	{
+		std::string DebugName;
 		glm::vec4 ClearColor = {1.f, 1.f, 1.f, 1.f};
 
 		std::vector<AttachmentSpecification> Attachments;
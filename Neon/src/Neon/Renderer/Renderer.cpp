@@ -10,10 +10,16 @@ namespace Neon
 	static SharedRef<VertexBuffer> s_QuadVertexBuffer;
 	static SharedRef<IndexBuffer> s_QuadIndexBuffer;
 
+	// Storage buffers of the culling shader read by every GPU culled draw
+	static const ShaderParamHandle s_VisibleTransformsParam("VisibleTransforms");
+	static const ShaderParamHandle s_DrawCommandsParam("DrawCommands");
+	static const ShaderParamHandle s_DrawCountsParam("DrawCounts");
+
 	static const std::vector<glm::vec2> m_QuadVertices = {{-1.f, -1.f}, {1.f, -1.f}, {-1.f, 1.f}, {1.f, 1.f}};
 	static const std::vector<uint32> m_QuadIndices = {0, 2, 1, 1, 2, 3};
 
-	SharedRef<CommandBuffer> Renderer::s_SelectedCommandBuffer;
+	thread_local SharedRef<CommandBuffer> Renderer::s_SelectedCommandBuffer;
+	thread_local SharedRef<CommandBuffer> Renderer::s_PrimarySelectedCommandBuffer;
 
 	void Renderer::Init()
 	{
@@ -26,11 +32,40 @@ namespace Neon
 		SceneRenderer::Init();
 	}
 
-	void Renderer::BeginRenderPass(const SharedRef<RenderPass>& renderPass)
+	void Renderer::BeginRenderPass(const SharedRef<RenderPass>& renderPass, bool secondaryContents /*= false*/)
 	{
 		NEO_CORE_ASSERT(s_SelectedCommandBuffer);
 
-		s_SelectedCommandBuffer->BeginRenderPass(renderPass);
+		s_SelectedCommandBuffer->BeginRenderPass(renderPass, secondaryContents);
+	}
+
+	SharedRef<CommandBuffer> Renderer::BeginSecondaryCommandBuffer(const SharedRef<RenderPass>& renderPass)
+	{
+		NEO_CORE_ASSERT(!s_SelectedCommandBuffer || !s_SelectedCommandBuffer->IsSecondary(),
+						"Secondary command buffers can not be nested!");
+
+		SharedRef<CommandBuffer> commandBuffer = RendererContext::Get()->GetSecondaryRenderCommandBuffer();
+		commandBuffer->BeginSecondary(renderPass);
+		// The main thread runs job chunks too, its own selection has to survive them
+		s_PrimarySelectedCommandBuffer = s_SelectedCommandBuffer;
+		s_SelectedCommandBuffer = commandBuffer;
+		return commandBuffer;
+	}
+
+	void Renderer::EndSecondaryCommandBuffer()
+	{
+		NEO_CORE_ASSERT(s_SelectedCommandBuffer && s_SelectedCommandBuffer->IsSecondary());
+
+		s_SelectedCommandBuffer->End();
+		s_SelectedCommandBuffer = s_PrimarySelectedCommandBuffer;
+		s_PrimarySelectedCommandBuffer.Reset();
+	}
+
+	void Renderer::ExecuteCommandBuffers(const SharedRef<CommandBuffer>* commandBuffers, uint32 count)
+	{
+		NEO_CORE_ASSERT(s_SelectedCommandBuffer);
+
+		s_SelectedCommandBuffer->ExecuteCommands(commandBuffers, count);
 	}
 
 	void Renderer::SubmitMesh(const SharedRef<Mesh>& mesh, const glm::mat4& transform, bool wireframe)
@@ -44,6 +79,10 @@ namespace Neon
 		else
 		{
 			s_SelectedCommandBuffer->BindPipeline(mesh->GetGraphicsPipeline());
+			if (mesh->SupportsInstancing())
+			{
+				s_SelectedCommandBuffer->BindInstanceData(&transform, sizeof(glm::mat4));
+			}
 		}
 		
 		s_SelectedCommandBuffer->BindVertexBuffer(mesh->GetVertexBuffer());
@@ -56,6 +95,51 @@ namespace Neon
 		}
 	}
 
+	void Renderer::SetIndirectCommands(const DrawIndexedIndirectCommand* commands, uint32 count)
+	{
+		NEO_CORE_ASSERT(s_SelectedCommandBuffer);
+
+		s_SelectedCommandBuffer->SetIndirectCommands(commands, count);
+	}
+
+	void Renderer::SubmitMeshIndirect(const SharedRef<Mesh>& mesh, uint32 firstCommand, const glm::mat4* transforms,
+									  uint32 instanceCount, bool wireframe)
+	{
+		NEO_CORE_ASSERT(s_SelectedCommandBuffer);
+
+		if (s_DrawWireframe || wireframe)
+		{
+			s_SelectedCommandBuffer->BindPipeline(mesh->GetWireframeGraphicsPipeline());
+		}
+		else
+		{
+			s_SelectedCommandBuffer->BindPipeline(mesh->GetGraphicsPipeline());
+			if (mesh->SupportsInstancing())
+			{
+				s_SelectedCommandBuffer->BindInstanceData(transforms, instanceCount * sizeof(glm::mat4));
+			}
+		}
+
+		s_SelectedCommandBuffer->BindVertexBuffer(mesh->GetVertexBuffer());
+		s_SelectedCommandBuffer->BindIndexBuffer(mesh->GetIndexBuffer());
+		s_SelectedCommandBuffer->DrawIndexedIndirect(firstCommand, static_cast<uint32>(mesh->GetDrawCommands().size()));
+	}
+
+	void Renderer::SubmitMeshIndirectCount(const SharedRef<Mesh>& mesh, const SharedRef<Shader>& drawDataShader,
+										   uint32 firstInstance, uint32 firstCommand, uint32 countIndex)
+	{
+		NEO_CORE_ASSERT(s_SelectedCommandBuffer);
+		NEO_CORE_ASSERT(mesh->SupportsInstancing(), "Mesh has no per instance transforms!");
+
+		s_SelectedCommandBuffer->BindPipeline(mesh->GetGraphicsPipeline());
+		s_SelectedCommandBuffer->BindInstanceBuffer(drawDataShader, s_VisibleTransformsParam, firstInstance * sizeof(glm::mat4));
+		s_SelectedCommandBuffer->BindVertexBuffer(mesh->GetVertexBuffer());
+		s_SelectedCommandBuffer->BindIndexBuffer(mesh->GetIndexBuffer());
+		s_SelectedCommandBuffer->DrawIndexedIndirectCount(
+			drawDataShader, s_DrawCommandsParam, firstCommand * sizeof(DrawIndexedIndirectCommand), s_DrawCountsParam,
+			countIndex * sizeof(uint32), static_cast<uint32>(mesh->GetDrawCommands().size()));
+	}
+
 	void Renderer::SubmitFullscreenQuad(const SharedRef<GraphicsPipeline>& graphicsPipeline)
 	{
 		NEO_CORE_ASSERT(s_SelectedCommandBuffer);
@@ -75,6 +159,16 @@ namespace Neon
 		RendererContext::Get()->SubmitCommandBuffer(commandBuffer);
 	}
 
+	void Renderer::SubmitCompute(const SharedRef<ComputePipeline>& computePipeline, uint32 groupCountX, uint32 groupCountY,
+								 uint32 groupCountZ)
+	{
+		NEO_CORE_ASSERT(s_SelectedCommandBuffer);
+
+		s_SelectedCommandBuffer->BindPipeline(computePipeline);
+		s_SelectedCommandBuffer->Dispatch(groupCountX, groupCountY, groupCountZ);
+		s_SelectedCommandBuffer->ComputeToDrawBarrier();
+	}
+
 	void Renderer::EndRenderPass()
 	{
 		NEO_CORE_ASSERT(s_SelectedCommandBuffer);
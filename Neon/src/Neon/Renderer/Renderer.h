@@ -12,14 +12,36 @@ namespace Neon
 	public:
 		static void Init();
 
-		static void BeginRenderPass(const SharedRef<RenderPass>& renderPass);
+		// With secondary contents the pass is recorded by secondary command buffers, see ExecuteCommandBuffers
+		static void BeginRenderPass(const SharedRef<RenderPass>& renderPass, bool secondaryContents = false);
+
+		// Begins a secondary command buffer of the calling job thread inside the given render pass and selects it for the
+		// submissions of this thread until EndSecondaryCommandBuffer, which restores the previous selection
+		static SharedRef<CommandBuffer> BeginSecondaryCommandBuffer(const SharedRef<RenderPass>& renderPass);
+		static void EndSecondaryCommandBuffer();
+		// Runs ended secondary command buffers in order, from the thread which began the render pass
+		static void ExecuteCommandBuffers(const SharedRef<CommandBuffer>* commandBuffers, uint32 count);
 
 		static void SubmitMesh(const SharedRef<Mesh>& mesh, const glm::mat4& transform, bool wireframe);
+		// Indirect mesh submissions of the current render pass index into these commands
+		static void SetIndirectCommands(const DrawIndexedIndirectCommand* commands, uint32 count);
+		// Draws one command per submesh starting at firstCommand. Transforms are fed to instanced pipelines, others take
+		// the model matrix from their ModelPC push constant.
+		static void SubmitMeshIndirect(const SharedRef<Mesh>& mesh, uint32 firstCommand, const glm::mat4* transforms,
+									   uint32 instanceCount, bool wireframe);
+		// Draws an instanced mesh from data a compute shader wrote into its VisibleTransforms, DrawCommands and DrawCounts
+		// storage buffers. Offsets are in elements, see FrustumCull_Compute.glsl.
+		static void SubmitMeshIndirectCount(const SharedRef<Mesh>& mesh, const SharedRef<Shader>& drawDataShader,
+											uint32 firstInstance, uint32 firstCommand, uint32 countIndex);
 
 		static void SubmitFullscreenQuad(const SharedRef<GraphicsPipeline>& graphicsPipeline);
 
 		static void DispatchCompute(const SharedRef<ComputePipeline>& computePipeline, uint32 groupCountX, uint32 groupCountY,
 									uint32 groupCountZ);
+		// Records the dispatch into the selected command buffer, outside of a render pass. Its writes are visible to
+		// draws recorded afterwards.
+		static void SubmitCompute(const SharedRef<ComputePipeline>& computePipeline, uint32 groupCountX, uint32 groupCountY,
+								  uint32 groupCountZ);
 
 		static void EndRenderPass();
 
@@ -34,6 +56,7 @@ namespace Neon
 
 		static bool IsWireframeEnabled();
 
+		// Selection is per thread
 		static void SelectCommandBuffer(const SharedRef<CommandBuffer>& commandBuffer)
 		{
 			s_SelectedCommandBuffer = commandBuffer;
@@ -45,6 +68,8 @@ namespace Neon
 		}
 
 	private:
-		static SharedRef<CommandBuffer> s_SelectedCommandBuffer;
+		static thread_local SharedRef<CommandBuffer> s_SelectedCommandBuffer;
+		// Selection from before BeginSecondaryCommandBuffer
+		static thread_local SharedRef<CommandBuffer> s_PrimarySelectedCommandBuffer;
 	};
 } // namespace Neon
@@ -2,11 +2,58 @@
 
 #include "Neon/Core/Core.h"
 #include "Neon/Renderer/CommandBuffer.h"
+#include "Neon/Renderer/Shader.h"
 
 namespace Neon
 {
+	// GPU time spent in a render pass or compute dispatch, dispatches of the same shader are accumulated
+	struct GpuTiming
+	{
+		const char* Name = nullptr;
+		double Milliseconds = 0.0;
+		uint32 Count = 0;
+	};
+
+	struct GpuMemoryHeap
+	{
+		// Memory allocated from the heap, block bytes include unused space between sub-allocations
+		uint64 BlockBytes = 0;
+		uint64 AllocationBytes = 0;
+		// Usage by the whole process and what the driver can give it before performance suffers
+		uint64 Usage = 0;
+		uint64 Budget = 0;
+		bool DeviceLocal = false;
+	};
+
+	// Live GPU memory of the renderer, grouped by the tag of the allocating resource
+	struct GpuMemoryTag
+	{
+		std::string Name;
+		uint64 Bytes = 0;
+		uint32 AllocationCount = 0;
+	};
+
+	struct GpuMemoryStats
+	{
+		std::vector<GpuMemoryHeap> Heaps;
+		std::vector<GpuMemoryTag> Tags;
+	};
+
+	// Completion of a command buffer submitted without waiting, values grow per queue
+	struct SubmissionToken
+	{
+		CommandBufferType Type = CommandBufferType::Graphics;
+		uint64 Value = 0;
+	};
+
 	class RendererContext : public RefCounted
 	{
+	public:
+		// Per frame budget of transient draw data: instance transforms, indirect commands and per draw uniforms
+		static constexpr uint32 c_MaxInstancesPerFrame = 65536;
+		static constexpr uint32 c_MaxDrawsPerFrame = 8192;
+		static constexpr uint32 c_MaxUniformBytesPerDraw = 512;
+
 	public:
 		static SharedRef<RendererContext> Create(void* window);
 
@@ -22,13 +69,33 @@ namespace Neon
 		virtual void OnResize(uint32 width, uint32 height) = 0;
 
 		virtual uint32 GetTargetMaxFramesInFlight() const = 0;
+		// Slot of the frame being recorded, resources indexed by it are no longer in use by the GPU
+		virtual uint32 GetCurrentFrameIndex() const = 0;
 
 		virtual SharedRef<CommandBuffer>& GetPrimaryRenderCommandBuffer() = 0;
+		// Unused secondary graphics command buffer of the calling job thread, valid for the current frame. It may only be
+		// recorded on that thread and gets executed by the primary render command buffer.
+		virtual SharedRef<CommandBuffer> GetSecondaryRenderCommandBuffer() = 0;
+
+		// Data of the frame set shared by all shaders, e.g. CameraUBO and LightUBO. Written once per frame for all of its
+		// draws, a later write in the same frame replaces it for the draws recorded before as well.
+		virtual void SetFrameUniformBuffer(const ShaderParamHandle& name, const void* data, uint32 size) = 0;
 
 		virtual void WaitIdle() const = 0;
 
 		virtual SharedRef<CommandBuffer> GetCommandBuffer(CommandBufferType type, bool begin) const = 0;
 		virtual void SubmitCommandBuffer(SharedRef<CommandBuffer>& commandBuffer) const = 0;
+		// Submits without waiting on the GPU, the command buffer is kept alive until it finished. Compute queue submissions
+		// run alongside graphics work, frames submitted afterwards wait for them.
+		virtual SubmissionToken SubmitCommandBufferAsync(SharedRef<CommandBuffer>& commandBuffer) const = 0;
+		virtual bool IsSubmissionComplete(const SubmissionToken& token) const = 0;
+		virtual void WaitForSubmission(const SubmissionToken& token) const = 0;
+
+		// Timings of the most recently resolved frame, lagging a few frames behind the CPU
+		virtual std::vector<GpuTiming> GetGpuTimings() const = 0;
+		virtual GpuMemoryStats GetMemoryStats() const = 0;
+		// Compacts GPU memory by moving buffers, waits for the GPU to be idle. Has to be called between frames.
+		virtual void DefragmentMemory() const = 0;
 
 		void SafeDeleteResource(const StaleResourceWrapper& staleResourceWrapper);
 
@@ -1,14 +1,169 @@
 #include "neopch.h"
 
+#include "Neon/Core/JobSystem.h"
+#include "Neon/Core/Profiler.h"
+#include "Neon/Math/Frustum.h"
+#include "Neon/Renderer/ComputeBatch.h"
 #include "Neon/Renderer/Framebuffer.h"
 #include "Neon/Renderer/Renderer.h"
+#include "Neon/Renderer/RendererContext.h"
 #include "Neon/Renderer/SceneRenderer.h"
 #include "Neon/Scene/Components/LightComponent.h"
 
+#include <bitset>
+#include <cstring>
+
 namespace Neon
 {
 	SceneRenderer::SceneRendererData SceneRenderer::s_Data = {};
 
+	// Storage buffer and push constant layouts of FrustumCull_Compute.glsl
+	struct CullInstance
+	{
+		glm::mat4 Transform;
+		glm::vec4 BoundingSphere;
+		glm::uvec4 Group;
+	};
+
+	struct CullGroup
+	{
+		uint32 FirstInstance;
+		uint32 FirstCommand;
+		uint32 CommandCount;
+		uint32 Padding;
+	};
+
+	struct CullParams
+	{
+		glm::vec4 FrustumPlanes[6];
+		uint32 InstanceCount;
+	};
+
+	static constexpr uint32 c_MaxGpuCulledInstances = 16384;
+	static constexpr uint32 c_MaxGpuCulledCommands = 16384;
+	// Visible and tested instance counts come first in DrawCounts
+	static constexpr uint32 c_CullGroupCountsOffset = 4;
+	static constexpr uint32 c_CullWorkgroupSize = 64;
+
+	// Fewer draw groups per secondary command buffer cost more in setup than they save in recording
+	static constexpr uint32 c_MinDrawGroupsPerRecordingChunk = 64;
+
+	// Set every frame or per draw, interned once
+	static const ShaderParamHandle s_CameraUBOParam("CameraUBO");
+	static const ShaderParamHandle s_LightUBOParam("LightUBO");
+	static const ShaderParamHandle s_ModelPCParam("ModelPC");
+	static const ShaderParamHandle s_SkyboxUBOParam("SkyboxUBO");
+	static const ShaderParamHandle s_CullInstancesParam("CullInstances");
+	static const ShaderParamHandle s_CullGroupsParam("CullGroups");
+	static const ShaderParamHandle s_DrawCommandsParam("DrawCommands");
+	static const ShaderParamHandle s_DrawCountsParam("DrawCounts");
+	static const ShaderParamHandle s_PushConstantParam("u_PushConstant");
+
+	// Instanced draws with bounds are left to the culling pass when it is enabled
+	static bool IsGpuCullable(const Mesh* mesh, bool wireframe, CullingMode mode, bool instancingEnabled)
+	{
+		return mode == CullingMode::Gpu && !wireframe && instancingEnabled && mesh->SupportsInstancing() && mesh->HasBounds();
+	}
+
+	// World space boxes for Frustum::CullBoxes, the components are stored back to back in one allocation
+	struct BoxCullBatch
+	{
+		FrameVector<float> Data;
+		FrameVector<uint8> Visible;
+		uint32 Count;
+
+		explicit BoxCullBatch(uint32 count)
+			: Data(count * 6)
+			, Visible(count)
+			, Count(count)
+		{
+		}
+
+		void Set(uint32 index, const BoundingBox& box)
+		{
+			glm::vec3 center = box.GetCenter();
+			glm::vec3 extents = box.GetExtents();
+			Data[index] = center.x;
+			Data[Count + index] = center.y;
+			Data[Count * 2 + index] = center.z;
+			Data[Count * 3 + index] = extents.x;
+			Data[Count * 4 + index] = extents.y;
+			Data[Count * 5 + index] = extents.z;
+		}
+
+		void Cull(const Frustum& frustum)
+		{
+			const float* data = Data.data();
+			BoxArrays boxes = {data, data + Count, data + Count * 2, data + Count * 3, data + Count * 4, data + Count * 5};
+			frustum.CullBoxes(boxes, Count, Visible.data());
+		}
+	};
+
+	struct DrawSortEntry
+	{
+		uint64 Key;
+		uint32 Index;
+	};
+
+	// Folds a pointer into the top bits of a Fibonacci hash, equal pointers end up next to each other after sorting
+	static uint64 HashSortKeyPointer(const void* ptr, uint32 bits)
+	{
+		uint64 value = static_cast<uint64>(reinterpret_cast<uintptr_t>(ptr) >> 4) * 0x9E3779B97F4A7C15ull;
+		return value >> (64 - bits);
+	}
+
+	// From the most significant bits: pass (4), pipeline (16), material (12), geometry (16), depth (16)
+	static uint64 CreateDrawSortKey(const Mesh* mesh, const glm::mat4& transform, bool wireframe, const glm::vec3& cameraPosition)
+	{
+		const void* pipeline = wireframe ? mesh->GetWireframeGraphicsPipeline().Ptr() : mesh->GetGraphicsPipeline().Ptr();
+		const void* material = wireframe ? mesh->GetWireframeShader().Ptr() : mesh->GetShader().Ptr();
+
+		// Front to back, positive floats keep their order when compared as integers
+		float distance = glm::length(glm::vec3(transform[3]) - cameraPosition);
+		uint32 distanceBits;
+		std::memcpy(&distanceBits, &distance, sizeof(distanceBits));
+
+		uint64 pass = wireframe ? 1 : 0;
+		return (pass << 60) | (HashSortKeyPointer(pipeline, 16) << 44) | (HashSortKeyPointer(material, 12) << 32) |
+			   (HashSortKeyPointer(mesh->GetVertexBuffer().Ptr(), 16) << 16) | (distanceBits >> 16);
+	}
+
+	// LSD radix sort, one byte per pass. Passes where every key has the same digit are skipped.
+	static void RadixSortDrawEntries(FrameVector<DrawSortEntry>& entries)
+	{
+		if (entries.size() < 2)
+		{
+			return;
+		}
+
+		FrameVector<DrawSortEntry> scratch(entries.size());
+		for (uint32 shift = 0; shift < 64; shift += 8)
+		{
+			std::array<uint32, 256> offsets = {};
+			for (const DrawSortEntry& entry : entries)
+			{
+				offsets[(entry.Key >> shift) & 0xFF]++;
+			}
+			if (offsets[(entries[0].Key >> shift) & 0xFF] == entries.size())
+			{
+				continue;
+			}
+
+			uint32 offset = 0;
+			for (uint32& bucket : offsets)
+			{
+				uint32 count = bucket;
+				bucket = offset;
+				offset += count;
+			}
+			for (const DrawSortEntry& entry : entries)
+			{
+				scratch[offsets[(entry.Key >> shift) & 0xFF]++] = entry;
+			}
+			entries.swap(scratch);
+		}
+	}
+
 	void SceneRenderer::Init()
 	{
 		uint32 width = Application::Get().GetWindow().GetWidth();
@@ -16,6 +171,7 @@ namespace Neon
 
 		{
 			RenderPassSpecification geoRenderPassSpec;
+			geoRenderPassSpec.DebugName = "GeometryPass";
 			geoRenderPassSpec.ClearColor = {0.1f, 0.1f, 0.1f, 1.0f};
 			geoRenderPassSpec.Attachments.push_back(
 				{4, TextureFormat::RGBA16F, AttachmentLoadOp::Clear, AttachmentStoreOp::Store, false});
@@ -34,6 +190,7 @@ namespace Neon
 
 		{
 			RenderPassSpecification postProcessingPassSpec;
+			postProcessingPassSpec.DebugName = "PostProcessingPass";
 			postProcessingPassSpec.ClearColor = {0.1f, 0.1f, 0.1f, 1.0f};
 			postProcessingPassSpec.Attachments.push_back(
 				{1, TextureFormat::RGBA8, AttachmentLoadOp::Clear, AttachmentStoreOp::Store, true});
@@ -68,16 +225,6 @@ namespace Neon
 				ComputePipeline::Create(s_Data.EnvUnfilteredComputeShader, envUnfilteredPipelineSpecification);
 		}
 
-		{
-			ShaderSpecification envFilteredComputeShaderSpecification;
-			envFilteredComputeShaderSpecification.ShaderPaths[ShaderType::Compute] =
-				"assets/shaders/EnvironmentMipFilter_Compute.glsl";
-			s_Data.EnvFilteredComputeShader = Shader::Create(envFilteredComputeShaderSpecification);
-			ComputePipelineSpecification envFilteredComputePipelineSpecification;
-			s_Data.EnvFilteredComputePipeline =
-				ComputePipeline::Create(s_Data.EnvFilteredComputeShader, envFilteredComputePipelineSpecification);
-		}
-
 		{
 			ShaderSpecification irradianceComputeShaderSpecification;
 			irradianceComputeShaderSpecification.ShaderPaths[ShaderType::Compute] =
@@ -87,6 +234,26 @@ namespace Neon
 			s_Data.IrradianceComputePipeline =
 				ComputePipeline::Create(s_Data.IrradianceComputeShader, irradianceComputePipelineSpecification);
 		}
+
+		{
+			ShaderSpecification cullComputeShaderSpecification;
+			cullComputeShaderSpecification.ShaderPaths[ShaderType::Compute] = "assets/shaders/FrustumCull_Compute.glsl";
+			cullComputeShaderSpecification.ShaderVariableCounts["CullInstances"] = c_MaxGpuCulledInstances;
+			cullComputeShaderSpecification.ShaderVariableCounts["CullGroups"] = c_MaxGpuCulledInstances;
+			cullComputeShaderSpecification.ShaderVariableCounts["DrawCommands"] = c_MaxGpuCulledCommands;
+			cullComputeShaderSpecification.ShaderVariableCounts["DrawCounts"] = c_CullGroupCountsOffset + c_MaxGpuCulledInstances;
+			cullComputeShaderSpecification.ShaderVariableCounts["VisibleTransforms"] = c_MaxGpuCulledInstances;
+
+			const uint32 framesInFlight = RendererContext::Get()->GetTargetMaxFramesInFlight();
+			for (uint32 i = 0; i < framesInFlight; i++)
+			{
+				SharedRef<Shader> cullComputeShader = Shader::Create(cullComputeShaderSpecification);
+				ComputePipelineSpecification cullComputePipelineSpecification;
+				s_Data.CullComputePipelines.push_back(ComputePipeline::Create(cullComputeShader, cullComputePipelineSpecification));
+				s_Data.CullComputeShaders.push_back(cullComputeShader);
+			}
+			s_Data.CullResultsFrame.assign(framesInFlight, 0);
+		}
 	}
 
 	void SceneRenderer::InitializeScene(SharedRef<Scene> scene)
@@ -144,6 +311,7 @@ namespace Neon
 		NEO_CORE_ASSERT(s_Data.ActiveScene, "Scene not initialized!");
 
 		s_Data.SceneData.SceneCamera = camera;
+		ResetDrawList();
 	}
 
 	void SceneRenderer::EndScene()
@@ -151,13 +319,21 @@ namespace Neon
 		NEO_CORE_ASSERT(s_Data.ActiveScene, "");
 		NEO_CORE_ASSERT(s_Data.SceneData.SceneCamera);
 
+		CullDrawList();
+	}
+
+	void SceneRenderer::RenderScene()
+	{
+		NEO_CORE_ASSERT(s_Data.ActiveScene, "");
+		NEO_CORE_ASSERT(s_Data.SceneData.SceneCamera);
+
 		FlushDrawList();
 	}
 
-	void SceneRenderer::SubmitMesh(const SharedRef<Mesh>& mesh, const glm::mat4& transform /*= glm::mat4(1.0f)*/,
+	void SceneRenderer::SubmitMesh(SharedRef<Mesh> mesh, const glm::mat4& transform /*= glm::mat4(1.0f)*/,
 								   bool wireframe /*=false*/)
 	{
-		s_Data.MeshDrawList.push_back({mesh, transform, wireframe});
+		s_Data.MeshDrawList.push_back({std::move(mesh), transform, wireframe});
 	}
 
 	void SceneRenderer::SubmitLight(const Light& light)
@@ -190,6 +366,36 @@ namespace Neon
 		s_Data.FocusPoint = point;
 	}
 
+	void SceneRenderer::SetInstancingEnabled(bool enabled)
+	{
+		s_Data.InstancingEnabled = enabled;
+	}
+
+	void SceneRenderer::SetParallelRecordingEnabled(bool enabled)
+	{
+		s_Data.ParallelRecording = enabled;
+	}
+
+	bool SceneRenderer::IsParallelRecordingEnabled()
+	{
+		return s_Data.ParallelRecording;
+	}
+
+	void SceneRenderer::SetCullingMode(CullingMode mode)
+	{
+		s_Data.Culling = mode;
+	}
+
+	CullingMode SceneRenderer::GetCullingMode()
+	{
+		return s_Data.Culling;
+	}
+
+	const CullingStats& SceneRenderer::GetCullingStats()
+	{
+		return s_Data.LastCullingStats;
+	}
+
 	void* SceneRenderer::GetFinalImageId()
 	{
 		return s_Data.PostProcessingPass->GetTargetFramebuffer()->GetSampledImageId();
@@ -201,6 +407,8 @@ namespace Neon
 
 	void SceneRenderer::CreateEnvironmentMap(const std::string& filepath)
 	{
+		NEO_PROFILE_SCOPE_CATEGORY("SceneRenderer::CreateEnvironmentMap", "Renderer");
+
 		const uint32 faceSize = 2048;
 		const uint32 irradianceMapSize = 32;
 
@@ -216,39 +424,54 @@ namespace Neon
 			TextureCube::Create({TextureUsageFlagBits::ShaderWrite | TextureUsageFlagBits::ShaderRead, TextureFormat::RGBA16F,
 								 TextureWrap::Clamp, TextureMinMagFilter::Linear, true, 1, true, faceSize, faceSize});
 
-		s_Data.EnvUnfilteredComputeShader->SetStorageTextureCube("o_CubeMap", 0, s_Data.EnvUnfilteredTextureCube,
-																		 0);
-		Renderer::DispatchCompute(s_Data.EnvUnfilteredComputePipeline, faceSize / 32, faceSize / 32, 6);
+		// Dispatches are ordered with the mip generation on the graphics queue, only changed descriptors wait for the GPU
+		SharedRef<ComputeBatch> computeBatch = ComputeBatch::Create();
+
+		s_Data.EnvUnfilteredComputeShader->SetStorageTextureCube("o_CubeMap", 0, s_Data.EnvUnfilteredTextureCube, 0);
+		computeBatch->Dispatch(s_Data.EnvUnfilteredComputePipeline, faceSize / 32, faceSize / 32, 6);
+		computeBatch->Submit();
 		s_Data.EnvUnfilteredTextureCube->RegenerateMipMaps();
 
 		s_Data.EnvUnfilteredComputeShader->SetStorageTextureCube("o_CubeMap", 0, s_Data.EnvFilteredTextureCube, 0);
-		Renderer::DispatchCompute(s_Data.EnvUnfilteredComputePipeline, faceSize / 32, faceSize / 32, 6);
+		computeBatch->Dispatch(s_Data.EnvUnfilteredComputePipeline, faceSize / 32, faceSize / 32, 6);
+		computeBatch->Submit();
 		s_Data.EnvFilteredTextureCube->RegenerateMipMaps();
 
-		s_Data.EnvFilteredComputeShader->SetTextureCube("u_InputCubemap", 0, s_Data.EnvUnfilteredTextureCube, 0);
+		const uint32 filteredLevelCount = s_Data.EnvUnfilteredTextureCube->GetMipLevelCount() - 1;
+		while (s_Data.EnvFilteredComputeShaders.size() < filteredLevelCount)
+		{
+			ShaderSpecification envFilteredComputeShaderSpecification;
+			envFilteredComputeShaderSpecification.ShaderPaths[ShaderType::Compute] =
+				"assets/shaders/EnvironmentMipFilter_Compute.glsl";
+			SharedRef<Shader> shader = Shader::Create(envFilteredComputeShaderSpecification);
+			ComputePipelineSpecification envFilteredComputePipelineSpecification;
+			s_Data.EnvFilteredComputePipelines.push_back(ComputePipeline::Create(shader, envFilteredComputePipelineSpecification));
+			s_Data.EnvFilteredComputeShaders.push_back(shader);
+		}
+
 		for (uint32 level = 1, size = faceSize; level < s_Data.EnvUnfilteredTextureCube->GetMipLevelCount();
 			 level++, size /= 2)
 		{
-			uint32 test = s_Data.EnvFilteredTextureCube->GetMipLevelCount();
+			const SharedRef<Shader>& shader = s_Data.EnvFilteredComputeShaders[level - 1];
 			const uint32 numGroups = glm::max(1u, size / 32);
 			struct
 			{
 				float MipCount;
 				float MipLevel;
 			} pc = {static_cast<float>(s_Data.EnvFilteredTextureCube->GetMipLevelCount()), static_cast<float>(level)};
-			s_Data.EnvFilteredComputeShader->SetPushConstant("u_PushConstant", &pc);
-			s_Data.EnvFilteredComputeShader->SetStorageTextureCube("o_OutputCubemap", 0,
-																		   s_Data.EnvFilteredTextureCube, level);
-			Renderer::DispatchCompute(s_Data.EnvFilteredComputePipeline, numGroups, numGroups, 6);
+			shader->SetPushConstant("u_PushConstant", &pc);
+			shader->SetTextureCube("u_InputCubemap", 0, s_Data.EnvUnfilteredTextureCube, 0);
+			shader->SetStorageTextureCube("o_OutputCubemap", 0, s_Data.EnvFilteredTextureCube, level);
+			computeBatch->Dispatch(s_Data.EnvFilteredComputePipelines[level - 1], numGroups, numGroups, 6);
 		}
 
 		s_Data.IrradianceTextureCube = TextureCube::Create(
 			{TextureUsageFlagBits::ShaderWrite | TextureUsageFlagBits::ShaderRead, TextureFormat::RGBA16F, TextureWrap::Clamp,
 			 TextureMinMagFilter::Linear, true, 1, true, irradianceMapSize, irradianceMapSize});
 		s_Data.IrradianceComputeShader->SetTextureCube("u_InputCubemap", 0, s_Data.EnvFilteredTextureCube, 0);
-		s_Data.IrradianceComputeShader->SetStorageTextureCube("o_OutputCubemap", 0, s_Data.IrradianceTextureCube,
-																	  0);
-		Renderer::DispatchCompute(s_Data.IrradianceComputePipeline, irradianceMapSize / 32, irradianceMapSize / 32, 6);
+		s_Data.IrradianceComputeShader->SetStorageTextureCube("o_OutputCubemap", 0, s_Data.IrradianceTextureCube, 0);
+		computeBatch->Dispatch(s_Data.IrradianceComputePipeline, irradianceMapSize / 32, irradianceMapSize / 32, 6);
+		computeBatch->Submit();
 		s_Data.IrradianceTextureCube->RegenerateMipMaps();
 
 		s_Data.BRDFLUT = Texture2D::Create("assets/textures/environment/BRDF_LUT.tga",
@@ -262,15 +485,136 @@ namespace Neon
 
 	void SceneRenderer::FlushDrawList()
 	{
+		s_Data.FrameNumber++;
+
 		GeometryPass();
 		PostProcessingPass();
-		s_Data.MeshDrawList.clear();
-		s_Data.Lights.clear();
+		ResetDrawList();
+	}
+
+	void SceneRenderer::CullDrawList()
+	{
+		NEO_PROFILE_SCOPE_CATEGORY("SceneRenderer::CullDrawList", "Renderer");
+
+		CullingStats cullingStats;
+		auto& drawList = s_Data.MeshDrawList;
+		if (s_Data.Culling == CullingMode::None || drawList.empty())
+		{
+			s_Data.LastCullingStats = cullingStats;
+			return;
+		}
+
+		const Frustum frustum = Frustum::FromMatrix(s_Data.SceneData.SceneCamera->GetViewProjectionMatrix());
+
+		// Draws without bounds and draws left to the culling pass are kept as they are
+		FrameVector<uint32> testedDraws;
+		testedDraws.reserve(drawList.size());
+		for (uint32 index = 0; index < drawList.size(); index++)
+		{
+			const auto& dc = drawList[index];
+			bool wireframe = Renderer::IsWireframeEnabled() || dc.Wireframe;
+			if (dc.Mesh->HasBounds() && !IsGpuCullable(dc.Mesh.Ptr(), wireframe, s_Data.Culling, s_Data.InstancingEnabled))
+			{
+				testedDraws.push_back(index);
+			}
+		}
+
+		BoxCullBatch meshBoxes(static_cast<uint32>(testedDraws.size()));
+		for (uint32 i = 0; i < testedDraws.size(); i++)
+		{
+			const auto& dc = drawList[testedDraws[i]];
+			meshBoxes.Set(i, dc.Mesh->GetBoundingBox().Transform(dc.Transform));
+		}
+		meshBoxes.Cull(frustum);
+
+		FrameVector<uint8> keepDraw(drawList.size(), 1);
+		uint32 submeshCount = 0;
+		for (uint32 i = 0; i < testedDraws.size(); i++)
+		{
+			keepDraw[testedDraws[i]] = meshBoxes.Visible[i];
+			cullingStats.TestedInstances++;
+			if (meshBoxes.Visible[i])
+			{
+				cullingStats.VisibleInstances++;
+
+				const size_t meshSubmeshCount = drawList[testedDraws[i]].Mesh->GetSubmeshes().size();
+				if (meshSubmeshCount > 1 && meshSubmeshCount <= 64)
+				{
+					submeshCount += static_cast<uint32>(meshSubmeshCount);
+				}
+			}
+		}
+
+		// Submeshes of visible instances get a second round, the resulting mask skips their draw commands
+		if (submeshCount > 0)
+		{
+			BoxCullBatch submeshBoxes(submeshCount);
+			uint32 boxIndex = 0;
+			for (uint32 i = 0; i < testedDraws.size(); i++)
+			{
+				const auto& dc = drawList[testedDraws[i]];
+				const auto& submeshes = dc.Mesh->GetSubmeshes();
+				if (meshBoxes.Visible[i] && submeshes.size() > 1 && submeshes.size() <= 64)
+				{
+					for (const Submesh& submesh : submeshes)
+					{
+						submeshBoxes.Set(boxIndex++, submesh.Bounds.Transform(dc.Transform));
+					}
+				}
+			}
+			submeshBoxes.Cull(frustum);
+
+			boxIndex = 0;
+			for (uint32 i = 0; i < testedDraws.size(); i++)
+			{
+				auto& dc = drawList[testedDraws[i]];
+				const auto& submeshes = dc.Mesh->GetSubmeshes();
+				if (!meshBoxes.Visible[i] || submeshes.size() <= 1 || submeshes.size() > 64)
+				{
+					continue;
+				}
+
+				dc.SubmeshMask = 0;
+				for (uint32 submesh = 0; submesh < submeshes.size(); submesh++)
+				{
+					// Submeshes without vertices have nothing to draw either way
+					if (submeshBoxes.Visible[boxIndex++] || !submeshes[submesh].Bounds.IsValid())
+					{
+						dc.SubmeshMask |= 1ull << submesh;
+					}
+				}
+				cullingStats.TestedSubmeshes += static_cast<uint32>(submeshes.size());
+				cullingStats.VisibleSubmeshes += static_cast<uint32>(std::bitset<64>(dc.SubmeshMask).count());
+			}
+		}
+
+		uint32 keptCount = 0;
+		for (uint32 index = 0; index < drawList.size(); index++)
+		{
+			if (keepDraw[index])
+			{
+				if (keptCount != index)
+				{
+					drawList[keptCount] = std::move(drawList[index]);
+				}
+				keptCount++;
+			}
+		}
+		drawList.erase(drawList.begin() + keptCount, drawList.end());
+
+		s_Data.LastCullingStats = cullingStats;
+	}
+
+	void SceneRenderer::ResetDrawList()
+	{
+		// Storage lives in the frame arena, drop it instead of keeping the capacity around for later frames
+		s_Data.MeshDrawList = FrameVector<SceneRendererData::MeshDrawCommand>();
+		s_Data.Lights = FrameVector<Light>();
 	}
 
 	void SceneRenderer::GeometryPass()
 	{
-		Renderer::BeginRenderPass(s_Data.GeoPass);
+		NEO_PROFILE_SCOPE_CATEGORY("SceneRenderer::GeometryPass", "Renderer");
 
 		auto& sceneCamera = s_Data.SceneData.SceneCamera;
 
@@ -304,46 +648,279 @@ namespace Neon
 
 		struct
 		{
-			glm::mat4 Model = glm::mat4(1.f);
 			glm::mat4 ViewProjection = glm::mat4(1.f);
 			glm::vec4 CameraPosition = glm::vec4();
 		} cameraUBO;
 		cameraUBO.ViewProjection = sceneCamera->GetViewProjectionMatrix();
 		cameraUBO.CameraPosition = glm::vec4(sceneCamera->GetPosition(), 1.f);
 
-		// Render meshes
-		for (auto& dc : s_Data.MeshDrawList)
+		// Shared by every mesh shader through the frame set, draw groups only bind their materials
+		RendererContext::Get()->SetFrameUniformBuffer(s_CameraUBOParam, &cameraUBO, sizeof(cameraUBO));
+		RendererContext::Get()->SetFrameUniformBuffer(s_LightUBOParam, &lightUBO, sizeToUpdate);
+
+		const Frustum frustum = Frustum::FromMatrix(cameraUBO.ViewProjection);
+		const uint32 frameIndex = RendererContext::Get()->GetCurrentFrameIndex();
+		auto isGpuCullable = [](const SceneRendererData::MeshDrawCommand& dc, bool wireframe) {
+			return IsGpuCullable(dc.Mesh.Ptr(), wireframe, s_Data.Culling, s_Data.InstancingEnabled);
+		};
+
+		// CPU culled draws were already dropped from the list. Results of the last culling pass recorded into this frame
+		// slot are kept apart from them, its fence was waited on before the frame began.
+		CullingStats cullingStats = s_Data.LastCullingStats;
+		if (s_Data.CullResultsFrame[frameIndex] > 0)
+		{
+			uint32 counts[2];
+			s_Data.CullComputeShaders[frameIndex]->ReadStorageBuffer(s_DrawCountsParam, counts, sizeof(counts));
+			cullingStats.GpuVisibleInstances = counts[0];
+			cullingStats.GpuTestedInstances = counts[1];
+			cullingStats.GpuFramesLate = static_cast<uint32>(s_Data.FrameNumber - s_Data.CullResultsFrame[frameIndex]);
+			s_Data.CullResultsFrame[frameIndex] = 0;
+		}
+
+		// Sort by state so repeated meshes are submitted back to back and binds can be skipped
+		const glm::vec3 cameraPosition = sceneCamera->GetPosition();
+		FrameVector<DrawSortEntry> sortedDraws;
+		sortedDraws.reserve(s_Data.MeshDrawList.size());
+		for (uint32 index = 0; index < s_Data.MeshDrawList.size(); index++)
+		{
+			const auto& dc = s_Data.MeshDrawList[index];
+			bool wireframe = Renderer::IsWireframeEnabled() || dc.Wireframe;
+			sortedDraws.push_back({CreateDrawSortKey(dc.Mesh.Ptr(), dc.Transform, wireframe, cameraPosition), index});
+		}
+		RadixSortDrawEntries(sortedDraws);
+
+		// Consecutive draws sharing geometry and materials are merged into one instanced group, the submesh commands of every
+		// group go into a single indirect command array. Groups culled on the GPU get their commands and instances from the
+		// culling pass instead.
+		struct DrawGroup
+		{
+			uint32 FirstDraw;
+			uint32 DrawCount;
+			uint32 FirstCommand;
+			uint32 CommandCount;
+			uint32 FirstTransform;
+			bool Wireframe;
+			bool GpuCulled;
+			uint32 CullGroupIndex;
+		};
+		FrameVector<DrawGroup> drawGroups;
+		FrameVector<DrawIndexedIndirectCommand> indirectCommands;
+		FrameVector<glm::mat4> instanceTransforms;
+		instanceTransforms.reserve(sortedDraws.size());
+		FrameVector<CullInstance> cullInstances;
+		FrameVector<CullGroup> cullGroups;
+		FrameVector<DrawIndexedIndirectCommand> cullCommands;
+		for (uint32 drawIndex = 0; drawIndex < sortedDraws.size();)
+		{
+			const auto& dc = s_Data.MeshDrawList[sortedDraws[drawIndex].Index];
+			bool wireframe = Renderer::IsWireframeEnabled() || dc.Wireframe;
+
+			uint32 groupEnd = drawIndex + 1;
+			if (!wireframe && s_Data.InstancingEnabled && dc.Mesh->SupportsInstancing())
+			{
+				while (groupEnd < sortedDraws.size())
+				{
+					const auto& instance = s_Data.MeshDrawList[sortedDraws[groupEnd].Index];
+					if (instance.Mesh->GetVertexBuffer().Ptr() != dc.Mesh->GetVertexBuffer().Ptr() ||
+						instance.Mesh->GetShader().Ptr() != dc.Mesh->GetShader().Ptr() || instance.Wireframe)
+					{
+						break;
+					}
+					groupEnd++;
+				}
+			}
+
+			DrawGroup& group = drawGroups.emplace_back();
+			group.FirstDraw = drawIndex;
+			group.DrawCount = groupEnd - drawIndex;
+			group.Wireframe = wireframe;
+
+			const auto& drawCommands = dc.Mesh->GetDrawCommands();
+			group.CommandCount = static_cast<uint32>(drawCommands.size());
+			group.GpuCulled = isGpuCullable(dc, wireframe) &&
+							  cullInstances.size() + group.DrawCount <= c_MaxGpuCulledInstances &&
+							  cullCommands.size() + drawCommands.size() <= c_MaxGpuCulledCommands;
+			static bool s_CullingCapacityWarned = false;
+			if (isGpuCullable(dc, wireframe) && !group.GpuCulled && !s_CullingCapacityWarned)
+			{
+				NEO_CORE_WARN("Culling pass is full, remaining instances are drawn without culling");
+				s_CullingCapacityWarned = true;
+			}
+
+			if (group.GpuCulled)
+			{
+				group.CullGroupIndex = static_cast<uint32>(cullGroups.size());
+				group.FirstCommand = static_cast<uint32>(cullCommands.size());
+
+				CullGroup& cullGroup = cullGroups.emplace_back();
+				cullGroup.FirstInstance = static_cast<uint32>(cullInstances.size());
+				cullGroup.FirstCommand = group.FirstCommand;
+				cullGroup.CommandCount = static_cast<uint32>(drawCommands.size());
+
+				// Instance counts are filled in by the culling pass
+				for (DrawIndexedIndirectCommand command : drawCommands)
+				{
+					command.InstanceCount = 0;
+					cullCommands.push_back(command);
+				}
+				for (; drawIndex < groupEnd; drawIndex++)
+				{
+					CullInstance& cullInstance = cullInstances.emplace_back();
+					cullInstance.Transform = s_Data.MeshDrawList[sortedDraws[drawIndex].Index].Transform;
+					cullInstance.BoundingSphere = dc.Mesh->GetBoundingSphere();
+					cullInstance.Group = glm::uvec4(group.CullGroupIndex, 0, 0, 0);
+				}
+				continue;
+			}
+
+			group.FirstCommand = static_cast<uint32>(indirectCommands.size());
+			group.FirstTransform = static_cast<uint32>(instanceTransforms.size());
+			uint64 submeshMask = 0;
+			for (; drawIndex < groupEnd; drawIndex++)
+			{
+				const auto& instance = s_Data.MeshDrawList[sortedDraws[drawIndex].Index];
+				submeshMask |= instance.SubmeshMask;
+				instanceTransforms.push_back(instance.Transform);
+			}
+			// Submeshes culled for every instance keep their command with no instances, the group stays one command range
+			for (uint32 commandIndex = 0; commandIndex < drawCommands.size(); commandIndex++)
+			{
+				DrawIndexedIndirectCommand command = drawCommands[commandIndex];
+				bool visible = commandIndex >= 64 || ((submeshMask >> commandIndex) & 1);
+				command.InstanceCount = visible ? group.DrawCount : 0;
+				indirectCommands.push_back(command);
+			}
+		}
+
+		// Culling pass has to be recorded outside of the render pass
+		const SharedRef<Shader>& cullShader = s_Data.CullComputeShaders[frameIndex];
+		if (!cullInstances.empty())
 		{
-			cameraUBO.Model = dc.Transform;
+			const uint32 instanceCount = static_cast<uint32>(cullInstances.size());
+
+			FrameVector<uint32> drawCounts(c_CullGroupCountsOffset + cullGroups.size(), 0);
+			drawCounts[1] = instanceCount;
+
+			cullShader->SetStorageBuffer(s_CullInstancesParam, cullInstances.data(), instanceCount * sizeof(CullInstance));
+			cullShader->SetStorageBuffer(s_CullGroupsParam, cullGroups.data(),
+										 static_cast<uint32>(cullGroups.size()) * sizeof(CullGroup));
+			cullShader->SetStorageBuffer(s_DrawCommandsParam, cullCommands.data(),
+										 static_cast<uint32>(cullCommands.size()) * sizeof(DrawIndexedIndirectCommand));
+			cullShader->SetStorageBuffer(s_DrawCountsParam, drawCounts.data(),
+										 static_cast<uint32>(drawCounts.size()) * sizeof(uint32));
+
+			CullParams cullParams;
+			std::memcpy(cullParams.FrustumPlanes, frustum.Planes, sizeof(cullParams.FrustumPlanes));
+			cullParams.InstanceCount = instanceCount;
+			cullShader->SetPushConstant(s_PushConstantParam, &cullParams);
+
+			Renderer::SubmitCompute(s_Data.CullComputePipelines[frameIndex],
+									(instanceCount + c_CullWorkgroupSize - 1) / c_CullWorkgroupSize, 1, 1);
+			s_Data.CullResultsFrame[frameIndex] = s_Data.FrameNumber;
+		}
+		s_Data.LastCullingStats = cullingStats;
 
-			if (Renderer::IsWireframeEnabled() || dc.Wireframe)
+		auto recordDrawGroups = [&](uint32 firstGroup, uint32 lastGroup) {
+			NEO_PROFILE_SCOPE_CATEGORY("SceneRenderer::RecordDrawGroups", "Renderer");
+
+			// Commands of the CPU culled groups in a range are contiguous, only those are uploaded
+			uint32 firstCommand = ~0u;
+			uint32 lastCommand = 0;
+			for (uint32 groupIndex = firstGroup; groupIndex < lastGroup; groupIndex++)
 			{
-				SharedRef<Shader> meshShader = dc.Mesh->GetWireframeShader();
-				meshShader->SetUniformBuffer("CameraUBO", 0, &cameraUBO);
+				const DrawGroup& group = drawGroups[groupIndex];
+				if (!group.GpuCulled)
+				{
+					firstCommand = std::min(firstCommand, group.FirstCommand);
+					lastCommand = std::max(lastCommand, group.FirstCommand + group.CommandCount);
+				}
 			}
-			else
+			if (firstCommand < lastCommand)
 			{
-				SharedRef<Shader> meshShader = dc.Mesh->GetShader();
-				meshShader->SetUniformBuffer("CameraUBO", 0, &cameraUBO);
-				meshShader->SetUniformBuffer("LightUBO", 0, &lightUBO);
+				Renderer::SetIndirectCommands(indirectCommands.data() + firstCommand, lastCommand - firstCommand);
 			}
 
-			Renderer::SubmitMesh(dc.Mesh, dc.Transform, dc.Wireframe);
+			for (uint32 groupIndex = firstGroup; groupIndex < lastGroup; groupIndex++)
+			{
+				const DrawGroup& group = drawGroups[groupIndex];
+				auto& dc = s_Data.MeshDrawList[sortedDraws[group.FirstDraw].Index];
+
+				// Meshes share shaders, their uniform data has to be recorded before another thread changes it
+				SharedRef<Shader> meshShader = group.Wireframe ? dc.Mesh->GetWireframeShader() : dc.Mesh->GetShader();
+				std::lock_guard<std::mutex> lock(meshShader->GetRecordMutex());
+
+				// Instanced shaders take the model from the instance data
+				if (group.Wireframe || !dc.Mesh->SupportsInstancing())
+				{
+					meshShader->SetPushConstant(s_ModelPCParam, &dc.Transform);
+				}
+
+				if (group.GpuCulled)
+				{
+					const CullGroup& cullGroup = cullGroups[group.CullGroupIndex];
+					Renderer::SubmitMeshIndirectCount(dc.Mesh, cullShader, cullGroup.FirstInstance, cullGroup.FirstCommand,
+													  c_CullGroupCountsOffset + group.CullGroupIndex);
+				}
+				else
+				{
+					Renderer::SubmitMeshIndirect(dc.Mesh, group.FirstCommand - firstCommand,
+												 &instanceTransforms[group.FirstTransform], group.DrawCount, group.Wireframe);
+				}
+			}
+		};
+
+		auto recordSkybox = [&]() {
+			glm::mat4 viewRotation = sceneCamera->GetViewMatrix();
+			viewRotation[3][0] = 0;
+			viewRotation[3][1] = 0;
+			viewRotation[3][2] = 0;
+			glm::mat4 inverseVP = glm::inverse(sceneCamera->GetProjectionMatrix() * viewRotation);
+			s_Data.SkyboxMaterial.GetShader()->SetUniformBuffer(s_SkyboxUBOParam, 0, &inverseVP);
+			Renderer::SubmitFullscreenQuad(s_Data.SkyboxGraphicsPipeline);
+		};
+
+		// Draw heavy scenes split the groups into one chunk per job thread, each recorded into a secondary command buffer
+		const uint32 groupCount = static_cast<uint32>(drawGroups.size());
+		const uint32 chunkCount =
+			s_Data.ParallelRecording ? std::min(JobSystem::GetThreadCount(), groupCount / c_MinDrawGroupsPerRecordingChunk) : 0;
+		if (chunkCount < 2)
+		{
+			Renderer::BeginRenderPass(s_Data.GeoPass);
+			recordDrawGroups(0, groupCount);
+			recordSkybox();
+			Renderer::EndRenderPass();
+			return;
 		}
 
-		glm::mat4 viewRotation = sceneCamera->GetViewMatrix();
-		viewRotation[3][0] = 0;
-		viewRotation[3][1] = 0;
-		viewRotation[3][2] = 0;
-		glm::mat4 inverseVP = glm::inverse(sceneCamera->GetProjectionMatrix() * viewRotation);
-		s_Data.SkyboxMaterial.GetShader()->SetUniformBuffer("CameraUBO", 0, &inverseVP);
-		Renderer::SubmitFullscreenQuad(s_Data.SkyboxGraphicsPipeline);
+		Renderer::BeginRenderPass(s_Data.GeoPass, true);
+
+		FrameVector<SharedRef<CommandBuffer>> commandBuffers(chunkCount);
+		JobSystem::ParallelFor(
+			chunkCount,
+			[&](uint32 begin, uint32 end) {
+				for (uint32 chunk = begin; chunk < end; chunk++)
+				{
+					commandBuffers[chunk] = Renderer::BeginSecondaryCommandBuffer(s_Data.GeoPass);
+					recordDrawGroups(groupCount * chunk / chunkCount, groupCount * (chunk + 1) / chunkCount);
+					// Skybox fills whatever the meshes left, it goes last
+					if (chunk == chunkCount - 1)
+					{
+						recordSkybox();
+					}
+					Renderer::EndSecondaryCommandBuffer();
+				}
+			},
+			1);
+
+		Renderer::ExecuteCommandBuffers(commandBuffers.data(), chunkCount);
 
 		Renderer::EndRenderPass();
 	}
 
 	void SceneRenderer::PostProcessingPass()
 	{
+		NEO_PROFILE_SCOPE_CATEGORY("SceneRenderer::PostProcessingPass", "Renderer");
+
 		Renderer::BeginRenderPass(s_Data.PostProcessingPass);
 		s_Data.PostProcessingShader->SetTexture2D("u_Texture", 0,
 														  s_Data.GeoPass->GetTargetFramebuffer()->GetSampledImage(), 0);
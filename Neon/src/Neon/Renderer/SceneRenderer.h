@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Neon/Core/FrameAllocator.h"
 #include "Neon/Renderer/Camera.h"
 #include "Neon/Renderer/Mesh.h"
 #include "Neon/Scene/Actor.h"
@@ -7,6 +8,30 @@
 
 namespace Neon
 {
+	enum class CullingMode
+	{
+		None,
+		Cpu,
+		// Instanced meshes are culled by a compute pass, everything else on the CPU
+		Gpu
+	};
+
+	// Mesh instances tested against the camera frustum
+	struct CullingStats
+	{
+		// CPU culled instances of the current frame
+		uint32 TestedInstances = 0;
+		uint32 VisibleInstances = 0;
+		// Submeshes of CPU culled instances which passed the instance test
+		uint32 TestedSubmeshes = 0;
+		uint32 VisibleSubmeshes = 0;
+		// GPU culled instances are read back once the frame slot comes around again, so they belong to an earlier frame
+		uint32 GpuTestedInstances = 0;
+		uint32 GpuVisibleInstances = 0;
+		// Frames since the culling pass the GPU counts were read from, 0 without GPU results
+		uint32 GpuFramesLate = 0;
+	};
+
 	class SceneRenderer
 	{
 	public:
@@ -29,10 +54,13 @@ namespace Neon
 
 		static void SetViewportSize(uint32 width, uint32 height);
 
+		// Collects and culls the draw list, can run on any thread as long as only one builds the scene at a time
 		static void BeginScene(Camera* camera);
 		static void EndScene();
+		// Records the scene ended last into the command buffer selected on the calling thread
+		static void RenderScene();
 
-		static void SubmitMesh(const SharedRef<Mesh>& mesh, const glm::mat4& transform = glm::mat4(1.0f), bool wireframe = false);
+		static void SubmitMesh(SharedRef<Mesh> mesh, const glm::mat4& transform = glm::mat4(1.0f), bool wireframe = false);
 		static void SubmitLight(const Light& light);
 
 		static const SharedRef<RenderPass>& GetGeoPass();
@@ -43,6 +71,16 @@ namespace Neon
 
 		static void SetFocusPoint(const glm::vec2& point);
 
+		// Repeated meshes are merged into instanced draws by default
+		static void SetInstancingEnabled(bool enabled);
+		// Records large geometry passes on the job threads
+		static void SetParallelRecordingEnabled(bool enabled);
+		static bool IsParallelRecordingEnabled();
+
+		static void SetCullingMode(CullingMode mode);
+		static CullingMode GetCullingMode();
+		static const CullingStats& GetCullingStats();
+
 		static void* GetFinalImageId();
 
 		static void OnImGuiRender();
@@ -53,6 +91,8 @@ namespace Neon
 
 	private:
 		static void FlushDrawList();
+		static void CullDrawList();
+		static void ResetDrawList();
 		static void GeometryPass();
 		static void PostProcessingPass();
 
@@ -62,7 +102,7 @@ namespace Neon
 			SharedRef<Scene> ActiveScene = nullptr;
 			SharedRef<Actor> SelectedActor = {};
 
-			std::vector<Light> Lights;
+			FrameVector<Light> Lights;
 
 			struct SceneInfo
 			{
@@ -82,14 +122,29 @@ namespace Neon
 
 			glm::vec2 FocusPoint = {0.5f, 0.5f};
 
+			bool InstancingEnabled = true;
+			bool ParallelRecording = true;
+
+			CullingMode Culling = CullingMode::Gpu;
+			CullingStats LastCullingStats;
+			uint64 FrameNumber = 0;
+
+			// One culling shader per frame in flight, its buffers are rewritten once the frame using them finished
+			std::vector<SharedRef<Shader>> CullComputeShaders;
+			std::vector<SharedRef<ComputePipeline>> CullComputePipelines;
+			// Frame whose culling pass wrote the results of each slot, 0 if none are pending
+			std::vector<uint64> CullResultsFrame;
+
 			struct MeshDrawCommand
 			{
 				SharedRef<Mesh> Mesh;
 				glm::mat4 Transform;
 				bool Wireframe;
+				// Bit per submesh which survived CPU culling, submeshes past the first 64 are always drawn
+				uint64 SubmeshMask = ~0ull;
 			};
 
-			std::vector<MeshDrawCommand> MeshDrawList;
+			FrameVector<MeshDrawCommand> MeshDrawList;
 
 			Material SkyboxMaterial;
 			SharedRef<GraphicsPipeline> SkyboxGraphicsPipeline;
@@ -97,8 +152,9 @@ namespace Neon
 			SharedRef<Shader> EnvUnfilteredComputeShader;
 			SharedRef<ComputePipeline> EnvUnfilteredComputePipeline;
 
-			SharedRef<Shader> EnvFilteredComputeShader;
-			SharedRef<ComputePipeline> EnvFilteredComputePipeline;
+			// One filter shader per output mip level, so the whole chain is recorded without changing descriptors
+			std::vector<SharedRef<Shader>> EnvFilteredComputeShaders;
+			std::vector<SharedRef<ComputePipeline>> EnvFilteredComputePipelines;
 
 			SharedRef<Shader> IrradianceComputeShader;
 			SharedRef<ComputePipeline> IrradianceComputePipeline;
@@ -4,11 +4,64 @@
 #include "Renderer.h"
 #include "Shader.h"
 
+#include <deque>
+#include <filesystem>
+
 namespace Neon
 {
+	struct ShaderParamRegistry
+	{
+		std::mutex Mutex;
+		std::unordered_map<std::string, uint32> Ids;
+		// Names are never removed and a deque does not move them, references handed out stay valid
+		std::deque<std::string> Names;
+	};
+
+	// Constructed on first use, handles may be statics of other translation units
+	static ShaderParamRegistry& GetShaderParamRegistry()
+	{
+		static ShaderParamRegistry registry;
+		return registry;
+	}
+
+	ShaderParamHandle::ShaderParamHandle(const char* name)
+		: ShaderParamHandle(std::string(name))
+	{
+	}
+
+	ShaderParamHandle::ShaderParamHandle(const std::string& name)
+	{
+		ShaderParamRegistry& registry = GetShaderParamRegistry();
+		std::lock_guard<std::mutex> lock(registry.Mutex);
+
+		auto [it, inserted] = registry.Ids.try_emplace(name, static_cast<uint32>(registry.Names.size()));
+		if (inserted)
+		{
+			registry.Names.push_back(name);
+		}
+		m_Id = it->second;
+	}
+
+	const std::string& ShaderParamHandle::GetName() const
+	{
+		ShaderParamRegistry& registry = GetShaderParamRegistry();
+		std::lock_guard<std::mutex> lock(registry.Mutex);
+		return registry.Names[m_Id];
+	}
+
 	Shader::Shader(const ShaderSpecification& specification)
 		: m_Specification(specification)
 	{
+		// Named after the compute or vertex stage file, e.g. "PbrStatic_Vert"
+		auto it = m_Specification.ShaderPaths.find(ShaderType::Compute);
+		if (it == m_Specification.ShaderPaths.end())
+		{
+			it = m_Specification.ShaderPaths.find(ShaderType::Vertex);
+		}
+		if (it != m_Specification.ShaderPaths.end())
+		{
+			m_Name = std::filesystem::path(it->second).stem().string();
+		}
 	}
 
 	SharedRef<Shader> Shader::Create(const ShaderSpecification& shaderSpecification)
@@ -6,6 +6,8 @@
 #include <glm/glm.hpp>
 #include <shaderc/shaderc.hpp>
 
+#include <mutex>
+
 namespace Neon
 {
 	enum class ShaderType
@@ -47,9 +49,30 @@ namespace Neon
 		Mat4
 	};
 
+	// Interned name of a shader resource. Interning takes a lock, so handles used per frame or per draw are created once,
+	// e.g. as statics. Shaders resolve them with an array lookup instead of hashing the name on every call.
+	class ShaderParamHandle
+	{
+	public:
+		ShaderParamHandle(const char* name);
+		ShaderParamHandle(const std::string& name);
+
+		// One per distinct name, counting up from zero so they can index tables
+		uint32 GetId() const
+		{
+			return m_Id;
+		}
+		const std::string& GetName() const;
+
+	private:
+		uint32 m_Id = 0;
+	};
+
 	struct ShaderSpecification
 	{
 		VertexBufferLayout VBLayout;
+		// Per instance attributes, read from a second vertex binding at the locations following VBLayout
+		VertexBufferLayout InstanceLayout;
 		std::unordered_map<std::string, uint32> ShaderVariableCounts;
 		std::unordered_map<ShaderType, std::string> ShaderPaths;
 	};
@@ -65,31 +88,53 @@ namespace Neon
 
 		virtual void Reload() = 0;
 
-		virtual void SetUniformBuffer(const std::string& name, uint32 index, const void* data, uint32 size = 0) = 0;
-		virtual void SetStorageBuffer(const std::string& name, const void* data, uint32 size = 0) = 0;
-		virtual void SetPushConstant(const std::string& name, const void* data, uint32 size = 0) = 0;
-		virtual void SetTexture2D(const std::string& name, uint32 index, const SharedRef<Texture2D>& texture, uint32 mipLevel) = 0;
-		virtual void SetStorageTexture2D(const std::string& name, uint32 index, const SharedRef<Texture2D>& texture,
+		virtual void SetUniformBuffer(const ShaderParamHandle& name, uint32 index, const void* data, uint32 size = 0) = 0;
+		virtual void SetStorageBuffer(const ShaderParamHandle& name, const void* data, uint32 size = 0) = 0;
+		// Copies out the start of a storage buffer, only valid once the GPU work writing it has finished
+		virtual void ReadStorageBuffer(const ShaderParamHandle& name, void* outData, uint32 size = 0) const = 0;
+		virtual void SetPushConstant(const ShaderParamHandle& name, const void* data, uint32 size = 0) = 0;
+		virtual void SetTexture2D(const ShaderParamHandle& name, uint32 index, const SharedRef<Texture2D>& texture,
+								  uint32 mipLevel) = 0;
+		virtual void SetStorageTexture2D(const ShaderParamHandle& name, uint32 index, const SharedRef<Texture2D>& texture,
 										 uint32 mipLevel) = 0;
-		virtual void SetTextureCube(const std::string& name, uint32 index, const SharedRef<TextureCube>& texture,
+		virtual void SetTextureCube(const ShaderParamHandle& name, uint32 index, const SharedRef<TextureCube>& texture,
 									uint32 mipLevel) = 0;
-		virtual void SetStorageTextureCube(const std::string& name, uint32 index, const SharedRef<TextureCube>& texture,
+		virtual void SetStorageTextureCube(const ShaderParamHandle& name, uint32 index, const SharedRef<TextureCube>& texture,
 										   uint32 mipLevel) = 0;
 
-		virtual SharedRef<Texture2D> GetTexture2D(const std::string& name, uint32 index) const = 0;
-		virtual SharedRef<TextureCube> GetTextureCube(const std::string& name, uint32 index) const = 0;
+		virtual SharedRef<Texture2D> GetTexture2D(const ShaderParamHandle& name, uint32 index) const = 0;
+		virtual SharedRef<TextureCube> GetTextureCube(const ShaderParamHandle& name, uint32 index) const = 0;
 
 		const VertexBufferLayout& GetVertexBufferLayout() const
 		{
 			return m_Specification.VBLayout;
 		}
+		const VertexBufferLayout& GetInstanceLayout() const
+		{
+			return m_Specification.InstanceLayout;
+		}
 
 		const ShaderSpecification& GetShaderSpecification() const
 		{
 			return m_Specification;
 		}
 
+		const std::string& GetName() const
+		{
+			return m_Name;
+		}
+
+		// Held from setting per draw data until the pipeline is bound, when draws of one shader are recorded from
+		// several threads
+		std::mutex& GetRecordMutex() const
+		{
+			return m_RecordMutex;
+		}
+
 	protected:
 		ShaderSpecification m_Specification;
+		std::string m_Name;
+
+		mutable std::mutex m_RecordMutex;
 	};
 } // namespace Neon
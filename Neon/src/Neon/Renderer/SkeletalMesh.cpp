@@ -16,6 +16,8 @@
 
 namespace Neon
 {
+	static const ShaderParamHandle s_BonesUBOParam("BonesUBO");
+
 	static glm::mat4 Mat4FromAssimpMat4(const aiMatrix4x4& matrix)
 	{
 		glm::mat4 result;
@@ -70,6 +72,10 @@ namespace Neon
 
 		m_IsAnimated = m_Scene->mAnimations != nullptr;
 
+		// Skinned vertices leave the bind pose bounds, keep these meshes out of culling
+		m_BoundingBox = BoundingBox();
+		m_BoundingSphere = glm::vec4(0.f);
+
 		std::set<std::string> boneNames;
 		// Get vertices and bone names
 		for (uint32 m = 0; m < m_Scene->mNumMeshes; m++)
@@ -222,8 +228,8 @@ namespace Neon
 			glm::mat4 finalTransform = m_InverseTransform * m_Skeleton[i].NodeTransform * m_Skeleton[i].BoneTransform;
 			boneTransforms[i] = finalTransform;
 		}
-		m_MeshShader->SetStorageBuffer("BonesUBO", boneTransforms.data());
-		m_WireframeMeshShader->SetStorageBuffer("BonesUBO", boneTransforms.data());
+		m_MeshShader->SetStorageBuffer(s_BonesUBOParam, boneTransforms.data());
+		m_WireframeMeshShader->SetStorageBuffer(s_BonesUBOParam, boneTransforms.data());
 	}
 
 	void SkeletalMesh::ReadNodeHierarchy(float animationTime, const aiNode* pNode, const glm::mat4& parentTransform)
@@ -18,9 +18,46 @@ namespace Neon
 	{
 		m_Vertices = vertices;
 
+		Submesh& submesh = m_Submeshes[0];
+		for (const Vertex& vertex : m_Vertices)
+		{
+			submesh.Bounds.Expand(vertex.Position);
+		}
+		if (submesh.Bounds.IsValid())
+		{
+			glm::vec3 center = submesh.Bounds.GetCenter();
+			float radiusSquared = 0.f;
+			for (const Vertex& vertex : m_Vertices)
+			{
+				radiusSquared = glm::max(radiusSquared, glm::dot(vertex.Position - center, vertex.Position - center));
+			}
+			submesh.BoundingSphere = glm::vec4(center, glm::sqrt(radiusSquared));
+		}
+		UpdateBounds();
+
 		SetupBuffers();
 	}
 
+	SharedRef<StaticMesh> StaticMesh::GetOrLoad(const std::string& filename, glm::vec3 scale /*= glm::vec3(1.f)*/)
+	{
+		static std::mutex s_CacheMutex;
+		static std::unordered_map<std::string, WeakRef<StaticMesh>> s_Cache;
+
+		std::string key = filename + "|" + std::to_string(scale.x) + "," + std::to_string(scale.y) + "," + std::to_string(scale.z);
+
+		SharedRef<StaticMesh> source;
+		{
+			std::lock_guard<std::mutex> lock(s_CacheMutex);
+			source = s_Cache[key].Lock();
+			if (!source)
+			{
+				source = SharedRef<StaticMesh>::Create(filename, scale);
+				s_Cache[key] = source;
+			}
+		}
+		return SharedRef<StaticMesh>::Create(source);
+	}
+
 	StaticMesh::StaticMesh(const std::string& filename, glm::vec3 scale /*= glm::vec3(1.f)*/)
 		: Mesh(filename)
 	{
@@ -56,6 +93,8 @@ namespace Neon
 			}
 		}
 
+		TransformBounds(glm::scale(glm::mat4(1.f), scale));
+
 		SetupBuffers();
 	}
 
@@ -64,6 +103,12 @@ namespace Neon
 	{
 	}
 
+	StaticMesh::StaticMesh(const SharedRef<StaticMesh>& source)
+		: Mesh(source)
+		, m_Source(source)
+	{
+	}
+
 	void StaticMesh::SetupBuffers()
 	{
 		ShaderSpecification shaderSpecification;
@@ -85,7 +130,7 @@ namespace Neon
 		}
 
 		shaderSpecification.ShaderPaths[ShaderType::Fragment] = "assets/shaders/Pbr_Frag.glsl";
-		shaderSpecification.ShaderPaths[ShaderType::Vertex] = "assets/shaders/PbrStatic_Vert.glsl";
+		shaderSpecification.ShaderPaths[ShaderType::Vertex] = "assets/shaders/PbrStaticInstanced_Vert.glsl";
 
 		std::vector<VertexBufferElement> elements = {{ShaderDataType::Float3}, {ShaderDataType::Float3}, {ShaderDataType::Float3},
 													 {ShaderDataType::Float3}, {ShaderDataType::UInt},	 {ShaderDataType::Float2}};
@@ -95,6 +140,9 @@ namespace Neon
 			VertexBuffer::Create(m_Vertices.data(), static_cast<uint32>(m_Vertices.size()) * sizeof(Vertex), vertexBufferLayout);
 
 		shaderSpecification.VBLayout = vertexBufferLayout;
+		// Model matrix columns
+		shaderSpecification.InstanceLayout = std::vector<VertexBufferElement>{
+			{ShaderDataType::Float4}, {ShaderDataType::Float4}, {ShaderDataType::Float4}, {ShaderDataType::Float4}};
 
 		ShaderSpecification wireframeShaderSpecification;
 		wireframeShaderSpecification.ShaderPaths[ShaderType::Fragment] = "assets/shaders/Wireframe_Frag.glsl";
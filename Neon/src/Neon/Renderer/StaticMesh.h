@@ -17,10 +17,16 @@ namespace Neon
 			glm::vec2 Texcoord;
 		};
 
+	public:
+		// Every caller gets its own mesh sharing the vertex and index buffers of the cached one. Materials are shared until
+		// modified, so repeated meshes can be drawn instanced.
+		static SharedRef<StaticMesh> GetOrLoad(const std::string& filename, glm::vec3 scale = glm::vec3(1.f));
+
 	public:
 		StaticMesh(const std::string& name, const std::vector<Vertex>& vertices, const std::vector<Index>& indices);
 		StaticMesh(const std::string& filename, glm::vec3 scale = glm::vec3(1.f));
 		StaticMesh(ShaderSpecification& shaderSpec, GraphicsPipelineSpecification& pipelineSpec);
+		StaticMesh(const SharedRef<StaticMesh>& source);
 		virtual ~StaticMesh() = default;
 
 	private:
@@ -28,5 +34,8 @@ namespace Neon
 
 	private:
 		std::vector<Vertex> m_Vertices;
+
+		// Keeps the cache entry alive for as long as a mesh built from it is
+		SharedRef<StaticMesh> m_Source;
 	};
 } // namespace Neon
@@ -8,6 +8,10 @@
 
 namespace Neon
 {
+	// Set on every tick
+	static const ShaderParamHandle s_TimeUBOParam("TimeUBO");
+	static const ShaderParamHandle s_PropertiesUBOParam("PropertiesUBO");
+
 	OceanComponent::OceanComponent(Actor* owner, uint32 n)
 		: ActorComponent(owner)
 		, m_N(n)
@@ -126,7 +130,8 @@ namespace Neon
 		} properties = {m_N, L, 0.35f * 1e-3f, 8.f, glm::vec2{-0.4f, -0.9f}};
 		m_InitialSpectrumShader->SetUniformBuffer("PropertiesUBO", 0, &properties);
 
-		Renderer::DispatchCompute(m_InitialSpectrumPipeline, m_N / 32, m_N / 32, 1);
+		m_ComputeBatch = ComputeBatch::Create();
+		m_ComputeBatch->Dispatch(m_InitialSpectrumPipeline, m_N / 32, m_N / 32, 1);
 
 		m_CurrentSpectrumShader->SetStorageTexture2D("u_HktDy", 0, m_HktDy, 0);
 		m_CurrentSpectrumShader->SetStorageTexture2D("u_HktDx", 0, m_HktDx, 0);
@@ -164,7 +169,8 @@ namespace Neon
 		m_TwiddleFactorsShader->SetStorageBuffer("BitReversedUBO", bitsReversed.data(),
 												 static_cast<uint32>(bitsReversed.size() * sizeof(bitsReversed[0])));
 		m_TwiddleFactorsShader->SetUniformBuffer("PropertiesUBO", 0, &properties);
-		Renderer::DispatchCompute(m_TwiddleFactorsPipeline, m_LogN, m_N / 32, 1);
+		m_ComputeBatch->Dispatch(m_TwiddleFactorsPipeline, m_LogN, m_N / 32, 1);
+		m_ComputeBatch->Submit();
 
 		for (uint32 i = 0; i < std::size(m_PingPong); i++)
 		{
@@ -287,8 +293,8 @@ namespace Neon
 	{
 		ActorComponent::TickComponent(deltaSeconds);
 
-		m_CurrentSpectrumShader->SetUniformBuffer("TimeUBO", 0, &m_CurrentTimeSeconds);
-		Renderer::DispatchCompute(m_CurrentSpectrumPipeline, m_N / 32, m_N / 32, 1);
+		m_CurrentSpectrumShader->SetUniformBuffer(s_TimeUBOParam, 0, &m_CurrentTimeSeconds);
+		m_ComputeBatch->Dispatch(m_CurrentSpectrumPipeline, m_N / 32, m_N / 32, 1);
 		m_CurrentTimeSeconds += deltaSeconds;
 
 		uint32 pingPong = 0;
@@ -303,17 +309,18 @@ namespace Neon
 					uint32 Direction;
 				} butterflyData = {i, pingPong, direction};
 
-				m_ButterflyShader->SetUniformBuffer("PropertiesUBO", 0, &butterflyData);
-				Renderer::DispatchCompute(m_ButterflyPipeline, m_N / 32, m_N / 32, 1);
+				m_ButterflyShader->SetUniformBuffer(s_PropertiesUBOParam, 0, &butterflyData);
+				m_ComputeBatch->Dispatch(m_ButterflyPipeline, m_N / 32, m_N / 32, 1);
 
 				pingPong++;
 				pingPong %= 2;
 			}
 		}
 
-		Renderer::DispatchCompute(m_DisplacementPipeline, m_N / 32, m_N / 32, 1);
+		m_ComputeBatch->Dispatch(m_DisplacementPipeline, m_N / 32, m_N / 32, 1);
 
-		Renderer::DispatchCompute(m_JacobianPipeline, m_N / 32, m_N / 32, 1);
+		m_ComputeBatch->Dispatch(m_JacobianPipeline, m_N / 32, m_N / 32, 1);
+		m_ComputeBatch->Submit();
 
 		if (m_Mesh)
 		{
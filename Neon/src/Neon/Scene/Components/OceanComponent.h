@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Neon/Renderer/ComputeBatch.h"
 #include "Neon/Renderer/Mesh.h"
 #include "Neon/Scene/Components/ActorComponent.h"
 
@@ -69,6 +70,9 @@ namespace Neon
 		SharedRef<ComputePipeline> m_JacobianPipeline;
 		SharedRef<Texture2D> m_JacobianTexture;
 
+		// Spectrum and FFT passes of a tick are submitted together, ordered with the frames on the graphics queue
+		SharedRef<ComputeBatch> m_ComputeBatch;
+
 		SharedRef<Mesh> m_Mesh;
 	};
 } // namespace Neon
@@ -122,19 +122,22 @@ namespace Neon
 	{
 		NEO_CORE_ASSERT(mesh);
 
+		// Only edits go through the mutable materials, so viewing a mesh leaves it sharing the materials of its instances
+		const Mesh* viewedMesh = mesh.Ptr();
+
 		ImGui::BeginTable("##meshmaterialssizetable", 2);
 
 		ImGui::TableNextColumn();
 		ImGui::Text("Size");
 
 		ImGui::TableNextColumn();
-		ImGui::InputText("##meshmaterialssize", (char*)std::to_string(mesh->GetMaterials().size()).c_str(), 10);
+		ImGui::InputText("##meshmaterialssize", (char*)std::to_string(viewedMesh->GetMaterials().size()).c_str(), 10);
 
 		ImGui::EndTable();
 
-		for (uint32 i = 0; i < mesh->GetMaterials().size(); i++)
+		for (uint32 i = 0; i < viewedMesh->GetMaterials().size(); i++)
 		{
-			Material& material = mesh->GetMaterials()[i];
+			const Material& material = viewedMesh->GetMaterials()[i];
 			MaterialProperties materialProperties = material.GetProperties();
 
 			std::string name = "Element " + std::to_string(i);
@@ -155,7 +158,7 @@ namespace Neon
 						{
 							SharedRef<Texture2D> albedoMap =
 								Texture2D::Create(filename, {TextureUsageFlagBits::ShaderRead, TextureFormat::SRGBA8});
-							material.SetTexture2D("u_AlbedoTextures", albedoMap, 0);
+							mesh->GetMaterials()[i].SetTexture2D("u_AlbedoTextures", albedoMap, 0);
 						}
 					}
 
@@ -188,7 +191,7 @@ namespace Neon
 						{
 							SharedRef<Texture2D> normalMap =
 								Texture2D::Create(filename, {TextureUsageFlagBits::ShaderRead, TextureFormat::RGBA8});
-							material.SetTexture2D("u_NormalTextures", normalMap, 0);
+							mesh->GetMaterials()[i].SetTexture2D("u_NormalTextures", normalMap, 0);
 							materialProperties.UseNormalMap = 1.f;
 						}
 					}
@@ -219,7 +222,7 @@ namespace Neon
 						{
 							SharedRef<Texture2D> metalnessMap =
 								Texture2D::Create(filename, {TextureUsageFlagBits::ShaderRead, TextureFormat::SRGBA8});
-							material.SetTexture2D("u_MetalnessTextures", metalnessMap, 0);
+							mesh->GetMaterials()[i].SetTexture2D("u_MetalnessTextures", metalnessMap, 0);
 							materialProperties.UseMetalnessMap = 1.f;
 						}
 					}
@@ -253,7 +256,7 @@ namespace Neon
 						{
 							SharedRef<Texture2D> roughnessMap =
 								Texture2D::Create(filename, {TextureUsageFlagBits::ShaderRead, TextureFormat::SRGBA8});
-							material.SetTexture2D("u_RoughnessTextures", roughnessMap, 0);
+							mesh->GetMaterials()[i].SetTexture2D("u_RoughnessTextures", roughnessMap, 0);
 							materialProperties.UseRoughnessMap = 1.f;
 						}
 					}
@@ -273,7 +276,10 @@ namespace Neon
 
 				ImGui::TreePop();
 
-				material.SetProperties(materialProperties);
+				if (std::memcmp(&materialProperties, &material.GetProperties(), sizeof(MaterialProperties)) != 0)
+				{
+					mesh->GetMaterials()[i].SetProperties(materialProperties);
+				}
 			}
 
 			ImGui::Spacing();
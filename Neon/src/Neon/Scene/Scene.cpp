@@ -1,5 +1,6 @@
 #include "neopch.h"
 
+#include "Neon/Core/Profiler.h"
 #include "Neon/Renderer/SceneRenderer.h"
 #include "Neon/Scene/Actor.h"
 #include "Neon/Scene/Actors/Pawn.h"
@@ -38,6 +39,8 @@ namespace Neon
 
 	void Scene::TickScene(float deltaSeconds)
 	{
+		NEO_PROFILE_SCOPE_CATEGORY("Scene::TickScene", "Scene");
+
 		for (auto& actor : m_Actors)
 		{
 			NEO_CORE_ASSERT(actor);
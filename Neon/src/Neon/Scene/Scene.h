@@ -38,7 +38,7 @@ namespace Neon
 		{
 			auto actor = CreateActor<T>(uuid, name, args...);
 
-			SharedRef<StaticMesh> staticMesh = SharedRef<StaticMesh>::Create(path, scale);
+			SharedRef<StaticMesh> staticMesh = StaticMesh::GetOrLoad(path, scale);
 			actor->AddRootComponent<StaticMeshComponent>(actor.Ptr(), staticMesh);
 
 			return actor;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <thread>
 #include <vector>
 
 namespace Neon
@@ -8,6 +11,7 @@ namespace Neon
 	class File
 	{
 	public:
+		// Fails for files whose size is not a multiple of the element size
 		template <typename T>
 		static bool ReadFromFile(const std::string& filename, std::vector<T>& data, bool binary)
 		{
@@ -24,6 +28,12 @@ namespace Neon
 			}
 
 			size_t fileSize = (size_t)file.tellg();
+			if (fileSize % sizeof(T) != 0)
+			{
+				data.clear();
+				return false;
+			}
+
 			data.resize(fileSize / sizeof(T));
 			file.seekg(0);
 			file.read(reinterpret_cast<char*>(data.data()), fileSize);
@@ -47,6 +57,42 @@ namespace Neon
 			file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
 			file.close();
 		}
+
+		// Writes a temporary file next to the target and renames it over the target, so readers never see a partially
+		// written file. Threads writing the same file concurrently use separate temporary files.
+		template <typename T>
+		static bool WriteToFileAtomic(const std::string& filename, const std::vector<T>& data, bool binary)
+		{
+			std::string tempFilename =
+				filename + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+			std::ios::openmode flags = std::ios::trunc;
+			if (binary)
+			{
+				flags |= std::ios::binary;
+			}
+			std::ofstream file(tempFilename, flags);
+			if (!file.is_open())
+			{
+				return false;
+			}
+
+			file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+			file.close();
+
+			std::error_code error;
+			if (!file)
+			{
+				std::filesystem::remove(tempFilename, error);
+				return false;
+			}
+			std::filesystem::rename(tempFilename, filename, error);
+			if (error)
+			{
+				std::filesystem::remove(tempFilename, error);
+				return false;
+			}
+			return true;
+		}
 	};
 
 } // namespace Neon
\ No newline at end of file
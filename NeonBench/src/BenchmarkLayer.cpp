@@ -0,0 +1,866 @@
+#include "neopch.h"
+
+#include "BenchmarkLayer.h"
+
+#include <Neon/Core/JobSystem.h>
+#include <Neon/Core/Profiler.h>
+#include <Neon/Math/HalfFloat.h>
+#include <Neon/Physics/Physics.h>
+#include <Neon/Physics/PhysicsMaterial.h>
+#include <Neon/Renderer/RendererAPI.h>
+#include <Neon/Renderer/RendererContext.h>
+#include <Neon/Renderer/SceneRenderer.h>
+#include <Neon/Renderer/Shader.h>
+#include <Neon/Scene/Actor.h>
+#include <Neon/Scene/Components/LightComponent.h>
+#include <Neon/Scene/Components/OceanComponent.h>
+#include <Neon/Scene/Components/SkeletalMeshComponent.h>
+#include <Neon/Scene/Components/StaticMeshComponent.h>
+
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include <psapi.h>
+
+namespace Neon
+{
+	void BenchmarkSettings::ParseCommandLine(const ApplicationCommandLineArgs& args)
+	{
+		for (int i = 1; i < args.Count; i++)
+		{
+			if (strcmp(args[i], "--no-instancing") == 0)
+			{
+				Instancing = false;
+			}
+			else if (strcmp(args[i], "--serial-recording") == 0)
+			{
+				ParallelRecording = false;
+			}
+			else if (i + 1 >= args.Count)
+			{
+				break;
+			}
+			else if (strcmp(args[i], "--scene") == 0)
+			{
+				Scene = args[++i];
+			}
+			else if (strcmp(args[i], "--count") == 0)
+			{
+				Count = static_cast<uint32>(std::strtoul(args[++i], nullptr, 10));
+			}
+			else if (strcmp(args[i], "--warmup") == 0)
+			{
+				WarmupFrames = static_cast<uint32>(std::strtoul(args[++i], nullptr, 10));
+			}
+			else if (strcmp(args[i], "--frames") == 0)
+			{
+				Frames = std::max(1u, static_cast<uint32>(std::strtoul(args[++i], nullptr, 10)));
+			}
+			else if (strcmp(args[i], "--timestep") == 0)
+			{
+				FixedTimestep = std::strtof(args[++i], nullptr);
+			}
+			else if (strcmp(args[i], "--physics-threads") == 0)
+			{
+				PhysicsThreads = static_cast<uint32>(std::strtoul(args[++i], nullptr, 10));
+			}
+			else if (strcmp(args[i], "--job-threads") == 0)
+			{
+				JobThreads = static_cast<uint32>(std::strtoul(args[++i], nullptr, 10));
+			}
+			else if (strcmp(args[i], "--output") == 0)
+			{
+				OutputPath = args[++i];
+			}
+			else if (strcmp(args[i], "--culling") == 0)
+			{
+				Culling = args[++i];
+			}
+		}
+	}
+
+	// Baseline for the job system, a single locked queue like the thread pool it replaced
+	class MutexThreadPool
+	{
+	public:
+		MutexThreadPool(uint32 threadCount)
+		{
+			for (uint32 i = 0; i < threadCount; i++)
+			{
+				m_Threads.emplace_back([this]() { WorkerLoop(); });
+			}
+		}
+
+		~MutexThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Stop = true;
+			}
+			m_Condition.notify_all();
+			for (auto& thread : m_Threads)
+			{
+				thread.join();
+			}
+		}
+
+		void Push(std::function<void()> job)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Jobs.push(std::move(job));
+				m_PendingJobs++;
+			}
+			m_Condition.notify_one();
+		}
+
+		void WaitIdle()
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_IdleCondition.wait(lock, [this]() { return m_PendingJobs == 0; });
+		}
+
+	private:
+		void WorkerLoop()
+		{
+			while (true)
+			{
+				std::function<void()> job;
+				{
+					std::unique_lock<std::mutex> lock(m_Mutex);
+					m_Condition.wait(lock, [this]() { return m_Stop || !m_Jobs.empty(); });
+					if (m_Stop && m_Jobs.empty())
+					{
+						return;
+					}
+					job = std::move(m_Jobs.front());
+					m_Jobs.pop();
+				}
+
+				job();
+
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				if (--m_PendingJobs == 0)
+				{
+					m_IdleCondition.notify_all();
+				}
+			}
+		}
+
+	private:
+		std::vector<std::thread> m_Threads;
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		std::condition_variable m_IdleCondition;
+		std::queue<std::function<void()>> m_Jobs;
+		uint32 m_PendingJobs = 0;
+		bool m_Stop = false;
+	};
+
+	static double GetElapsedMilliseconds(uint64 start)
+	{
+		return (Profiler::GetTimestamp() - start) / 1e6;
+	}
+
+	// Baseline for SharedRef, the plain counter reference counting used before it became thread safe
+	class PlainRefCounted
+	{
+	public:
+		void AddRef() const
+		{
+			m_RefCount++;
+		}
+		bool RemoveRef() const
+		{
+			return --m_RefCount == 0;
+		}
+
+	private:
+		mutable uint32 m_RefCount = 0;
+	};
+
+	template<typename T>
+	class PlainRef
+	{
+	public:
+		PlainRef(T* ptr)
+			: m_Ptr(ptr)
+		{
+			m_Ptr->AddRef();
+		}
+		PlainRef(const PlainRef& other)
+			: m_Ptr(other.m_Ptr)
+		{
+			m_Ptr->AddRef();
+		}
+		~PlainRef()
+		{
+			if (m_Ptr->RemoveRef())
+			{
+				delete m_Ptr;
+			}
+		}
+		PlainRef& operator=(const PlainRef&) = delete;
+
+		T* operator->() const
+		{
+			return m_Ptr;
+		}
+
+	private:
+		T* m_Ptr;
+	};
+
+	struct PlainRefMesh : public PlainRefCounted
+	{
+		uint64 Value = 1;
+	};
+
+	struct SharedRefMesh : public RefCounted
+	{
+		uint64 Value = 1;
+	};
+
+	static std::atomic<uint64> s_RefBenchmarkSink = 0;
+
+	// Draw list path, every submitted mesh is copied into the list and released when the list is dropped
+	template<typename RefType>
+	static double MeasureDrawListRefs(const std::vector<RefType>& meshes, uint32 iterations)
+	{
+		uint64 start = Profiler::GetTimestamp();
+		for (uint32 iteration = 0; iteration < iterations; iteration++)
+		{
+			std::vector<RefType> drawList;
+			drawList.reserve(meshes.size());
+			for (const RefType& mesh : meshes)
+			{
+				drawList.push_back(mesh);
+			}
+			s_RefBenchmarkSink.fetch_add(drawList.size(), std::memory_order_relaxed);
+		}
+		return GetElapsedMilliseconds(start);
+	}
+
+	// Scene tick path, a temporary reference per actor while it is ticked
+	template<typename RefType>
+	static uint64 TickRefs(const std::vector<RefType>& meshes, uint32 begin, uint32 end)
+	{
+		uint64 sum = 0;
+		for (uint32 i = begin; i < end; i++)
+		{
+			RefType mesh = meshes[i];
+			sum += mesh->Value;
+		}
+		return sum;
+	}
+
+	// Small amount of work per job so scheduling overhead dominates
+	static uint64 TinyJob(uint64 value)
+	{
+		for (uint32 i = 0; i < 16; i++)
+		{
+			value = value * 6364136223846793005ull + 1442695040888963407ull;
+		}
+		return value;
+	}
+
+	static double GetPercentile(const std::vector<double>& sortedValues, double percentile)
+	{
+		if (sortedValues.empty())
+		{
+			return 0.0;
+		}
+		// Nearest rank
+		size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sortedValues.size()));
+		return sortedValues[std::clamp<size_t>(rank, 1, sortedValues.size()) - 1];
+	}
+
+	static void WriteJsonString(std::ofstream& out, const std::string& str)
+	{
+		out << '"';
+		for (char c : str)
+		{
+			if (c == '"' || c == '\\')
+			{
+				out << '\\';
+			}
+			out << c;
+		}
+		out << '"';
+	}
+
+	BenchmarkLayer::BenchmarkLayer(const BenchmarkSettings& settings)
+		: Layer("BenchmarkLayer")
+		, m_Settings(settings)
+	{
+	}
+
+	void BenchmarkLayer::OnAttach()
+	{
+		Profiler::SetEnabled(true);
+
+		if (m_Settings.Scene == "jobs")
+		{
+			RunJobSystemBenchmark();
+			return;
+		}
+		if (m_Settings.Scene == "hdr")
+		{
+			RunHdrConversionBenchmark();
+			return;
+		}
+		if (m_Settings.Scene == "refs")
+		{
+			RunRefCountBenchmark();
+			return;
+		}
+		if (m_Settings.Scene == "params")
+		{
+			RunShaderParamBenchmark();
+			return;
+		}
+
+		SceneRenderer::SetInstancingEnabled(m_Settings.Instancing);
+		SceneRenderer::SetParallelRecordingEnabled(m_Settings.ParallelRecording);
+		if (m_Settings.Culling == "none")
+		{
+			SceneRenderer::SetCullingMode(CullingMode::None);
+		}
+		else if (m_Settings.Culling == "cpu")
+		{
+			SceneRenderer::SetCullingMode(CullingMode::Cpu);
+		}
+		else
+		{
+			m_Settings.Culling = "gpu";
+			SceneRenderer::SetCullingMode(CullingMode::Gpu);
+		}
+
+		// Scene setup up to the first frame, shader, pipeline and mesh loading included
+		uint64 loadStart = Profiler::GetTimestamp();
+
+		m_Scene = SharedRef<Scene>::Create(m_Settings.Scene);
+		m_Scene->Init();
+
+		{
+			auto light = m_Scene->CreateActor<Actor>(1, "DirectionalLight");
+			light->AddComponent<LightComponent>(light.Ptr(), glm::normalize(glm::vec4{1.f, 0.3f, 1.f, 0.f}));
+		}
+
+		if (m_Settings.Scene == "static")
+		{
+			CreateStaticMeshScene(m_Settings.Count > 0 ? m_Settings.Count : 256);
+		}
+		else if (m_Settings.Scene == "cars")
+		{
+			CreateCarScene(m_Settings.Count > 0 ? m_Settings.Count : 16);
+		}
+		else if (m_Settings.Scene == "ocean")
+		{
+			CreateOceanScene(m_Settings.Count > 0 ? m_Settings.Count : 512);
+		}
+		else if (m_Settings.Scene == "physics")
+		{
+			CreatePhysicsScene(m_Settings.Count > 0 ? m_Settings.Count : 512);
+		}
+		else
+		{
+			NEO_ERROR("Unknown benchmark scene {0}", m_Settings.Scene);
+		}
+		m_LoadMilliseconds = (Profiler::GetTimestamp() - loadStart) / 1e6;
+
+		auto [width, height] = Application::Get().GetWindow().GetSize();
+		m_Camera.SetViewportSize(width, height);
+
+		m_FrameTimes.reserve(m_Settings.Frames);
+	}
+
+	void BenchmarkLayer::OnDetach()
+	{
+		WriteResults();
+	}
+
+	void BenchmarkLayer::Update(float deltaSeconds)
+	{
+		if (!m_Scene)
+		{
+			return;
+		}
+
+		// Previous frame is complete by now, first measured frame is the one right after warmup
+		if (m_FrameIndex == m_Settings.WarmupFrames)
+		{
+			m_MeasureStart = Profiler::GetTimestamp();
+		}
+		else if (m_FrameIndex > m_Settings.WarmupFrames)
+		{
+			m_FrameTimes.push_back((Profiler::GetLastFrameEnd() - Profiler::GetLastFrameStart()) / 1e6);
+
+			for (const GpuTiming& timing : RendererContext::Get()->GetGpuTimings())
+			{
+				m_GpuStageTotals[timing.Name] += timing.Milliseconds;
+			}
+		}
+		m_FrameIndex++;
+
+		SceneRenderer::BeginScene(&m_Camera);
+		m_Scene->TickScene(deltaSeconds);
+		SceneRenderer::EndScene();
+	}
+
+	void BenchmarkLayer::Tick(float deltaSeconds)
+	{
+		if (!m_Scene)
+		{
+			return;
+		}
+
+		SceneRenderer::RenderScene();
+
+		if (m_FrameIndex > m_Settings.WarmupFrames)
+		{
+			const CommandBufferStats& commandStats = RendererContext::Get()->GetPrimaryRenderCommandBuffer()->GetStats();
+			m_CommandTotals.DrawCalls += commandStats.DrawCalls;
+			m_CommandTotals.Instances += commandStats.Instances;
+			m_CommandTotals.PipelineBinds += commandStats.PipelineBinds;
+			m_CommandTotals.DescriptorSetBinds += commandStats.DescriptorSetBinds;
+			m_CommandTotals.VertexBufferBinds += commandStats.VertexBufferBinds;
+			m_CommandTotals.IndexBufferBinds += commandStats.IndexBufferBinds;
+			m_CommandTotals.SkippedBinds += commandStats.SkippedBinds;
+			m_CommandTotals.DroppedDraws += commandStats.DroppedDraws;
+
+			const CullingStats& cullingStats = SceneRenderer::GetCullingStats();
+			m_CulledTestedTotal += cullingStats.TestedInstances;
+			m_CulledVisibleTotal += cullingStats.VisibleInstances;
+			m_GpuCulledTestedTotal += cullingStats.GpuTestedInstances;
+			m_GpuCulledVisibleTotal += cullingStats.GpuVisibleInstances;
+			m_CulledSubmeshTestedTotal += cullingStats.TestedSubmeshes;
+			m_CulledSubmeshVisibleTotal += cullingStats.VisibleSubmeshes;
+		}
+	}
+
+	void BenchmarkLayer::OnFrameTasks(TaskGraph& taskGraph, const FrameTasks& frameTasks)
+	{
+		if (!m_Scene)
+		{
+			return;
+		}
+
+		// Camera input polls the window, so it is handled on the main thread before the scene is culled with it
+		TaskHandle cameraTask = taskGraph.AddTask(
+			"BenchmarkCamera", [this]() { m_Camera.Tick(Application::Get().GetDeltaSeconds()); }, {},
+			TaskAffinity::MainThread);
+		taskGraph.AddDependency(frameTasks.LayerUpdate, cameraTask);
+	}
+
+	void BenchmarkLayer::CreateStaticMeshScene(uint32 count)
+	{
+		const uint32 side = static_cast<uint32>(std::ceil(std::sqrt(static_cast<float>(count))));
+		const float spacing = 3.f;
+		for (uint32 i = 0; i < count; i++)
+		{
+			auto sphere = m_Scene->CreateStaticMeshActor<Actor>("assets/models/primitives/Sphere.fbx", 100 + i, "Sphere",
+															   glm::vec3(1.f, 1.f, 1.f));
+			sphere->SetTranslation(
+				glm::vec3((i % side - side * 0.5f) * spacing, 1.f, (i / side - side * 0.5f) * spacing));
+		}
+		m_Camera.SetDistance(side * spacing);
+	}
+
+	void BenchmarkLayer::CreateCarScene(uint32 count)
+	{
+		const uint32 side = static_cast<uint32>(std::ceil(std::sqrt(static_cast<float>(count))));
+		const float spacing = 6.f;
+		for (uint32 i = 0; i < count; i++)
+		{
+			auto car = m_Scene->CreateSkeletalMeshActor<Actor>("assets/models/zero/carSK.fbx", 100 + i, "Car");
+			car->SetTranslation(glm::vec3((i % side - side * 0.5f) * spacing, 0.f, (i / side - side * 0.5f) * spacing));
+		}
+		m_Camera.SetDistance(side * spacing);
+	}
+
+	void BenchmarkLayer::CreateOceanScene(uint32 resolution)
+	{
+		auto ocean = m_Scene->CreateActor<Actor>(100, "Ocean");
+		ocean->AddComponent<OceanComponent>(ocean.Ptr(), resolution);
+	}
+
+	void BenchmarkLayer::CreatePhysicsScene(uint32 count)
+	{
+		SharedRef<PhysicsMaterial> material = PhysicsMaterial::CreateMaterial(5.f, 3.f, 0.1f, 300.f);
+
+		{
+			auto plane = m_Scene->CreateStaticMeshActor<Actor>("assets/models/primitives/Cube.fbx", 99, "Plane",
+															  glm::vec3(3000.f, 1.f, 3000.f));
+			auto planeComponent = plane->GetRootComponent<StaticMeshComponent>();
+			planeComponent->CreatePhysicsBody(PhysicsBodyType::Static, "", material);
+			planeComponent->GetPhysicsBody()->AddBoxPrimitive(glm::vec3(3000.f, 1.f, 3000.f));
+		}
+
+		// Bodies are stacked in layers of 8x8 so they keep colliding for a while
+		const uint32 side = 8;
+		const float spacing = 2.5f;
+		for (uint32 i = 0; i < count; i++)
+		{
+			uint32 layer = i / (side * side);
+			uint32 index = i % (side * side);
+			auto sphere = m_Scene->CreateStaticMeshActor<Actor>("assets/models/primitives/Sphere.fbx", 100 + i, "Body",
+															   glm::vec3(1.f, 1.f, 1.f));
+			sphere->SetTranslation(glm::vec3((index % side - side * 0.5f) * spacing + (layer % 2) * 0.5f,
+											 5.f + layer * spacing, (index / side - side * 0.5f) * spacing));
+			auto sphereComponent = sphere->GetRootComponent<StaticMeshComponent>();
+			sphereComponent->CreatePhysicsBody(PhysicsBodyType::Dynamic, "", material);
+			sphereComponent->GetPhysicsBody()->AddSpherePrimitive(1.f);
+		}
+		m_Camera.SetDistance(side * spacing * 2.f);
+	}
+
+	void BenchmarkLayer::RunJobSystemBenchmark()
+	{
+		std::vector<uint32> threadCounts;
+		if (m_Settings.JobThreads > 0)
+		{
+			threadCounts.push_back(m_Settings.JobThreads);
+		}
+		else
+		{
+			for (uint32 threadCount = 1; threadCount <= 64; threadCount *= 2)
+			{
+				threadCounts.push_back(threadCount);
+			}
+		}
+
+		// Renderer sized its per thread resources for the current thread count, it is restored once the sweep is done
+		const uint32 initialWorkerCount = JobSystem::GetThreadCount() - 1;
+		for (uint32 threadCount : threadCounts)
+		{
+			JobSystem::Shutdown();
+			JobSystem::Initialize(threadCount - 1);
+			RunJobSystemBenchmark(threadCount);
+		}
+		JobSystem::Shutdown();
+		JobSystem::Initialize(initialWorkerCount);
+	}
+
+	void BenchmarkLayer::RunJobSystemBenchmark(uint32 threadCount)
+	{
+		for (uint32 jobCount : {10000u, 100000u, 1000000u})
+		{
+			std::vector<uint64> results(jobCount);
+			uint64* resultsData = results.data();
+
+			uint64 start = Profiler::GetTimestamp();
+			JobCounter counter;
+			for (uint32 i = 0; i < jobCount; i++)
+			{
+				JobSystem::Run([resultsData, i]() { resultsData[i] = TinyJob(i); }, &counter);
+			}
+			JobSystem::Wait(counter);
+			double jobSystemMs = GetElapsedMilliseconds(start);
+
+			double mutexPoolMs = 0.0;
+			{
+				// Calling thread only submits here, so give the pool one thread more to match worker counts
+				MutexThreadPool pool(threadCount);
+				start = Profiler::GetTimestamp();
+				for (uint32 i = 0; i < jobCount; i++)
+				{
+					pool.Push([resultsData, i]() { resultsData[i] = TinyJob(i); });
+				}
+				pool.WaitIdle();
+				mutexPoolMs = GetElapsedMilliseconds(start);
+			}
+
+			std::string suffix = std::to_string(jobCount) + "_" + std::to_string(threadCount) + "t";
+			m_MicroResults.emplace_back("jobSystemMs_" + suffix, jobSystemMs);
+			m_MicroResults.emplace_back("mutexPoolMs_" + suffix, mutexPoolMs);
+			m_MicroResults.emplace_back("jobSystemNsPerJob_" + suffix, jobSystemMs * 1e6 / jobCount);
+			m_MicroResults.emplace_back("mutexPoolNsPerJob_" + suffix, mutexPoolMs * 1e6 / jobCount);
+		}
+	}
+
+	void BenchmarkLayer::RunHdrConversionBenchmark()
+	{
+		// 16k x 8k equirect, 1.5 GiB of RGB32F converted into 1 GiB of RGBA16F
+		const uint32 width = 16384;
+		const uint32 height = 8192;
+		const size_t pixelCount = static_cast<size_t>(width) * height;
+		const size_t rowSize = static_cast<size_t>(width) * 3;
+
+		// Conversion speed does not depend on the values, so one random row is repeated to keep setup short
+		std::vector<float> src(pixelCount * 3);
+		std::mt19937 random(1337);
+		std::uniform_real_distribution<float> distribution(0.f, 64.f);
+		for (size_t i = 0; i < rowSize; i++)
+		{
+			src[i] = distribution(random);
+		}
+		for (uint32 row = 1; row < height; row++)
+		{
+			std::copy_n(src.begin(), rowSize, src.begin() + row * rowSize);
+		}
+		std::vector<uint16> dest(pixelCount * 4);
+
+		// Best of a few runs to filter out page faults and frequency ramp up
+		double singleMs = std::numeric_limits<double>::max();
+		double parallelMs = std::numeric_limits<double>::max();
+		for (uint32 run = 0; run < 5; run++)
+		{
+			uint64 start = Profiler::GetTimestamp();
+			ConvertRGB32FToRGBA16F(src.data(), dest.data(), pixelCount);
+			singleMs = std::min(singleMs, GetElapsedMilliseconds(start));
+
+			start = Profiler::GetTimestamp();
+			ConvertRGB32FToRGBA16FParallel(src.data(), dest.data(), width, height);
+			parallelMs = std::min(parallelMs, GetElapsedMilliseconds(start));
+		}
+
+		const double megabytes = src.size() * sizeof(float) / (1024.0 * 1024.0);
+		m_MicroResults.emplace_back("f16cSupported", IsF16CSupported() ? 1.0 : 0.0);
+		m_MicroResults.emplace_back("singleThreadMBps", megabytes / (singleMs / 1e3));
+		m_MicroResults.emplace_back("parallelMBps", megabytes / (parallelMs / 1e3));
+		m_MicroResults.emplace_back("parallelMBpsPerCore", megabytes / (parallelMs / 1e3) / JobSystem::GetThreadCount());
+	}
+
+	void BenchmarkLayer::RunRefCountBenchmark()
+	{
+		// Many actors sharing few meshes, like instanced scenery
+		const uint32 refCount = 65536;
+		const uint32 meshCount = 16;
+		const uint32 iterations = 200;
+
+		std::vector<PlainRef<PlainRefMesh>> plainMeshes;
+		std::vector<SharedRef<SharedRefMesh>> sharedMeshes;
+		{
+			std::vector<PlainRef<PlainRefMesh>> plainSources;
+			std::vector<SharedRef<SharedRefMesh>> sharedSources;
+			for (uint32 i = 0; i < meshCount; i++)
+			{
+				plainSources.emplace_back(new PlainRefMesh());
+				sharedSources.push_back(SharedRef<SharedRefMesh>::Create());
+			}
+			plainMeshes.reserve(refCount);
+			sharedMeshes.reserve(refCount);
+			for (uint32 i = 0; i < refCount; i++)
+			{
+				plainMeshes.push_back(plainSources[i % meshCount]);
+				sharedMeshes.push_back(sharedSources[i % meshCount]);
+			}
+		}
+
+		const double refsPerRun = static_cast<double>(refCount) * iterations;
+
+		double plainDrawListMs = MeasureDrawListRefs(plainMeshes, iterations);
+		double sharedDrawListMs = MeasureDrawListRefs(sharedMeshes, iterations);
+
+		uint64 start = Profiler::GetTimestamp();
+		for (uint32 iteration = 0; iteration < iterations; iteration++)
+		{
+			s_RefBenchmarkSink.fetch_add(TickRefs(plainMeshes, 0, refCount), std::memory_order_relaxed);
+		}
+		double plainTickMs = GetElapsedMilliseconds(start);
+
+		start = Profiler::GetTimestamp();
+		for (uint32 iteration = 0; iteration < iterations; iteration++)
+		{
+			s_RefBenchmarkSink.fetch_add(TickRefs(sharedMeshes, 0, refCount), std::memory_order_relaxed);
+		}
+		double sharedTickMs = GetElapsedMilliseconds(start);
+
+		// Only possible with atomic counts, every worker touches the same few meshes
+		start = Profiler::GetTimestamp();
+		for (uint32 iteration = 0; iteration < iterations; iteration++)
+		{
+			JobSystem::ParallelFor(refCount, [&sharedMeshes](uint32 begin, uint32 end) {
+				s_RefBenchmarkSink.fetch_add(TickRefs(sharedMeshes, begin, end), std::memory_order_relaxed);
+			});
+		}
+		double sharedParallelTickMs = GetElapsedMilliseconds(start);
+
+		m_MicroResults.emplace_back("drawListPlainNsPerRef", plainDrawListMs * 1e6 / refsPerRun);
+		m_MicroResults.emplace_back("drawListAtomicNsPerRef", sharedDrawListMs * 1e6 / refsPerRun);
+		m_MicroResults.emplace_back("tickPlainNsPerRef", plainTickMs * 1e6 / refsPerRun);
+		m_MicroResults.emplace_back("tickAtomicNsPerRef", sharedTickMs * 1e6 / refsPerRun);
+		m_MicroResults.emplace_back("tickAtomicParallelNsPerRef", sharedParallelTickMs * 1e6 / refsPerRun);
+	}
+
+	void BenchmarkLayer::RunShaderParamBenchmark()
+	{
+		// Per draw camera update, alternating data so every call has to copy like changing model matrices do
+		ShaderSpecification shaderSpecification;
+		shaderSpecification.ShaderPaths[ShaderType::Vertex] = "assets/shaders/Skybox_Vert.glsl";
+		shaderSpecification.ShaderPaths[ShaderType::Fragment] = "assets/shaders/Skybox_Frag.glsl";
+		shaderSpecification.VBLayout = std::vector<VertexBufferElement>{{ShaderDataType::Float2}};
+		SharedRef<Shader> shader = Shader::Create(shaderSpecification);
+
+		const uint32 setCount = 1000000;
+		const glm::mat4 cameraData[2] = {glm::mat4(1.f), glm::mat4(2.f)};
+
+		// A string literal is interned on every call
+		uint64 start = Profiler::GetTimestamp();
+		for (uint32 i = 0; i < setCount; i++)
+		{
+			shader->SetUniformBuffer("SkyboxUBO", 0, &cameraData[i & 1]);
+		}
+		double literalMs = GetElapsedMilliseconds(start);
+
+		const ShaderParamHandle skyboxUBO("SkyboxUBO");
+		start = Profiler::GetTimestamp();
+		for (uint32 i = 0; i < setCount; i++)
+		{
+			shader->SetUniformBuffer(skyboxUBO, 0, &cameraData[i & 1]);
+		}
+		double handleMs = GetElapsedMilliseconds(start);
+
+		m_MicroResults.emplace_back("setUniformLiteralNsPerCall", literalMs * 1e6 / setCount);
+		m_MicroResults.emplace_back("setUniformHandleNsPerCall", handleMs * 1e6 / setCount);
+	}
+
+	void BenchmarkLayer::WriteResults() const
+	{
+		std::ofstream out(m_Settings.OutputPath);
+		if (!out)
+		{
+			NEO_ERROR("Failed to open {0} for writing benchmark results", m_Settings.OutputPath);
+			return;
+		}
+
+		out << std::fixed << std::setprecision(4);
+		out << "{\n";
+		out << "\t\"scene\": ";
+		WriteJsonString(out, m_Settings.Scene);
+		out << ",\n\t\"count\": " << m_Settings.Count;
+		out << ",\n\t\"instancing\": " << (m_Settings.Instancing ? "true" : "false");
+		out << ",\n\t\"parallelRecording\": " << (m_Settings.ParallelRecording ? "true" : "false");
+		out << ",\n\t\"culling\": ";
+		WriteJsonString(out, m_Settings.Culling);
+		out << ",\n\t\"device\": ";
+		WriteJsonString(out, RendererAPI::GetCapabilities().Vendor);
+		out << ",\n\t\"jobThreads\": " << JobSystem::GetThreadCount();
+		out << ",\n\t\"physicsThreads\": " << Physics::GetSettings().WorkerThreads;
+
+		if (m_Settings.IsMicroBenchmark())
+		{
+			out << ",\n\t\"results\": {";
+			for (size_t i = 0; i < m_MicroResults.size(); i++)
+			{
+				out << (i == 0 ? "\n\t\t" : ",\n\t\t");
+				WriteJsonString(out, m_MicroResults[i].first);
+				out << ": " << m_MicroResults[i].second;
+			}
+			out << "\n\t}";
+		}
+		else
+		{
+			out << ",\n\t\"warmupFrames\": " << m_Settings.WarmupFrames;
+			out << ",\n\t\"frames\": " << m_FrameTimes.size();
+			out << ",\n\t\"fixedTimestep\": " << m_Settings.FixedTimestep;
+			out << ",\n\t\"loadTimeMs\": " << m_LoadMilliseconds;
+
+			std::vector<double> sortedFrameTimes = m_FrameTimes;
+			std::sort(sortedFrameTimes.begin(), sortedFrameTimes.end());
+			double totalMs = 0.0;
+			for (double frameTime : sortedFrameTimes)
+			{
+				totalMs += frameTime;
+			}
+			const double frameCount = std::max<double>(1.0, static_cast<double>(sortedFrameTimes.size()));
+
+			out << ",\n\t\"frameTimeMs\": {";
+			out << "\n\t\t\"mean\": " << totalMs / frameCount;
+			out << ",\n\t\t\"p50\": " << GetPercentile(sortedFrameTimes, 50.0);
+			out << ",\n\t\t\"p95\": " << GetPercentile(sortedFrameTimes, 95.0);
+			out << ",\n\t\t\"p99\": " << GetPercentile(sortedFrameTimes, 99.0);
+			out << ",\n\t\t\"max\": " << (sortedFrameTimes.empty() ? 0.0 : sortedFrameTimes.back());
+			out << "\n\t}";
+
+			// Mean time per frame of every CPU zone, summed by name across threads. GPU tracks are reported below.
+			std::map<std::string, double> cpuStageTotals;
+			uint32 frameZoneCount = 0;
+			for (const ProfileTrack& track : Profiler::CaptureZones(m_MeasureStart))
+			{
+				for (const ProfileZone& zone : track.Zones)
+				{
+					if (zone.Start < m_MeasureStart || !zone.Name || (zone.Category && strcmp(zone.Category, "GPU") == 0))
+					{
+						continue;
+					}
+					cpuStageTotals[zone.Name] += (zone.End - zone.Start) / 1e6;
+					frameZoneCount += strcmp(zone.Name, "Frame") == 0 ? 1 : 0;
+				}
+			}
+			if (frameZoneCount < m_FrameTimes.size())
+			{
+				NEO_WARN("Profiler zones of {0} frames were overwritten, CPU stage times are incomplete",
+						 m_FrameTimes.size() - frameZoneCount);
+			}
+
+			out << ",\n\t\"cpuStagesMs\": {";
+			bool first = true;
+			for (const auto& [name, total] : cpuStageTotals)
+			{
+				out << (first ? "\n\t\t" : ",\n\t\t");
+				WriteJsonString(out, name);
+				out << ": " << total / frameCount;
+				first = false;
+			}
+			out << "\n\t}";
+
+			out << ",\n\t\"gpuStagesMs\": {";
+			first = true;
+			for (const auto& [name, total] : m_GpuStageTotals)
+			{
+				out << (first ? "\n\t\t" : ",\n\t\t");
+				WriteJsonString(out, name);
+				out << ": " << total / frameCount;
+				first = false;
+			}
+			out << "\n\t}";
+
+			// Recorded by the scene render passes, the GUI does not go through the command buffer API
+			out << ",\n\t\"commandsPerFrame\": {";
+			out << "\n\t\t\"drawCalls\": " << m_CommandTotals.DrawCalls / frameCount;
+			out << ",\n\t\t\"instances\": " << m_CommandTotals.Instances / frameCount;
+			out << ",\n\t\t\"pipelineBinds\": " << m_CommandTotals.PipelineBinds / frameCount;
+			out << ",\n\t\t\"descriptorSetBinds\": " << m_CommandTotals.DescriptorSetBinds / frameCount;
+			out << ",\n\t\t\"vertexBufferBinds\": " << m_CommandTotals.VertexBufferBinds / frameCount;
+			out << ",\n\t\t\"indexBufferBinds\": " << m_CommandTotals.IndexBufferBinds / frameCount;
+			out << ",\n\t\t\"skippedBinds\": " << m_CommandTotals.SkippedBinds / frameCount;
+			out << ",\n\t\t\"droppedDraws\": " << m_CommandTotals.DroppedDraws / frameCount;
+			out << "\n\t}";
+
+			// GPU culled instances are counted when their results are read back, a few frames after recording
+			out << ",\n\t\"cullingPerFrame\": {";
+			out << "\n\t\t\"testedInstances\": " << m_CulledTestedTotal / frameCount;
+			out << ",\n\t\t\"visibleInstances\": " << m_CulledVisibleTotal / frameCount;
+			out << ",\n\t\t\"culledInstances\": " << (m_CulledTestedTotal - m_CulledVisibleTotal) / frameCount;
+			out << ",\n\t\t\"gpuTestedInstances\": " << m_GpuCulledTestedTotal / frameCount;
+			out << ",\n\t\t\"gpuCulledInstances\": " << (m_GpuCulledTestedTotal - m_GpuCulledVisibleTotal) / frameCount;
+			out << ",\n\t\t\"testedSubmeshes\": " << m_CulledSubmeshTestedTotal / frameCount;
+			out << ",\n\t\t\"culledSubmeshes\": " << (m_CulledSubmeshTestedTotal - m_CulledSubmeshVisibleTotal) / frameCount;
+			out << "\n\t}";
+		}
+
+		PROCESS_MEMORY_COUNTERS memoryCounters = {};
+		GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters));
+		out << ",\n\t\"memory\": {";
+		out << "\n\t\t\"peakWorkingSetBytes\": " << memoryCounters.PeakWorkingSetSize;
+		out << ",\n\t\t\"peakPagefileBytes\": " << memoryCounters.PeakPagefileUsage;
+		// Live GPU allocations by tag when the results are written, e.g. per shader buffers under "Shader"
+		for (const GpuMemoryTag& tag : RendererContext::Get()->GetMemoryStats().Tags)
+		{
+			out << ",\n\t\t";
+			WriteJsonString(out, "gpu" + tag.Name + "Bytes");
+			out << ": " << tag.Bytes;
+		}
+		out << "\n\t}";
+		out << "\n}\n";
+
+		NEO_INFO("Benchmark results written to {0}", m_Settings.OutputPath);
+	}
+} // namespace Neon
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <Neon/Core/Application.h>
+#include <Neon/Core/Layer.h>
+#include <Neon/Editor/EditorCamera.h>
+#include <Neon/Renderer/CommandBuffer.h>
+#include <Neon/Scene/Scene.h>
+
+namespace Neon
+{
+	struct BenchmarkSettings
+	{
+		// static, cars, ocean, physics, jobs, hdr, refs or params
+		std::string Scene = "static";
+		// Number of meshes, cars or bodies, ocean resolution for the ocean scene. 0 picks a per scene default.
+		uint32 Count = 0;
+		uint32 WarmupFrames = 60;
+		uint32 Frames = 600;
+		float FixedTimestep = 1.f / 60.f;
+		// PhysX worker count, 0 uses every job system thread
+		uint32 PhysicsThreads = 0;
+		// Job system threads of the jobs scene, main thread included. 0 sweeps 1 to 64 threads.
+		uint32 JobThreads = 0;
+		std::string OutputPath = "benchmark.json";
+		// Disabled to get the one draw per mesh baseline
+		bool Instancing = true;
+		// Disabled to record the geometry pass on the main thread only
+		bool ParallelRecording = true;
+		// none, cpu or gpu frustum culling
+		std::string Culling = "gpu";
+
+		// Recognizes --scene, --count, --warmup, --frames, --timestep, --physics-threads, --job-threads, --output,
+		// --culling, --no-instancing and --serial-recording
+		void ParseCommandLine(const ApplicationCommandLineArgs& args);
+
+		// Frame based scenes run warmup + measured frames, micro benchmarks run inside a single frame
+		bool IsMicroBenchmark() const
+		{
+			return Scene == "jobs" || Scene == "hdr" || Scene == "refs" || Scene == "params";
+		}
+	};
+
+	// Runs one scripted scene or micro benchmark and writes the results as JSON when detached
+	class BenchmarkLayer : public Layer
+	{
+	public:
+		BenchmarkLayer(const BenchmarkSettings& settings);
+
+		void OnAttach() override;
+		void OnDetach() override;
+
+		void Update(float deltaSeconds) override;
+		void Tick(float deltaSeconds) override;
+		void OnRenderGui() override
+		{
+		}
+		void OnEvent(Event& e) override
+		{
+		}
+		void OnFrameTasks(TaskGraph& taskGraph, const FrameTasks& frameTasks) override;
+
+	private:
+		void CreateStaticMeshScene(uint32 count);
+		void CreateCarScene(uint32 count);
+		void CreateOceanScene(uint32 resolution);
+		void CreatePhysicsScene(uint32 count);
+
+		void RunJobSystemBenchmark();
+		void RunJobSystemBenchmark(uint32 threadCount);
+		void RunHdrConversionBenchmark();
+		void RunRefCountBenchmark();
+		void RunShaderParamBenchmark();
+
+		void WriteResults() const;
+
+	private:
+		BenchmarkSettings m_Settings;
+
+		SharedRef<Scene> m_Scene;
+		EditorCamera m_Camera;
+
+		double m_LoadMilliseconds = 0.0;
+		uint32 m_FrameIndex = 0;
+		uint64 m_MeasureStart = 0;
+		std::vector<double> m_FrameTimes;
+		std::map<std::string, double> m_GpuStageTotals;
+		// Summed over measured frames
+		CommandBufferStats m_CommandTotals;
+		uint64 m_CulledTestedTotal = 0;
+		uint64 m_CulledVisibleTotal = 0;
+		uint64 m_GpuCulledTestedTotal = 0;
+		uint64 m_GpuCulledVisibleTotal = 0;
+		uint64 m_CulledSubmeshTestedTotal = 0;
+		uint64 m_CulledSubmeshVisibleTotal = 0;
+
+		// Micro benchmark results, written as is
+		std::vector<std::pair<std::string, double>> m_MicroResults;
+	};
+} // namespace Neon
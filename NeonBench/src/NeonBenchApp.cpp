@@ -0,0 +1,33 @@
+#include "BenchmarkLayer.h"
+
+#include <Neon/Core/EntryPoint.h>
+#include <Neon/Physics/Physics.h>
+
+class NeonBenchApp : public Neon::Application
+{
+public:
+	NeonBenchApp(const Neon::ApplicationProps& props, const Neon::BenchmarkSettings& settings)
+		: Neon::Application(props)
+	{
+		PushLayer(new Neon::BenchmarkLayer(settings));
+	}
+
+	~NeonBenchApp() = default;
+};
+
+Neon::Application* Neon::CreateApplication(ApplicationCommandLineArgs args)
+{
+	BenchmarkSettings settings;
+	settings.ParseCommandLine(args);
+
+	// Fixed timestep and frame count keep runs comparable across commits, --headless is implied
+	ApplicationProps props("Neon Bench");
+	props.Headless = true;
+	props.FixedTimestep = settings.FixedTimestep;
+	props.FrameCount = settings.IsMicroBenchmark() ? 1 : settings.WarmupFrames + settings.Frames + 1;
+
+	// Has to be set before the application initializes physics
+	Physics::GetSettings().WorkerThreads = settings.PhysicsThreads;
+
+	return new NeonBenchApp(props, settings);
+}
@@ -12,8 +12,8 @@ const float Epsilon = 0.00001;
 const uint NumSamples = 64 * 1024;
 const float InvNumSamples = 1.0 / float(NumSamples);
 
-layout (binding = 0) uniform samplerCube u_InputCubemap;
-layout (binding = 1, rgba16f) restrict writeonly uniform imageCube o_OutputCubemap;
+layout (set = 1, binding = 0) uniform samplerCube u_InputCubemap;
+layout (set = 1, binding = 1, rgba16f) restrict writeonly uniform imageCube o_OutputCubemap;
 
 // Compute Van der Corput radical inverse
 // See: http://holger.dammertz.org/stuff/notes_HammersleyOnHemisphere.html
@@ -11,8 +11,8 @@ const float Epsilon = 0.00001;
 const uint NumSamples = 1024;
 const float InvNumSamples = 1.0 / float(NumSamples);
 
-layout (binding = 0) uniform samplerCube u_InputCubemap;
-layout (binding = 1, rgba16f) restrict writeonly uniform imageCube o_OutputCubemap;
+layout (set = 1, binding = 0) uniform samplerCube u_InputCubemap;
+layout (set = 1, binding = 1, rgba16f) restrict writeonly uniform imageCube o_OutputCubemap;
 
 layout (push_constant) uniform MipLevelPC
 {
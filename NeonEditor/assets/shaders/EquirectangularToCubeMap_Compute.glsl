@@ -4,8 +4,8 @@
 
 const float PI = 3.141592;
 
-layout (binding = 0) uniform sampler2D u_EquirectangularTex;
-layout (binding = 1, rgba16f) restrict writeonly uniform imageCube o_CubeMap;
+layout (set = 1, binding = 0) uniform sampler2D u_EquirectangularTex;
+layout (set = 1, binding = 1, rgba16f) restrict writeonly uniform imageCube o_CubeMap;
 
 vec3 GetCubeMapTexCoord()
 {
@@ -0,0 +1,110 @@
+#version 450 core
+
+// Culls instance bounding spheres against the camera frustum and compacts the visible transforms of every group, one
+// group per instanced mesh. The draw commands of a group get the visible instance count, the group count slot the
+// number of commands to draw, or 0 when nothing is visible.
+
+struct CullInstance
+{
+	mat4 Transform;
+	// Object space, center in xyz and radius in w
+	vec4 BoundingSphere;
+	uvec4 Group;
+};
+
+struct CullGroup
+{
+	uint FirstInstance;
+	uint FirstCommand;
+	uint CommandCount;
+	uint Padding;
+};
+
+// Same layout as VkDrawIndexedIndirectCommand
+struct DrawCommand
+{
+	uint IndexCount;
+	uint InstanceCount;
+	uint FirstIndex;
+	int VertexOffset;
+	uint FirstInstance;
+};
+
+layout (std430, set = 1, binding = 0) readonly buffer CullInstances
+{
+	CullInstance u_Instances[];
+};
+
+layout (std430, set = 1, binding = 1) readonly buffer CullGroups
+{
+	CullGroup u_Groups[];
+};
+
+layout (std430, set = 1, binding = 2) buffer DrawCommands
+{
+	DrawCommand u_Commands[];
+};
+
+// Visible instances, tested instances, two unused slots, then one draw count per group
+layout (std430, set = 1, binding = 3) buffer DrawCounts
+{
+	uint u_Counts[];
+};
+
+layout (std430, set = 1, binding = 4) writeonly buffer VisibleTransforms
+{
+	mat4 u_VisibleTransforms[];
+};
+
+layout (push_constant) uniform CullParams
+{
+	vec4 FrustumPlanes[6];
+	uint InstanceCount;
+} u_PushConstant;
+
+const uint GroupCountsOffset = 4;
+
+layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+void main()
+{
+	uint index = gl_GlobalInvocationID.x;
+	if (index >= u_PushConstant.InstanceCount)
+	{
+		return;
+	}
+
+	mat4 transform = u_Instances[index].Transform;
+	vec4 sphere = u_Instances[index].BoundingSphere;
+
+	vec3 center = (transform * vec4(sphere.xyz, 1.0)).xyz;
+	float scale = sqrt(max(max(dot(transform[0].xyz, transform[0].xyz), dot(transform[1].xyz, transform[1].xyz)),
+						   dot(transform[2].xyz, transform[2].xyz)));
+	float radius = sphere.w * scale;
+
+	for (int i = 0; i < 6; i++)
+	{
+		vec4 plane = u_PushConstant.FrustumPlanes[i];
+		if (dot(plane.xyz, center) + plane.w < -radius)
+		{
+			return;
+		}
+	}
+
+	atomicAdd(u_Counts[0], 1);
+
+	uint groupIndex = u_Instances[index].Group.x;
+	CullGroup group = u_Groups[groupIndex];
+
+	// Every submesh command of the group draws the same instances
+	uint slot = atomicAdd(u_Commands[group.FirstCommand].InstanceCount, 1);
+	for (uint i = 1; i < group.CommandCount; i++)
+	{
+		atomicAdd(u_Commands[group.FirstCommand + i].InstanceCount, 1);
+	}
+	u_VisibleTransforms[group.FirstInstance + slot] = transform;
+
+	if (slot == 0)
+	{
+		u_Counts[GroupCountsOffset + groupIndex] = group.CommandCount;
+	}
+}
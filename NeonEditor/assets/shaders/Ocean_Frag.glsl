@@ -18,20 +18,19 @@ struct Light
 	vec4 Radiance;
 };
 
-layout (std140, binding = 0) uniform CameraUBO
+layout (std140, set = 0, binding = 0) uniform CameraUBO
 {
-    mat4 u_Model;
     mat4 u_ViewProjection;
     vec4 u_CameraPosition;
 };
 
-layout (std140, binding = 10) uniform LightUBO
+layout (std140, set = 0, binding = 1) uniform LightUBO
 {
 	uint u_Count;
 	Light u_Lights[MAX_LIGHT_COUNT];
 };
 
-layout (binding = 11) uniform samplerCube u_EnvRadianceTex;
+layout (set = 1, binding = 11) uniform samplerCube u_EnvRadianceTex;
 
 void main()
 {
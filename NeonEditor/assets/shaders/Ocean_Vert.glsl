@@ -7,25 +7,29 @@ layout (location = 1) out vec3 v_WorldPosition;
 layout (location = 2) out float v_J;
 layout (location = 3) out vec3 v_Foam;
 
-layout (std140, binding = 0) uniform CameraUBO
+layout (std140, set = 0, binding = 0) uniform CameraUBO
 {
-    mat4 u_Model;
     mat4 u_ViewProjection;
     vec4 u_CameraPosition;
 };
 
-layout (std140, binding = 1) uniform PropertiesUBO
+layout (push_constant) uniform ModelPC
+{
+    mat4 u_Model;
+};
+
+layout (std140, set = 1, binding = 1) uniform PropertiesUBO
 {
     float u_L;
 };
 
-layout (binding = 2) uniform sampler2D u_DisplacementY;
-layout (binding = 3) uniform sampler2D u_DisplacementX;
-layout (binding = 4) uniform sampler2D u_DisplacementZ;
-layout (binding = 5) uniform sampler2D u_DerivativesYX;
-layout (binding = 6) uniform sampler2D u_DerivativesYZ;
-layout (binding = 7) uniform sampler2D u_Jacobian;
-layout (binding = 8) uniform sampler2D u_Foam;
+layout (set = 1, binding = 2) uniform sampler2D u_DisplacementY;
+layout (set = 1, binding = 3) uniform sampler2D u_DisplacementX;
+layout (set = 1, binding = 4) uniform sampler2D u_DisplacementZ;
+layout (set = 1, binding = 5) uniform sampler2D u_DerivativesYX;
+layout (set = 1, binding = 6) uniform sampler2D u_DerivativesYZ;
+layout (set = 1, binding = 7) uniform sampler2D u_Jacobian;
+layout (set = 1, binding = 8) uniform sampler2D u_Foam;
 
 void main()
 {
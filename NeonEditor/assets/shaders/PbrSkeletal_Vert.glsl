@@ -17,14 +17,18 @@ layout (location = 2) out vec2 v_TexCoord;
 layout (location = 3) flat out uint v_MaterialIndex;
 layout (location = 4) out mat3 v_WorldNormals;
 
-layout (std140, binding = 0) uniform CameraUBO
+layout (std140, set = 0, binding = 0) uniform CameraUBO
 {
-    mat4 u_Model;
     mat4 u_ViewProjection;
     vec4 u_CameraPosition;
 };
 
-layout (std140, binding = 1) readonly buffer BonesUBO
+layout (push_constant) uniform ModelPC
+{
+    mat4 u_Model;
+};
+
+layout (std140, set = 1, binding = 1) readonly buffer BonesUBO
 {
     mat4 u_BoneTransforms[];
 };
@@ -19,20 +19,19 @@ layout (location = 4) in mat3 v_WorldNormals;
 
 layout (location = 0) out vec4 o_Color;
 
-layout (std140, binding = 0) uniform CameraUBO
+layout (std140, set = 0, binding = 0) uniform CameraUBO
 {
-    mat4 u_Model;
     mat4 u_ViewProjection;
     vec4 u_CameraPosition;
 };
 
-layout (std140, binding = 2) uniform LightUBO
+layout (std140, set = 0, binding = 1) uniform LightUBO
 {
 	uint u_Count;
 	Light u_Lights[MAX_LIGHT_COUNT];
 };
 
-layout (std140, binding = 3) uniform MaterialUBO
+layout (std140, set = 1, binding = 3) uniform MaterialUBO
 {
     vec4 AlbedoColor;
 	float UseAlbedoMap;
@@ -44,17 +43,17 @@ layout (std140, binding = 3) uniform MaterialUBO
 } u_Materials[];
 
 // Material textures
-layout (binding = 4) uniform sampler2D u_AlbedoTextures[];
-layout (binding = 5) uniform sampler2D u_NormalTextures[];
-layout (binding = 6) uniform sampler2D u_RoughnessTextures[];
-layout (binding = 7) uniform sampler2D u_MetalnessTextures[];
+layout (set = 1, binding = 4) uniform sampler2D u_AlbedoTextures[];
+layout (set = 1, binding = 5) uniform sampler2D u_NormalTextures[];
+layout (set = 1, binding = 6) uniform sampler2D u_RoughnessTextures[];
+layout (set = 1, binding = 7) uniform sampler2D u_MetalnessTextures[];
 
 // Environment maps
-layout (binding = 8) uniform samplerCube u_EnvRadianceTex;
-layout (binding = 9) uniform samplerCube u_EnvIrradianceTex;
+layout (set = 1, binding = 8) uniform samplerCube u_EnvRadianceTex;
+layout (set = 1, binding = 9) uniform samplerCube u_EnvIrradianceTex;
 
 // BRDF LUT
-layout (binding = 10) uniform sampler2D u_BRDFLUTTexture;
+layout (set = 1, binding = 10) uniform sampler2D u_BRDFLUTTexture;
 
 const float PI = 3.141592;
 const float Gamma = 2.2;
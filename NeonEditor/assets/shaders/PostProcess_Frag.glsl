@@ -4,7 +4,7 @@ layout (location = 0) out vec4 o_Color;
 
 layout (location = 0) in vec2 v_TexCoord;
 
-layout (binding = 0) uniform sampler2D u_Texture;
+layout (set = 1, binding = 0) uniform sampler2D u_Texture;
 
 void main()
 {
@@ -2,7 +2,7 @@
 
 layout (location = 0) out vec4 o_Color;
 
-layout (binding = 1) uniform samplerCube u_Cubemap;
+layout (set = 1, binding = 1) uniform samplerCube u_Cubemap;
 
 layout (location = 0) in vec3 v_Position;
 
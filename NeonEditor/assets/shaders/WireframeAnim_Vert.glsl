@@ -11,14 +11,18 @@ layout (location = 5) in vec2 a_TexCoord;
 layout (location = 6) in uint a_BoneIds[MAX_BONES_PER_VERTEX];
 layout (location = 6 + MAX_BONES_PER_VERTEX) in float a_BoneWeights[MAX_BONES_PER_VERTEX];
 
-layout (std140, binding = 0) uniform CameraUBO
+layout (std140, set = 0, binding = 0) uniform CameraUBO
 {
-    mat4 u_Model;
     mat4 u_ViewProjection;
     vec4 u_CameraPosition;
 };
 
-layout (std140, binding = 1) readonly buffer BonesUBO
+layout (push_constant) uniform ModelPC
+{
+    mat4 u_Model;
+};
+
+layout (std140, set = 1, binding = 1) readonly buffer BonesUBO
 {
     mat4 u_BoneTransforms[];
 };
@@ -7,13 +7,17 @@ layout (location = 3) in vec3 a_Binormal;
 layout (location = 4) in uint a_MaterialIndex;
 layout (location = 5) in vec2 a_TexCoord;
 
-layout (std140, binding = 0) uniform CameraUBO
+layout (std140, set = 0, binding = 0) uniform CameraUBO
 {
-    mat4 u_Model;
     mat4 u_ViewProjection;
     vec4 u_CameraPosition;
 };
 
+layout (push_constant) uniform ModelPC
+{
+    mat4 u_Model;
+};
+
 void main()
 {
     vec4 worldPosition = u_Model * vec4(a_Position, 1.0);
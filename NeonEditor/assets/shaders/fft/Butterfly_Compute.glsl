@@ -1,10 +1,10 @@
 #version 450 core
 
-layout (binding = 0, rgba32f) readonly uniform image2D m_TwiddleFactors;
+layout (set = 1, binding = 0, rgba32f) readonly uniform image2D m_TwiddleFactors;
 
-layout (binding = 1, rgba32f) uniform image2D u_PingPong[16];
+layout (set = 1, binding = 1, rgba32f) uniform image2D u_PingPong[16];
 
-layout (std140, binding = 2) uniform PropertiesUBO
+layout (std140, set = 1, binding = 2) uniform PropertiesUBO
 {
 	uint u_Stage;
 	uint u_PingPongIndex;
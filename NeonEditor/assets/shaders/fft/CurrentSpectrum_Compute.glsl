@@ -2,24 +2,24 @@
 
 #define PI 3.1415926535897932384626433832795
 
-layout (binding = 0, rgba32f) writeonly uniform image2D u_HktDy; // height displacement
-layout (binding = 1, rgba32f) writeonly uniform image2D u_HktDx; // x displacement
-layout (binding = 2, rgba32f) writeonly uniform image2D u_HktDz; // z displacement
-layout (binding = 3, rgba32f) writeonly uniform image2D u_HktDyDx; // dHktDy / dx
-layout (binding = 4, rgba32f) writeonly uniform image2D u_HktDyDz; // dHktDy / dz
-layout (binding = 5, rgba32f) writeonly uniform image2D u_HktDxDx; // dHktDx / dx
-layout (binding = 6, rgba32f) writeonly uniform image2D u_HktDzDz; // dHktDz / dz
-layout (binding = 7, rgba32f) writeonly uniform image2D u_HktDxDz; // dHktDx / dz
-
-layout (binding = 8, rgba32f) readonly uniform image2D u_H0k;
-
-layout (std140, binding = 9) uniform PropertiesUBO
+layout (set = 1, binding = 0, rgba32f) writeonly uniform image2D u_HktDy; // height displacement
+layout (set = 1, binding = 1, rgba32f) writeonly uniform image2D u_HktDx; // x displacement
+layout (set = 1, binding = 2, rgba32f) writeonly uniform image2D u_HktDz; // z displacement
+layout (set = 1, binding = 3, rgba32f) writeonly uniform image2D u_HktDyDx; // dHktDy / dx
+layout (set = 1, binding = 4, rgba32f) writeonly uniform image2D u_HktDyDz; // dHktDy / dz
+layout (set = 1, binding = 5, rgba32f) writeonly uniform image2D u_HktDxDx; // dHktDx / dx
+layout (set = 1, binding = 6, rgba32f) writeonly uniform image2D u_HktDzDz; // dHktDz / dz
+layout (set = 1, binding = 7, rgba32f) writeonly uniform image2D u_HktDxDz; // dHktDx / dz
+
+layout (set = 1, binding = 8, rgba32f) readonly uniform image2D u_H0k;
+
+layout (std140, set = 1, binding = 9) uniform PropertiesUBO
 {
 	uint u_N;
 	float u_L;
 };
 
-layout (std140, binding = 10) uniform TimeUBO
+layout (std140, set = 1, binding = 10) uniform TimeUBO
 {
     float u_Time;
 };
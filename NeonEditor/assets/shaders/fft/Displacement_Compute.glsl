@@ -1,10 +1,10 @@
 #version 450 core
 
-layout (binding = 0, rgba32f) uniform writeonly image2D u_Result[8];
+layout (set = 1, binding = 0, rgba32f) uniform writeonly image2D u_Result[8];
 
-layout (binding = 1, rgba32f) uniform readonly image2D u_ButterflyResult[8];
+layout (set = 1, binding = 1, rgba32f) uniform readonly image2D u_ButterflyResult[8];
 
-layout (std140, binding = 2) uniform PropertiesUBO
+layout (std140, set = 1, binding = 2) uniform PropertiesUBO
 {
 	int u_N;
 };
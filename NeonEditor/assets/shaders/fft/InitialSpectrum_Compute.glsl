@@ -2,14 +2,14 @@
 
 #define PI 3.1415926535897932384626433832795
 
-layout (binding = 0, rgba32f) writeonly uniform image2D u_H0k;
+layout (set = 1, binding = 0, rgba32f) writeonly uniform image2D u_H0k;
 
-layout (binding = 2) uniform sampler2D u_Noise0;
-layout (binding = 3) uniform sampler2D u_Noise1;
-layout (binding = 4) uniform sampler2D u_Noise2;
-layout (binding = 5) uniform sampler2D u_Noise3;
+layout (set = 1, binding = 2) uniform sampler2D u_Noise0;
+layout (set = 1, binding = 3) uniform sampler2D u_Noise1;
+layout (set = 1, binding = 4) uniform sampler2D u_Noise2;
+layout (set = 1, binding = 5) uniform sampler2D u_Noise3;
 
-layout (std140, binding = 6) uniform PropertiesUBO
+layout (std140, set = 1, binding = 6) uniform PropertiesUBO
 {
 	uint u_N;
 	float u_L;
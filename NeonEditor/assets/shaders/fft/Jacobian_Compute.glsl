@@ -1,10 +1,10 @@
 #version 450 core
 
-layout (binding = 0, rgba32f) readonly uniform image2D u_DerivativesXX;
-layout (binding = 1, rgba32f) readonly uniform image2D u_DerivativesZZ;
-layout (binding = 2, rgba32f) readonly uniform image2D u_DerivativesXZ;
+layout (set = 1, binding = 0, rgba32f) readonly uniform image2D u_DerivativesXX;
+layout (set = 1, binding = 1, rgba32f) readonly uniform image2D u_DerivativesZZ;
+layout (set = 1, binding = 2, rgba32f) readonly uniform image2D u_DerivativesXZ;
 
-layout (binding = 3, rgba32f) writeonly uniform image2D u_Result;
+layout (set = 1, binding = 3, rgba32f) writeonly uniform image2D u_Result;
 
 layout (local_size_x = 32, local_size_y = 32, local_size_z = 1) in;
 void main()
@@ -2,14 +2,14 @@
 
 #define PI 3.1415926535897932384626433832795
 
-layout (binding = 0, rgba32f) writeonly uniform image2D u_TwiddleFactors;
+layout (set = 1, binding = 0, rgba32f) writeonly uniform image2D u_TwiddleFactors;
 
-layout (std430, binding = 1) buffer BitReversedUBO
+layout (std430, set = 1, binding = 1) buffer BitReversedUBO
 {
 	uint u_BitsReversed[];
 };
 
-layout (std140, binding = 2) uniform PropertiesUBO
+layout (std140, set = 1, binding = 2) uniform PropertiesUBO
 {
 	uint u_N;
 };
@@ -2,9 +2,11 @@
 
 #include "EditorLayer.h"
 
+#include <Neon/Core/Application.h>
 #include <Neon/Core/Event/KeyEvent.h>
 #include <Neon/Editor/Panels/ContentBrowserPanel.h>
 #include <Neon/Editor/Panels/InspectorPanel.h>
+#include <Neon/Editor/Panels/ProfilerPanel.h>
 #include <Neon/Editor/Panels/SceneHierarchyPanel.h>
 #include <Neon/Editor/Panels/SceneRendererPanel.h>
 #include <Neon/Physics/Physics.h>
@@ -90,6 +92,7 @@ namespace Neon
 		m_Panels.emplace_back(SharedRef<InspectorPanel>::Create());
 		m_Panels.emplace_back(SharedRef<ContentBrowserPanel>::Create());
 		m_Panels.emplace_back(SharedRef<SceneRendererPanel>::Create());
+		m_Panels.emplace_back(SharedRef<ProfilerPanel>::Create());
 	}
 
 	void EditorLayer::OnAttach()
@@ -98,23 +101,19 @@ namespace Neon
 		m_StopButtonTex = Texture2D::Create("assets/editor/StopButton.png", {TextureUsageFlagBits::ShaderRead});
 
 		s_ActiveCamera = &m_EditorCamera;
+
+		// Viewport panel resizes the camera every frame, headless runs never draw it and render at window size
+		auto [width, height] = Application::Get().GetWindow().GetSize();
+		m_EditorCamera.SetViewportSize(width, height);
+		s_CameraComp->SetViewportSize(width, height);
 	}
 
 	void EditorLayer::OnDetach()
 	{
 	}
 
-	void EditorLayer::Tick(float deltaSeconds)
+	void EditorLayer::Update(float deltaSeconds)
 	{
-		if (m_SceneState == SceneState::Edit)
-		{
-			s_ActiveCamera = &m_EditorCamera;
-		}
-		else
-		{
-			s_ActiveCamera = s_CameraComp.Ptr();
-		}
-
 		m_Times.push(deltaSeconds * 1000.f);
 		m_TimePassed += deltaSeconds * 1000.f;
 		m_FrameCount++;
@@ -130,8 +129,6 @@ namespace Neon
 		{
 			possesedPawn->ProcessInput(m_CachedInput);
 		}
-		
-		m_EditorCamera.Tick(deltaSeconds);
 
 		SceneRenderer::BeginScene(s_ActiveCamera);
 		m_EditorScene->TickScene(deltaSeconds);
@@ -140,6 +137,32 @@ namespace Neon
 		m_CachedInput.clear();
 	}
 
+	void EditorLayer::Tick(float deltaSeconds)
+	{
+		SceneRenderer::RenderScene();
+	}
+
+	void EditorLayer::OnFrameTasks(TaskGraph& taskGraph, const FrameTasks& frameTasks)
+	{
+		// Camera input polls the window, so it is handled on the main thread before the scene is culled with it
+		TaskHandle cameraTask = taskGraph.AddTask(
+			"EditorCamera",
+			[this]() {
+				if (m_SceneState == SceneState::Edit)
+				{
+					s_ActiveCamera = &m_EditorCamera;
+				}
+				else
+				{
+					s_ActiveCamera = s_CameraComp.Ptr();
+				}
+
+				m_EditorCamera.Tick(Application::Get().GetDeltaSeconds());
+			},
+			{}, TaskAffinity::MainThread);
+		taskGraph.AddDependency(frameTasks.LayerUpdate, cameraTask);
+	}
+
 	void EditorLayer::OnRenderGui()
 	{
 		static bool dockSpaceOpen = true;
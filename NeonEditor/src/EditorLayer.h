@@ -21,9 +21,11 @@ namespace Neon
 		void OnAttach() override;
 		void OnDetach() override;
 
+		void Update(float deltaSeconds) override;
 		void Tick(float deltaSeconds) override;
 		void OnRenderGui() override;
 		void OnEvent(Event& e) override;
+		void OnFrameTasks(TaskGraph& taskGraph, const FrameTasks& frameTasks) override;
 
 	private:
 		SharedRef<Scene> m_EditorScene;
@@ -5,7 +5,8 @@
 class NeonEditorApp : public Neon::Application
 {
 public:
-	NeonEditorApp()
+	NeonEditorApp(const Neon::ApplicationProps& props)
+		: Neon::Application(props)
 	{
 		PushLayer(new Neon::EditorLayer());
 	}
@@ -13,7 +14,9 @@ public:
 	~NeonEditorApp() = default;
 };
 
-Neon::Application* Neon::CreateApplication()
+Neon::Application* Neon::CreateApplication(ApplicationCommandLineArgs args)
 {
-	return new NeonEditorApp();
+	ApplicationProps props;
+	props.ParseCommandLine(args);
+	return new NeonEditorApp(props);
 }
@@ -1,3 +1,9 @@
+newoption
+{
+	trigger = "track-allocations",
+	description = "Count global heap allocations per frame, for profiling and benchmark builds"
+}
+
 workspace "Neon"
 	architecture "x64"
 	targetdir "build"
@@ -27,6 +33,7 @@ IncludeDir["SPIRV_Cross"] = "Neon/vendor/SPIRV-Cross"
 IncludeDir["Vulkan"] = "Neon/vendor/Vulkan/1.2.148.1/include"
 IncludeDir["PhysX"] = "Neon/vendor/PhysX/include"
 IncludeDir["PhysX_internal"] = "Neon/vendor/PhysX/include/PhysX"
+IncludeDir["VMA"] = "Neon/vendor/allocator/include"
 
 LibraryDir = {}
 
@@ -119,7 +126,8 @@ project "Neon"
 		"%{prj.name}/vendor/stb/include",
 		"%{prj.name}/vendor/softfloat/include",
 		"%{IncludeDir.PhysX}",
-		"%{IncludeDir.PhysX_internal}"
+		"%{IncludeDir.PhysX_internal}",
+		"%{IncludeDir.VMA}"
 	}
 	
 	links 
@@ -136,6 +144,9 @@ project "Neon"
 		"PX_PHYSX_STATIC_LIB"
 	}
 
+	filter "options:track-allocations"
+		defines "NEO_TRACK_HEAP_ALLOCATIONS=1"
+
 	filter "system:windows"
 		systemversion "latest"
 		
@@ -234,6 +245,85 @@ project "NeonEditor"
 		"%{IncludeDir.shaderc}"
 	}
 	
+	filter "system:windows"
+		systemversion "latest"
+				
+		defines 
+		{ 
+			"NEO_PLATFORM_WINDOWS"
+		}
+	
+	filter "configurations:Debug"
+		defines "NEO_DEBUG"
+		symbols "on"
+
+		links
+		{
+			"Neon/vendor/assimp/lib/Debug/assimp-vc141-mtd.lib"
+		}
+
+		postbuildcommands 
+		{
+			'{COPY} "../Neon/vendor/assimp/lib/Debug/assimp-vc141-mtd.dll" "%{cfg.targetdir}"',
+			'{COPY} "../Neon/vendor/PhysX/lib/Debug/PhysX_64.dll" "%{cfg.targetdir}"',
+			'{COPY} "../Neon/vendor/PhysX/lib/Debug/PhysXFoundation_64.dll" "%{cfg.targetdir}"',
+			'{COPY} "../Neon/vendor/PhysX/lib/Debug/PhysXCooking_64.dll" "%{cfg.targetdir}"',
+			'{COPY} "../Neon/vendor/PhysX/lib/Debug/PhysXCommon_64.dll" "%{cfg.targetdir}"'
+		}
+				
+	filter "configurations:Release"
+		defines "NEO_RELEASE"
+		optimize "on"
+
+		links
+		{
+			"Neon/vendor/assimp/lib/Release/assimp-vc141-mt.lib"
+		}
+
+		postbuildcommands 
+		{
+			'{COPY} "../Neon/vendor/assimp/lib/Release/assimp-vc141-mt.dll" "%{cfg.targetdir}"',
+			'{COPY} "../Neon/vendor/PhysX/lib/Release/PhysX_64.dll" "%{cfg.targetdir}"',
+			'{COPY} "../Neon/vendor/PhysX/lib/Release/PhysXFoundation_64.dll" "%{cfg.targetdir}"',
+			'{COPY} "../Neon/vendor/PhysX/lib/Release/PhysXCooking_64.dll" "%{cfg.targetdir}"',
+			'{COPY} "../Neon/vendor/PhysX/lib/Release/PhysXCommon_64.dll" "%{cfg.targetdir}"'
+		}
+
+project "NeonBench"
+	location "NeonBench"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+	
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	-- Scenes load the editor assets
+	debugdir "NeonEditor"
+
+	links 
+	{ 
+		"Neon"
+	}
+	
+	files 
+	{
+		"%{prj.name}/src/**.h", 
+		"%{prj.name}/src/**.c", 
+		"%{prj.name}/src/**.hpp", 
+		"%{prj.name}/src/**.cpp" 
+	}
+	
+	includedirs 
+	{
+		"%{prj.name}/src",
+		"Neon/src",
+		"Neon/vendor",
+		"%{IncludeDir.glm}",
+		"%{IncludeDir.shaderc}"
+	}
+	
 	filter "system:windows"
 		systemversion "latest"
 				
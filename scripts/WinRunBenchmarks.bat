@@ -0,0 +1,22 @@
+@echo off
+rem Runs every benchmark scene and writes results to benchmarks\<scene>.json
+pushd %~dp0\..\NeonEditor\
+set BENCH=..\bin\Release-windows-x86_64\NeonBench\NeonBench.exe
+if not exist benchmarks mkdir benchmarks
+
+%BENCH% --scene jobs --output benchmarks\jobs.json
+%BENCH% --scene hdr --output benchmarks\hdr.json
+%BENCH% --scene refs --output benchmarks\refs.json
+%BENCH% --scene static --output benchmarks\static.json
+%BENCH% --scene static --count 10000 --output benchmarks\static_10000.json
+%BENCH% --scene static --count 10000 --no-instancing --output benchmarks\static_10000_noinstancing.json
+%BENCH% --scene static --count 10000 --culling cpu --output benchmarks\static_10000_cpuculling.json
+%BENCH% --scene static --count 10000 --culling none --output benchmarks\static_10000_noculling.json
+%BENCH% --scene static --count 10000 --no-instancing --serial-recording --output benchmarks\static_10000_noinstancing_serial.json
+%BENCH% --scene cars --output benchmarks\cars.json
+%BENCH% --scene ocean --output benchmarks\ocean.json
+
+for %%t in (1 2 4 8) do (
+	%BENCH% --scene physics --physics-threads %%t --output benchmarks\physics_%%t.json
+)
+popd